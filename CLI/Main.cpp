@@ -0,0 +1,196 @@
+#include <JuceHeader.h>
+
+#include <iostream>
+
+#include "AudioUtils.h"
+#include "BasicPitch.h"
+#include "MidiFileWriter.h"
+#include "PosteriorgramIO.h"
+
+/*
+ * Command line transcription.
+ *
+ * Usage:
+ *  NeuralNoteCLI transcribe <audio_file> [--midi out.mid] [--export-posteriorgrams dir] [options]
+ *      Run the model on an audio file, write the MIDI file and/or the posteriorgrams (.npy).
+ *  NeuralNoteCLI notes <posteriorgram_dir> --midi out.mid [options]
+ *      Create notes from posteriorgrams exported before (or computed in Python), without running the model.
+ *
+ * Options: --note-sensitivity (0.7), --split-sensitivity (0.5), --min-note-duration-ms (125), --pitch-bend (none or
+ * single), --bpm (120, tempo of the MIDI file).
+ */
+
+namespace
+{
+struct Options {
+    File input;
+    File midiFile;
+    File posteriorgramDirectory;
+    float noteSensitivity = 0.7f;
+    float splitSensitivity = 0.5f;
+    float minNoteDurationMs = 125.0f;
+    PitchBendModes pitchBendMode = NoPitchBend;
+    double bpm = 120.0;
+};
+
+void printUsage()
+{
+    std::cerr << "Usage: NeuralNoteCLI transcribe <audio_file> [--midi out.mid] [--export-posteriorgrams dir] [options]"
+              << std::endl
+              << "       NeuralNoteCLI notes <posteriorgram_dir> --midi out.mid [options]" << std::endl
+              << "Options: --note-sensitivity x --split-sensitivity x --min-note-duration-ms x "
+                 "--pitch-bend none|single --bpm x"
+              << std::endl;
+}
+
+bool parseOptions(const StringArray& inArgs, Options& outOptions)
+{
+    auto cwd = File::getCurrentWorkingDirectory();
+    outOptions.input = cwd.getChildFile(inArgs[1]);
+
+    for (int i = 2; i + 1 < inArgs.size(); i += 2) {
+        const auto& name = inArgs[i];
+        const auto& value = inArgs[i + 1];
+
+        if (name == "--midi")
+            outOptions.midiFile = cwd.getChildFile(value);
+        else if (name == "--export-posteriorgrams")
+            outOptions.posteriorgramDirectory = cwd.getChildFile(value);
+        else if (name == "--note-sensitivity")
+            outOptions.noteSensitivity = jlimit(0.05f, 0.95f, value.getFloatValue());
+        else if (name == "--split-sensitivity")
+            outOptions.splitSensitivity = jlimit(0.05f, 0.95f, value.getFloatValue());
+        else if (name == "--min-note-duration-ms")
+            outOptions.minNoteDurationMs = value.getFloatValue();
+        else if (name == "--pitch-bend" && (value == "none" || value == "single"))
+            outOptions.pitchBendMode = value == "single" ? SinglePitchBend : NoPitchBend;
+        else if (name == "--bpm" && value.getDoubleValue() > 0.0)
+            outOptions.bpm = value.getDoubleValue();
+        else {
+            std::cerr << "Invalid argument: " << name << " " << value << std::endl;
+            return false;
+        }
+    }
+
+    if (inArgs.size() % 2 != 0) {
+        std::cerr << "Missing value for " << inArgs[inArgs.size() - 1] << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool writeMidi(std::vector<Notes::Event> inNoteEvents, const Options& inOptions)
+{
+    if (inOptions.pitchBendMode == SinglePitchBend) {
+        Notes::dropOverlappingPitchBends(inNoteEvents);
+    }
+
+    Notes::mergeOverlappingNotesWithSamePitch(inNoteEvents);
+
+    TimeQuantizeOptions::TimeQuantizeInfo info;
+    info.bpm = inOptions.bpm;
+
+    if (!MidiFileWriter().writeMidiFile(
+            inNoteEvents, inOptions.midiFile, info, inOptions.bpm, inOptions.pitchBendMode)) {
+        std::cerr << "Could not write " << inOptions.midiFile.getFullPathName() << std::endl;
+        return false;
+    }
+
+    std::cout << inNoteEvents.size() << " notes written to " << inOptions.midiFile.getFullPathName() << std::endl;
+
+    return true;
+}
+
+int transcribe(const Options& inOptions)
+{
+    AudioBuffer<float> source_audio;
+    double sample_rate;
+
+    if (!AudioUtils::loadAudioFile(inOptions.input, source_audio, sample_rate)) {
+        std::cerr << "Could not load " << inOptions.input.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    AudioBuffer<float> downsampled_audio;
+    AudioBuffer<float> mono_audio;
+    AudioUtils::resampleBuffer(source_audio, downsampled_audio, sample_rate, BASIC_PITCH_SAMPLE_RATE);
+    AudioUtils::downmixToMono(downsampled_audio, mono_audio);
+
+    BasicPitch basic_pitch;
+
+    if (!basic_pitch.isInitialized()) {
+        std::cerr << "Model initialization failed: " << basic_pitch.getErrorMessage() << std::endl;
+        return 1;
+    }
+
+    basic_pitch.setParameters(inOptions.noteSensitivity, inOptions.splitSensitivity, inOptions.minNoteDurationMs);
+    basic_pitch.transcribeToMIDI(mono_audio.getWritePointer(0), mono_audio.getNumSamples());
+
+    if (inOptions.posteriorgramDirectory != File()) {
+        std::string error;
+
+        if (!inOptions.posteriorgramDirectory.createDirectory()
+            || !PosteriorgramIO::save(basic_pitch.getPosteriorgrams(),
+                                      inOptions.posteriorgramDirectory.getFullPathName().toStdString(),
+                                      error)) {
+            std::cerr << "Could not export the posteriorgrams: " << error << std::endl;
+            return 1;
+        }
+
+        std::cout << "Posteriorgrams written to " << inOptions.posteriorgramDirectory.getFullPathName() << std::endl;
+    }
+
+    if (inOptions.midiFile != File() && !writeMidi(basic_pitch.getNoteEvents(), inOptions)) {
+        return 1;
+    }
+
+    return 0;
+}
+
+int createNotes(const Options& inOptions)
+{
+    if (inOptions.midiFile == File()) {
+        std::cerr << "--midi is required" << std::endl;
+        return 1;
+    }
+
+    BasicPitch::Posteriorgrams posteriorgrams;
+    std::string error;
+
+    if (!PosteriorgramIO::load(inOptions.input.getFullPathName().toStdString(), posteriorgrams, error)) {
+        std::cerr << "Could not import the posteriorgrams: " << error << std::endl;
+        return 1;
+    }
+
+    // Only the note creation step of BasicPitch: neither Features nor the CNN are loaded
+    Notes notes_creator;
+    auto params = BasicPitch::createConvertParams(
+        inOptions.noteSensitivity, inOptions.splitSensitivity, inOptions.minNoteDurationMs);
+    auto note_events =
+        notes_creator.convert(posteriorgrams.notes, posteriorgrams.onsets, posteriorgrams.contours, params, true);
+
+    return writeMidi(std::move(note_events), inOptions) ? 0 : 1;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    ScopedJuceInitialiser_GUI juce_initialiser;
+
+    StringArray args;
+    for (int i = 1; i < argc; i++)
+        args.add(argv[i]);
+
+    Options options;
+
+    if (args.size() < 2 || !(args[0] == "transcribe" || args[0] == "notes")) {
+        printUsage();
+        return 1;
+    }
+
+    if (!parseOptions(args, options))
+        return 1;
+
+    return args[0] == "transcribe" ? transcribe(options) : createNotes(options);
+}
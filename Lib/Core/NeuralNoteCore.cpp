@@ -0,0 +1,201 @@
+#include "NeuralNoteCore.h"
+
+#include <exception>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BasicPitch.h"
+
+struct nn_engine {
+    BasicPitch basicPitch;
+    std::vector<float> audio;
+    std::vector<nn_note> notes;
+    std::string error;
+};
+
+namespace
+{
+void setParameters(nn_engine* ioEngine, const nn_params* inParams)
+{
+    const auto params = inParams != nullptr ? *inParams : nn_default_params();
+    ioEngine->basicPitch.setParameters(params.note_sensitivity, params.split_sensitivity, params.min_note_duration_ms);
+}
+
+void updateNotes(nn_engine* ioEngine)
+{
+    const auto& events = ioEngine->basicPitch.getNoteEvents();
+
+    ioEngine->notes.clear();
+    ioEngine->notes.reserve(events.size());
+
+    for (const auto& event: events) {
+        ioEngine->notes.push_back({event.startTime, event.endTime, event.pitch, event.amplitude});
+    }
+}
+
+std::vector<std::vector<float>> toRows(const float* inMatrix, size_t inNumFrames, size_t inNumBins)
+{
+    std::vector<std::vector<float>> rows(inNumFrames);
+
+    for (size_t i = 0; i < inNumFrames; i++) {
+        rows[i].assign(inMatrix + i * inNumBins, inMatrix + (i + 1) * inNumBins);
+    }
+
+    return rows;
+}
+
+/**
+ * Run the body of an API function, so that no exception crosses the C boundary: on exception the reason is stored as
+ * the engine error and a failure is returned.
+ */
+template <typename Function>
+int runGuarded(nn_engine* ioEngine, Function&& inFunction) noexcept
+{
+    try {
+        return inFunction();
+    } catch (const std::exception& e) {
+        ioEngine->notes.clear();
+        ioEngine->error = e.what();
+    } catch (...) {
+        ioEngine->notes.clear();
+        ioEngine->error = "Unknown error";
+    }
+
+    return 1;
+}
+} // namespace
+
+nn_params nn_default_params(void)
+{
+    return {0.7f, 0.5f, 125.0f};
+}
+
+nn_engine* nn_engine_create(void)
+{
+    try {
+        auto engine = std::make_unique<nn_engine>();
+
+        if (!engine->basicPitch.isInitialized()) {
+            return nullptr;
+        }
+
+        return engine.release();
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void nn_engine_destroy(nn_engine* engine)
+{
+    delete engine;
+}
+
+const char* nn_engine_get_error(const nn_engine* engine)
+{
+    return engine != nullptr ? engine->error.c_str() : "";
+}
+
+int nn_engine_transcribe(nn_engine* engine, const float* audio, size_t num_samples, const nn_params* params)
+{
+    if (engine == nullptr || audio == nullptr) {
+        return 1;
+    }
+
+    engine->error.clear();
+
+    if (num_samples < static_cast<size_t>(NN_SAMPLE_RATE)) {
+        engine->error = "At least one second of audio is needed";
+        return 1;
+    }
+
+    // BasicPitch counts samples with an int
+    if (num_samples > static_cast<size_t>(std::numeric_limits<int>::max())) {
+        engine->error = "Too much audio: transcribe it in several parts";
+        return 1;
+    }
+
+    return runGuarded(engine, [&] {
+        // BasicPitch takes a mutable buffer
+        engine->audio.assign(audio, audio + num_samples);
+
+        setParameters(engine, params);
+        engine->basicPitch.reset();
+        engine->basicPitch.transcribeToMIDI(engine->audio.data(), static_cast<int>(num_samples));
+
+        engine->audio.clear();
+        engine->audio.shrink_to_fit();
+
+        if (engine->basicPitch.getNumPosteriorgramFrames() == 0) {
+            engine->error = engine->basicPitch.getErrorMessage().empty() ? "Transcription failed"
+                                                                          : engine->basicPitch.getErrorMessage();
+            engine->notes.clear();
+            return 1;
+        }
+
+        updateNotes(engine);
+
+        return 0;
+    });
+}
+
+int nn_engine_set_posteriorgrams(nn_engine* engine,
+                                 const float* contours,
+                                 const float* notes,
+                                 const float* onsets,
+                                 size_t num_frames,
+                                 const nn_params* params)
+{
+    if (engine == nullptr || contours == nullptr || notes == nullptr || onsets == nullptr) {
+        return 1;
+    }
+
+    engine->error.clear();
+
+    return runGuarded(engine, [&] {
+        BasicPitch::Posteriorgrams posteriorgrams;
+        posteriorgrams.contours = toRows(contours, num_frames, NN_NUM_CONTOUR_BINS);
+        posteriorgrams.notes = toRows(notes, num_frames, NN_NUM_NOTE_BINS);
+        posteriorgrams.onsets = toRows(onsets, num_frames, NN_NUM_NOTE_BINS);
+
+        setParameters(engine, params);
+        engine->basicPitch.setPosteriorgrams(std::move(posteriorgrams));
+        updateNotes(engine);
+
+        return 0;
+    });
+}
+
+int nn_engine_convert(nn_engine* engine, const nn_params* params)
+{
+    if (engine == nullptr) {
+        return 1;
+    }
+
+    engine->error.clear();
+
+    if (engine->basicPitch.getNumPosteriorgramFrames() == 0) {
+        engine->error = "Nothing to convert: transcribe audio or set posteriorgrams first";
+        return 1;
+    }
+
+    return runGuarded(engine, [&] {
+        setParameters(engine, params);
+        engine->basicPitch.updateMIDI();
+        updateNotes(engine);
+
+        return 0;
+    });
+}
+
+size_t nn_engine_get_notes(const nn_engine* engine, const nn_note** notes)
+{
+    if (engine == nullptr || notes == nullptr) {
+        return 0;
+    }
+
+    *notes = engine->notes.data();
+
+    return engine->notes.size();
+}
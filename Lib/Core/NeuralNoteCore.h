@@ -0,0 +1,84 @@
+#ifndef NeuralNoteCore_h
+#define NeuralNoteCore_h
+
+#include <stddef.h>
+
+/*
+ * C API of the neuralnote_core library: audio to note transcription without JUCE or the plugin.
+ *
+ * An engine holds the models, the posteriorgrams of the last transcription and the note events created from them.
+ * Engines are independent: use one per thread. Functions returning int return 0 on success and a non zero value on
+ * failure, with the reason available from nn_engine_get_error. No function lets an exception through.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct nn_engine nn_engine;
+
+typedef struct nn_params {
+    /* Note sensitivity (0.05, 0.95). Higher gives more notes. */
+    float note_sensitivity;
+    /* Split sensitivity (0.05, 0.95). Higher splits notes more, lower merges close notes with the same pitch. */
+    float split_sensitivity;
+    /* Minimum note duration in ms. */
+    float min_note_duration_ms;
+} nn_params;
+
+typedef struct nn_note {
+    double start_time; /* Seconds */
+    double end_time; /* Seconds */
+    int pitch; /* MIDI note number */
+    double amplitude; /* (0, 1) */
+} nn_note;
+
+/* Sample rate of the audio given to nn_engine_transcribe. */
+#define NN_SAMPLE_RATE 22050
+/* Number of values per frame of the contours posteriorgram. */
+#define NN_NUM_CONTOUR_BINS 264
+/* Number of values per frame of the notes and onsets posteriorgrams (one per piano key). */
+#define NN_NUM_NOTE_BINS 88
+
+/* Default parameters of the plugin. */
+nn_params nn_default_params(void);
+
+/* Create an engine and load the models. Returns NULL if the models could not be loaded. */
+nn_engine* nn_engine_create(void);
+
+void nn_engine_destroy(nn_engine* engine);
+
+/* Reason of the last failure, empty string if none. Valid until the next call on the engine. */
+const char* nn_engine_get_error(const nn_engine* engine);
+
+/*
+ * Transcribe mono audio at NN_SAMPLE_RATE Hz (run the models and create the notes), from one second to INT_MAX
+ * samples. params can be NULL for the default parameters.
+ */
+int nn_engine_transcribe(nn_engine* engine, const float* audio, size_t num_samples, const nn_params* params);
+
+/*
+ * Use posteriorgrams computed elsewhere (e.g. exported before) and create the notes, without running the models.
+ * Matrices are row major: num_frames rows of NN_NUM_CONTOUR_BINS or NN_NUM_NOTE_BINS values.
+ */
+int nn_engine_set_posteriorgrams(nn_engine* engine,
+                                 const float* contours,
+                                 const float* notes,
+                                 const float* onsets,
+                                 size_t num_frames,
+                                 const nn_params* params);
+
+/* Create the notes again from the current posteriorgrams with other parameters. Fast: the models are not run. */
+int nn_engine_convert(nn_engine* engine, const nn_params* params);
+
+/*
+ * Note events of the last transcription or conversion.
+ * The array is owned by the engine and valid until the next call modifying the notes.
+ */
+size_t nn_engine_get_notes(const nn_engine* engine, const nn_note** notes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NeuralNoteCore_h
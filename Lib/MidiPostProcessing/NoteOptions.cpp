@@ -4,6 +4,8 @@
 
 #include "NoteOptions.h"
 
+#include <numeric>
+
 void NoteOptions::setParameters(bool inEnable,
                                 RootNote inRootNote,
                                 ScaleType inScaleType,
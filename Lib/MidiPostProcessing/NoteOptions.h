@@ -5,9 +5,11 @@
 #ifndef NoteOptions_h
 #define NoteOptions_h
 
-#include <JuceHeader.h>
+#include <array>
+#include <vector>
+
 #include "Notes.h"
-#include "NoteUtils.h"
+#include "NoteUtilsCore.h"
 
 using namespace NoteUtils;
 
@@ -0,0 +1,77 @@
+#include "TimeQuantizer.h"
+
+void TimeQuantizer::setParameters(bool inEnable,
+                                  TimeQuantizeUtils::TimeDivisions inDivision,
+                                  float inQuantizationForce)
+{
+    mEnable = inEnable;
+    mDivision = inDivision;
+    mQuantizationForce = inQuantizationForce;
+}
+
+void TimeQuantizer::setInfo(const TimeQuantizeUtils::TimeQuantizeInfo& inInfo)
+{
+    mInfo = inInfo;
+}
+
+std::vector<Notes::Event> TimeQuantizer::process(const std::vector<Notes::Event>& inNoteEvents) const
+{
+    if (!mEnable) {
+        return inNoteEvents;
+    }
+
+    std::vector<Notes::Event> out_events;
+    out_events.reserve(inNoteEvents.size());
+
+    const double bpm = mInfo.bpm;
+    // Offset from previous bar start
+    const double start_pos_qn = mInfo.getStartQn() - mInfo.getStartLastBarQn();
+
+    const double time_division = TimeQuantizeUtils::TimeDivisionsDouble.at(static_cast<size_t>(mDivision));
+
+    for (const auto& event: inNoteEvents) {
+        double duration = event.endTime - event.startTime;
+        assert(duration > 0);
+        double new_start_time = quantizeTime(event.startTime, bpm, time_division, start_pos_qn, mQuantizationForce);
+        double new_end_time = new_start_time + duration;
+
+        Notes::Event quantized_event = event;
+        quantized_event.startTime = new_start_time;
+        quantized_event.endTime = new_end_time;
+        out_events.push_back(quantized_event);
+    }
+
+    return out_events;
+}
+
+double TimeQuantizer::quantizeTime(
+    double inEventTime, double inBPM, double inTimeDivision, double inStartTimeQN, float inQuantizationForce)
+{
+    assert(inEventTime >= 0.0);
+    const double seconds_per_qn = 60.0 / inBPM;
+
+    const double division_duration = inTimeDivision * 4.0 * seconds_per_qn;
+
+    // Set previous bar start of recording start as new time origin.
+    double new_time_origin = inStartTimeQN * seconds_per_qn;
+    double shifted_time = inEventTime + new_time_origin;
+
+    double time_since_previous_division = std::fmod(shifted_time, division_duration);
+
+    // Get the time of the first division tick before the note start
+    double previous_division_time = shifted_time - time_since_previous_division;
+
+    double target_time = time_since_previous_division < division_duration / 2.0
+                             ? previous_division_time
+                             : previous_division_time + division_duration;
+
+    assert(shifted_time >= previous_division_time && shifted_time < previous_division_time + division_duration);
+
+    double quantized_shifted_time =
+        shifted_time + static_cast<double>(inQuantizationForce) * (target_time - shifted_time);
+
+    // Re-shift
+    double quantized_time = quantized_shifted_time - new_time_origin;
+
+    return quantized_time;
+}
@@ -0,0 +1,41 @@
+#ifndef TimeQuantizer_h
+#define TimeQuantizer_h
+
+#include <vector>
+
+#include "Notes.h"
+#include "TimeQuantizeUtilsCore.h"
+
+/**
+ * Move note starts towards the closest time division of the grid defined by the tempo, time signature and recording
+ * start position. Note durations are kept.
+ */
+class TimeQuantizer
+{
+public:
+    void setParameters(bool inEnable, TimeQuantizeUtils::TimeDivisions inDivision, float inQuantizationForce);
+
+    void setInfo(const TimeQuantizeUtils::TimeQuantizeInfo& inInfo);
+
+    std::vector<Notes::Event> process(const std::vector<Notes::Event>& inNoteEvents) const;
+
+    /**
+     * Quantize a time.
+     * @param inEventTime Time in seconds from the recording start
+     * @param inBPM Tempo
+     * @param inTimeDivision Division duration in whole notes
+     * @param inStartTimeQN Position of the recording start from the previous bar start in quarter notes
+     * @param inQuantizationForce 0 to keep the time, 1 to move it to the closest division
+     * @return Quantized time in seconds from the recording start
+     */
+    static double quantizeTime(
+        double inEventTime, double inBPM, double inTimeDivision, double inStartTimeQN, float inQuantizationForce);
+
+private:
+    bool mEnable = false;
+    TimeQuantizeUtils::TimeDivisions mDivision = TimeQuantizeUtils::_1_4;
+    float mQuantizationForce = 0.f;
+    TimeQuantizeUtils::TimeQuantizeInfo mInfo;
+};
+
+#endif // TimeQuantizer_h
@@ -3,6 +3,13 @@
 //
 
 #include "BasicPitch.h"
+#include "ResourceStats.h"
+
+#include <thread>
+
+#if SAVE_DOWNSAMPLED_AUDIO
+#include <JuceHeader.h>
+#endif
 
 void BasicPitch::reset()
 {
@@ -21,20 +28,47 @@ void BasicPitch::reset()
     mNumFrames = 0;
 }
 
-void BasicPitch::setParameters(float inNoteSensitivity, float inSplitSensitivity, float inMinNoteDurationMs)
+void BasicPitch::setParameters(float inNoteSensitivity,
+                               float inSplitSensitivity,
+                               float inMinNoteDurationMs,
+                               bool inComputePitchBends)
+{
+    mParams = createConvertParams(inNoteSensitivity, inSplitSensitivity, inMinNoteDurationMs, inComputePitchBends);
+    mParams.minFrequency = mMinFrequency;
+    mParams.maxFrequency = mMaxFrequency;
+}
+
+void BasicPitch::setMidiNoteRange(int inMinMidiNote, int inMaxMidiNote)
 {
-    mParams.frameThreshold = 1.0f - inNoteSensitivity;
-    mParams.onsetThreshold = 1.0f - inSplitSensitivity;
+    mMinFrequency = inMinMidiNote <= MIDI_OFFSET ? -1.0f : NoteUtils::midiToHz(static_cast<float>(inMinMidiNote));
+    mMaxFrequency =
+        inMaxMidiNote >= MIDI_OFFSET + MAX_NOTE_IDX ? -1.0f : NoteUtils::midiToHz(static_cast<float>(inMaxMidiNote));
 
-    mParams.minNoteLength =
+    mParams.minFrequency = mMinFrequency;
+    mParams.maxFrequency = mMaxFrequency;
+}
+
+Notes::ConvertParams BasicPitch::createConvertParams(float inNoteSensitivity,
+                                                     float inSplitSensitivity,
+                                                     float inMinNoteDurationMs,
+                                                     bool inComputePitchBends)
+{
+    Notes::ConvertParams params;
+
+    params.frameThreshold = 1.0f - inNoteSensitivity;
+    params.onsetThreshold = 1.0f - inSplitSensitivity;
+
+    params.minNoteLength =
         static_cast<int>(std::round(inMinNoteDurationMs / 1000.0f / (FFT_HOP / BASIC_PITCH_SAMPLE_RATE)));
 
-    mParams.pitchBend = MultiPitchBend;
-    mParams.melodiaTrick = true;
-    mParams.inferOnsets = true;
+    params.pitchBend = inComputePitchBends ? MultiPitchBend : NoPitchBend;
+    params.melodiaTrick = true;
+    params.inferOnsets = true;
+
+    return params;
 }
 
-void BasicPitch::transcribeToMIDI(float* inAudio, int inNumSamples)
+bool BasicPitch::transcribeToMIDI(float* inAudio, int inNumSamples, const std::atomic<bool>* inShouldStop)
 {
     // To test if downsampling works as expected
 #if SAVE_DOWNSAMPLED_AUDIO
@@ -62,17 +96,15 @@ void BasicPitch::transcribeToMIDI(float* inAudio, int inNumSamples)
     if (stacked_cqt == nullptr || mNumFrames == 0) {
         // Feature extraction failed (likely due to model initialization failure)
         mNoteEvents.clear();
-        return;
+        return true;
     }
 
     const size_t num_lh_frames = BasicPitchCNN::getNumFramesLookahead();
 
     // Validate that we have enough frames for the lookahead processing
     if (mNumFrames < num_lh_frames) {
-        DBG("WARNING: Insufficient frames for CNN processing. Need at least "
-            + String(num_lh_frames) + " frames, got " + String(mNumFrames));
         mNoteEvents.clear();
-        return;
+        return true;
     }
 
     mOnsetsPG.resize(mNumFrames, std::vector<float>(static_cast<size_t>(NUM_FREQ_OUT), 0.0f));
@@ -85,6 +117,14 @@ void BasicPitch::transcribeToMIDI(float* inAudio, int inNumSamples)
 
     mBasicPitchCNN.reset();
 
+    // Prepare the note creation on another thread, as the CNN settles the frames
+    NotesPreparation notes_preparation;
+    std::thread notes_thread;
+
+    if (mUsePipeline) {
+        notes_thread = std::thread([this, &notes_preparation] { _prepareNotes(notes_preparation); });
+    }
+
     std::vector<float> zero_stacked_cqt(NUM_HARMONICS * NUM_FREQ_IN, 0.0f);
 
     // Run the CNN with 0 input and discard output (only for num_lh_frames)
@@ -98,26 +138,81 @@ void BasicPitch::transcribeToMIDI(float* inAudio, int inNumSamples)
             stacked_cqt + frame_idx * NUM_HARMONICS * NUM_FREQ_IN, mContoursPG[0], mNotesPG[0], mOnsetsPG[0]);
     }
 
+    bool is_stopped = false;
+
     // Run the CNN with real inputs and correct outputs
     // Safe because we validated mNumFrames >= num_lh_frames above
     for (size_t frame_idx = num_lh_frames; frame_idx < mNumFrames; frame_idx++) {
+        if (inShouldStop != nullptr && inShouldStop->load(std::memory_order_relaxed)) {
+            is_stopped = true;
+            break;
+        }
+
         size_t output_idx = frame_idx - num_lh_frames;
-        jassert(output_idx < mContoursPG.size() && output_idx < mNotesPG.size() && output_idx < mOnsetsPG.size());
+        assert(output_idx < mContoursPG.size() && output_idx < mNotesPG.size() && output_idx < mOnsetsPG.size());
         mBasicPitchCNN.frameInference(stacked_cqt + frame_idx * NUM_HARMONICS * NUM_FREQ_IN,
                                       mContoursPG[output_idx],
                                       mNotesPG[output_idx],
                                       mOnsetsPG[output_idx]);
+
+        if (mUsePipeline && (output_idx + 1) % NOTES_PREPARATION_BLOCK_SIZE == 0) {
+            notes_preparation.setNumFramesReady(output_idx + 1);
+        }
     }
 
     // Run end with zeroes as input and last frames as output
-    for (size_t frame_idx = mNumFrames; frame_idx < mNumFrames + num_lh_frames; frame_idx++) {
+    for (size_t frame_idx = mNumFrames; frame_idx < mNumFrames + num_lh_frames && !is_stopped; frame_idx++) {
         mBasicPitchCNN.frameInference(zero_stacked_cqt.data(),
                                       mContoursPG[frame_idx - num_lh_frames],
                                       mNotesPG[frame_idx - num_lh_frames],
                                       mOnsetsPG[frame_idx - num_lh_frames]);
     }
 
-    mNoteEvents = mNotesCreator.convert(mNotesPG, mOnsetsPG, mContoursPG, mParams, true);
+    // When stopped, the remaining frames are zeros: quickly prepared
+    if (mUsePipeline) {
+        notes_preparation.setNumFramesReady(mNumFrames);
+        notes_thread.join();
+    }
+
+    if (is_stopped) {
+        reset();
+        return false;
+    }
+
+    mNoteEvents = mNotesCreator.convert(mNotesPG, mOnsetsPG, mContoursPG, mParams, !mUsePipeline);
+
+    return true;
+}
+
+void BasicPitch::NotesPreparation::setNumFramesReady(size_t inNumFrames)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        numFramesReady = inNumFrames;
+    }
+
+    condition.notify_one();
+}
+
+size_t BasicPitch::NotesPreparation::waitForFrames(size_t inNumFramesPrepared)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [this, inNumFramesPrepared] { return numFramesReady > inNumFramesPrepared; });
+
+    return numFramesReady;
+}
+
+void BasicPitch::_prepareNotes(NotesPreparation& ioPreparation)
+{
+    mNotesCreator.prepareNewAudio(mNumFrames);
+
+    size_t num_frames_prepared = 0;
+
+    while (num_frames_prepared < mNumFrames) {
+        const auto num_frames_ready = ioPreparation.waitForFrames(num_frames_prepared);
+        mNotesCreator.prepareFrames(mNotesPG, mOnsetsPG, num_frames_prepared, num_frames_ready);
+        num_frames_prepared = num_frames_ready;
+    }
 }
 
 void BasicPitch::updateMIDI()
@@ -125,7 +220,73 @@ void BasicPitch::updateMIDI()
     mNoteEvents = mNotesCreator.convert(mNotesPG, mOnsetsPG, mContoursPG, mParams, false);
 }
 
+BasicPitch::Posteriorgrams BasicPitch::getPosteriorgrams() const
+{
+    return {mContoursPG, mNotesPG, mOnsetsPG};
+}
+
+void BasicPitch::setPosteriorgrams(Posteriorgrams inPosteriorgrams)
+{
+    assert(inPosteriorgrams.contours.size() == inPosteriorgrams.notes.size()
+            && inPosteriorgrams.onsets.size() == inPosteriorgrams.notes.size());
+
+    mContoursPG = std::move(inPosteriorgrams.contours);
+    mNotesPG = std::move(inPosteriorgrams.notes);
+    mOnsetsPG = std::move(inPosteriorgrams.onsets);
+    mNumFrames = mNotesPG.size();
+
+    if (mNumFrames == 0) {
+        mNoteEvents.clear();
+        return;
+    }
+
+    mNoteEvents = mNotesCreator.convert(mNotesPG, mOnsetsPG, mContoursPG, mParams, true);
+}
+
+void BasicPitch::warmUp(const std::atomic<bool>& inShouldStop)
+{
+    if (!isInitialized() || inShouldStop) {
+        return;
+    }
+
+    // One second of silence is enough to go through every layer
+    std::vector<float> silence(static_cast<size_t>(AUDIO_SAMPLE_RATE), 0.0f);
+    size_t num_frames = 0;
+
+    const float* stacked_cqt = mFeaturesCalculator.computeFeatures(silence.data(), silence.size(), num_frames);
+
+    if (stacked_cqt != nullptr) {
+        std::vector<float> contours(NUM_FREQ_IN);
+        std::vector<float> notes(NUM_FREQ_OUT);
+        std::vector<float> onsets(NUM_FREQ_OUT);
+
+        for (size_t frame_idx = 0; frame_idx < num_frames && !inShouldStop.load(); frame_idx++) {
+            mBasicPitchCNN.frameInference(
+                stacked_cqt + frame_idx * NUM_HARMONICS * NUM_FREQ_IN, contours, notes, onsets);
+        }
+    }
+
+    mBasicPitchCNN.reset();
+}
+
 const std::vector<Notes::Event>& BasicPitch::getNoteEvents() const
 {
     return mNoteEvents;
 }
+
+size_t BasicPitch::getPosteriorgramsSizeInBytes() const
+{
+    return ResourceStats::getAllocatedBytes(mContoursPG) + ResourceStats::getAllocatedBytes(mNotesPG)
+           + ResourceStats::getAllocatedBytes(mOnsetsPG);
+}
+
+size_t BasicPitch::getNotesScratchSizeInBytes() const
+{
+    size_t num_bytes = ResourceStats::getAllocatedBytes(mNoteEvents) + mNotesCreator.getScratchSizeInBytes();
+
+    for (const auto& event: mNoteEvents) {
+        num_bytes += ResourceStats::getAllocatedBytes(event.bends);
+    }
+
+    return num_bytes;
+}
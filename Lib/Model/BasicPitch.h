@@ -5,6 +5,10 @@
 #ifndef BasicPitch_h
 #define BasicPitch_h
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
 #include "BasicPitchCNN.h"
 #include "BasicPitchConstants.h"
 #include "Features.h"
@@ -16,6 +20,17 @@
 class BasicPitch
 {
 public:
+    /**
+     * Outputs of the CNN for a whole audio signal. One vector per frame.
+     */
+    struct Posteriorgrams {
+        std::vector<std::vector<float>> contours;
+        std::vector<std::vector<float>> notes;
+        std::vector<std::vector<float>> onsets;
+
+        size_t getNumFrames() const { return notes.size(); }
+    };
+
     BasicPitch() = default;
 
     /**
@@ -40,15 +55,58 @@ public:
      * @param inNoteSensitivity Note sensitivity threshold (0.05, 0.95). Higher gives more notes.
      * @param inSplitSensitivity Split sensitivity threshold (0.05, 0.95). Higher will split note more, lower will merge close notes with same pitch
      * @param inMinNoteDurationMs Minimum note duration to keep in ms.
+     * @param inComputePitchBends False to leave the bends of the note events empty when nothing uses them, which saves
+     * the scan of the contours. Bends already computed for the same audio are cached, so turning it back on is cheap.
+     */
+    void setParameters(float inNoteSensitivity,
+                       float inSplitSensitivity,
+                       float inMinNoteDurationMs,
+                       bool inComputePitchBends = true);
+
+    /**
+     * Restrict the note events to a range of MIDI notes, for the next transcription or midi update. Notes::convert
+     * then only goes through the pitches of the range, including for the melodia trick and the pitch bends.
+     * Kept by setParameters. Notes just inside the range may differ from filtering the full range transcription, as
+     * notes outside of it no longer hide their neighbours (same as the frequency range of basic-pitch).
+     * @param inMinMidiNote Lowest MIDI note to transcribe, 21 or lower for no limit.
+     * @param inMaxMidiNote Highest MIDI note to transcribe, 108 or higher for no limit.
+     */
+    void setMidiNoteRange(int inMinMidiNote, int inMaxMidiNote);
+
+    /**
+     * Same parameter mapping as setParameters, for code converting posteriorgrams with its own Notes instance.
+     * @return Parameters to give to Notes::convert.
+     */
+    static Notes::ConvertParams createConvertParams(float inNoteSensitivity,
+                                                    float inSplitSensitivity,
+                                                    float inMinNoteDurationMs,
+                                                    bool inComputePitchBends = true);
+
+    /**
+     * Whether transcribeToMIDI prepares the note creation on a second thread while the CNN runs (default), or does
+     * everything on the calling thread. The note events are the same.
+     */
+    void setUsePipeline(bool inUsePipeline) { mUsePipeline = inUsePipeline; }
+
+    /**
+     * Whether the CNN runs its onset branch on a worker thread in parallel with the other branches (off by default).
+     * Lowers the latency of a single transcription, but should stay off when several instances already run in parallel.
+     */
+    void setParallelCNN(bool inParallelCNN) { mBasicPitchCNN.setParallelBranches(inParallelCNN); }
+
+    /**
+     * Number of threads used to create the note events from the posteriorgrams, see Notes::setNumThreads (default 1).
      */
-    void setParameters(float inNoteSensitivity, float inSplitSensitivity, float inMinNoteDurationMs);
+    void setNumNotesThreads(size_t inNumThreads) { mNotesCreator.setNumThreads(inNumThreads); }
 
     /**
      * Transcribe the input audio. The note event vector can be obtained after this with getNoteEvents
      * @param inAudio Pointer to raw audio (must be at 22050 Hz)
      * @param inNumSamples Number of input samples available.
+     * @param inShouldStop If given, checked between CNN frames: the transcription returns early when it is set.
+     * @return False if stopped, the posteriorgrams and note events are then empty.
      */
-    void transcribeToMIDI(float* inAudio, int inNumSamples);
+    bool transcribeToMIDI(float* inAudio, int inNumSamples, const std::atomic<bool>* inShouldStop = nullptr);
 
     /**
      * Function to call to update the midi transcription with new parameters.
@@ -56,12 +114,68 @@ public:
      */
     void updateMIDI();
 
+    /**
+     * @return Copy of the posteriorgrams computed by the last transcribeToMIDI call.
+     */
+    Posteriorgrams getPosteriorgrams() const;
+
+    /**
+     * @return Number of frames of the posteriorgrams. 0 before the first transcription or if it failed.
+     */
+    size_t getNumPosteriorgramFrames() const { return mNotesPG.size(); }
+
+    /**
+     * Use posteriorgrams computed previously (e.g. by another instance) instead of running Features and the CNN.
+     * Note events are recomputed with the current parameters, as after transcribeToMIDI.
+     * @param inPosteriorgrams Posteriorgrams to adopt.
+     */
+    void setPosteriorgrams(Posteriorgrams inPosteriorgrams);
+
+    /**
+     * Run a short dummy inference through Features and the CNN, so that the ORT session is fully initialized and the
+     * model weights are paged in before the first real transcription. The CNN is left in its reset state.
+     * @param inShouldStop Checked between CNN frames, the warm-up returns early when it is set.
+     */
+    void warmUp(const std::atomic<bool>& inShouldStop);
+
     /**
      * @return Note event vector.
      */
     const std::vector<Notes::Event>& getNoteEvents() const;
 
+    /**
+     * @return Bytes allocated by the posteriorgrams.
+     */
+    size_t getPosteriorgramsSizeInBytes() const;
+
+    /**
+     * @return Bytes allocated by the note events and the buffers used to create them.
+     */
+    size_t getNotesScratchSizeInBytes() const;
+
 private:
+    /**
+     * Frames of the posteriorgrams settled by the CNN, handed over to the note preparation thread.
+     */
+    struct NotesPreparation {
+        void setNumFramesReady(size_t inNumFrames);
+
+        /**
+         * Wait until more frames than already prepared are settled.
+         * @return Number of settled frames
+         */
+        size_t waitForFrames(size_t inNumFramesPrepared);
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        size_t numFramesReady = 0;
+    };
+
+    void _prepareNotes(NotesPreparation& ioPreparation);
+
+    // Frames settled between two hand-overs to the note preparation thread
+    static constexpr size_t NOTES_PREPARATION_BLOCK_SIZE = 64;
+
     // Posteriorgrams vector
     std::vector<std::vector<float>> mContoursPG;
     std::vector<std::vector<float>> mNotesPG;
@@ -71,8 +185,14 @@ private:
 
     Notes::ConvertParams mParams;
 
+    // Frequency range set by setMidiNoteRange, -1 for no limit
+    float mMinFrequency = -1.0f;
+    float mMaxFrequency = -1.0f;
+
     size_t mNumFrames = 0;
 
+    bool mUsePipeline = true;
+
     Features mFeaturesCalculator;
     BasicPitchCNN mBasicPitchCNN;
     Notes mNotesCreator;
@@ -8,27 +8,33 @@ using json = nlohmann::json;
 
 BasicPitchCNN::BasicPitchCNN()
 {
-    json json_cnn_contour = json::parse(BinaryData::cnn_contour_model_json,
-                                        BinaryData::cnn_contour_model_json + BinaryData::cnn_contour_model_jsonSize);
+    // If the model bundle is missing, weights are left uninitialized. Features reports the error in that case.
+    auto parse_model = [](ModelBundle::ModelFile inModelFile) {
+        auto model_data = ModelBundle::getModelData(inModelFile);
 
-    mCNNContour.parseJson(json_cnn_contour);
+        if (!model_data.isValid())
+            return json();
 
-    json json_cnn_note = json::parse(BinaryData::cnn_note_model_json,
-                                     BinaryData::cnn_note_model_json + BinaryData::cnn_note_model_jsonSize);
+        return json::parse(model_data.data, model_data.data + model_data.size);
+    };
 
-    mCNNNote.parseJson(json_cnn_note);
+    if (auto json_cnn_contour = parse_model(ModelBundle::ModelFile::CNNContour); !json_cnn_contour.is_null())
+        mCNNContour.parseJson(json_cnn_contour);
 
-    json json_cnn_onset_input =
-        json::parse(BinaryData::cnn_onset_1_model_json,
-                    BinaryData::cnn_onset_1_model_json + BinaryData::cnn_onset_1_model_jsonSize);
+    if (auto json_cnn_note = parse_model(ModelBundle::ModelFile::CNNNote); !json_cnn_note.is_null())
+        mCNNNote.parseJson(json_cnn_note);
 
-    mCNNOnsetInput.parseJson(json_cnn_onset_input);
+    if (auto json_cnn_onset_input = parse_model(ModelBundle::ModelFile::CNNOnsetInput); !json_cnn_onset_input.is_null())
+        mCNNOnsetInput.parseJson(json_cnn_onset_input);
 
-    json json_cnn_onset_output =
-        json::parse(BinaryData::cnn_onset_2_model_json,
-                    BinaryData::cnn_onset_2_model_json + BinaryData::cnn_onset_2_model_jsonSize);
+    if (auto json_cnn_onset_output = parse_model(ModelBundle::ModelFile::CNNOnsetOutput);
+        !json_cnn_onset_output.is_null())
+        mCNNOnsetOutput.parseJson(json_cnn_onset_output);
+}
 
-    mCNNOnsetOutput.parseJson(json_cnn_onset_output);
+BasicPitchCNN::~BasicPitchCNN()
+{
+    setParallelBranches(false);
 }
 
 void BasicPitchCNN::reset()
@@ -50,9 +56,25 @@ void BasicPitchCNN::reset()
     mCNNOnsetInput.reset();
     mCNNOnsetOutput.reset();
 
+    for (auto& array: mInputsCircularBuffer) {
+        array.fill(0.0f);
+    }
+
+    for (auto& array: mNoteInputsCircularBuffer) {
+        array.fill(0.0f);
+    }
+
+    for (auto& array: mConcatCircularBuffer) {
+        array.fill(0.0f);
+    }
+
     mNoteIdx = 0;
     mContourIdx = 0;
     mConcat2Idx = 0;
+    mInputIdx = 0;
+    mNoteInputIdx = 0;
+    mConcatIdx = 0;
+    mNumFramesSinceReset = 0;
 
     mInputArray.fill(0.0f);
 }
@@ -62,6 +84,28 @@ int BasicPitchCNN::getNumFramesLookahead()
     return mTotalLookahead;
 }
 
+void BasicPitchCNN::setParallelBranches(bool inParallelBranches)
+{
+    if (inParallelBranches == getParallelBranches()) {
+        return;
+    }
+
+    if (inParallelBranches) {
+        mNumFramesRequested.store(0);
+        mNumFramesDone.store(0);
+        mShouldStopWorker.store(false);
+        mOnsetInputThread = std::thread([this] { _onsetInputWorker(); });
+    } else {
+        {
+            std::lock_guard<std::mutex> lock(mParkMutex);
+            mShouldStopWorker.store(true);
+        }
+
+        mParkCondition.notify_one();
+        mOnsetInputThread.join();
+    }
+}
+
 void BasicPitchCNN::frameInference(const float* inData,
                                    std::vector<float>& outContours,
                                    std::vector<float>& outNotes,
@@ -74,6 +118,7 @@ void BasicPitchCNN::frameInference(const float* inData,
 
     // Copy data in aligned input array for inference
     std::copy(inData, inData + NUM_HARMONICS * NUM_FREQ_IN, mInputArray.begin());
+    std::copy(inData, inData + NUM_HARMONICS * NUM_FREQ_IN, mInputsCircularBuffer[(size_t) mInputIdx].begin());
 
     _runModels();
 
@@ -92,25 +137,119 @@ void BasicPitchCNN::frameInference(const float* inData,
     mContourIdx = (mContourIdx == mNumContourStored - 1) ? 0 : mContourIdx + 1;
     mNoteIdx = (mNoteIdx == mNumNoteStored - 1) ? 0 : mNoteIdx + 1;
     mConcat2Idx = (mConcat2Idx == mNumConcat2Stored - 1) ? 0 : mConcat2Idx + 1;
+    mInputIdx = (mInputIdx == mNumInputsStored - 1) ? 0 : mInputIdx + 1;
+    mNoteInputIdx = (mNoteInputIdx == mNumInputsCNNNote - 1) ? 0 : mNoteInputIdx + 1;
+    mConcatIdx = (mConcatIdx == mNumConcatStored - 1) ? 0 : mConcatIdx + 1;
+    mNumFramesSinceReset = std::min(mNumFramesSinceReset + 1, mMaxNumInputsStored);
+}
+
+void BasicPitchCNN::saveState(State& outState) const
+{
+    outState.contours = mContoursCircularBuffer;
+    outState.notes = mNotesCircularBuffer;
+    outState.concat2 = mConcat2CircularBuffer;
+    outState.inputs = mInputsCircularBuffer;
+    outState.noteInputs = mNoteInputsCircularBuffer;
+    outState.concat = mConcatCircularBuffer;
+
+    outState.contourIdx = mContourIdx;
+    outState.noteIdx = mNoteIdx;
+    outState.concat2Idx = mConcat2Idx;
+    outState.inputIdx = mInputIdx;
+    outState.noteInputIdx = mNoteInputIdx;
+    outState.concatIdx = mConcatIdx;
+    outState.numFramesSinceReset = mNumFramesSinceReset;
+}
+
+void BasicPitchCNN::restoreState(const State& inState)
+{
+    mContoursCircularBuffer = inState.contours;
+    mNotesCircularBuffer = inState.notes;
+    mConcat2CircularBuffer = inState.concat2;
+    mInputsCircularBuffer = inState.inputs;
+    mNoteInputsCircularBuffer = inState.noteInputs;
+    mConcatCircularBuffer = inState.concat;
+
+    mContourIdx = inState.contourIdx;
+    mNoteIdx = inState.noteIdx;
+    mConcat2Idx = inState.concat2Idx;
+    mInputIdx = inState.inputIdx;
+    mNoteInputIdx = inState.noteInputIdx;
+    mConcatIdx = inState.concatIdx;
+    mNumFramesSinceReset = inState.numFramesSinceReset;
+
+    // Right after a reset, the models have seen fewer inputs than their history: replay only these.
+    _replayInputs(mCNNContour,
+                  mInputsCircularBuffer,
+                  mInputIdx,
+                  std::min(mNumInputsCNNContour, mNumFramesSinceReset),
+                  mInputArray);
+    _replayInputs(mCNNOnsetInput,
+                  mInputsCircularBuffer,
+                  mInputIdx,
+                  std::min(mNumInputsCNNOnsetInput, mNumFramesSinceReset),
+                  mInputArray);
+    _replayInputs(mCNNNote,
+                  mNoteInputsCircularBuffer,
+                  mNoteInputIdx,
+                  std::min(mNumInputsCNNNote, mNumFramesSinceReset),
+                  mContourArray);
+    _replayInputs(mCNNOnsetOutput,
+                  mConcatCircularBuffer,
+                  mConcatIdx,
+                  std::min(mNumInputsCNNOnsetOutput, mNumFramesSinceReset),
+                  mConcatArray);
+}
+
+template <typename ModelType, typename BufferType, typename ArrayType>
+void BasicPitchCNN::_replayInputs(
+    ModelType& ioModel, const BufferType& inBuffer, int inNextIdx, int inNumFrames, ArrayType& ioAlignedInput)
+{
+    const auto buffer_size = static_cast<int>(inBuffer.size());
+    assert(inNumFrames <= buffer_size);
+
+    ioModel.reset();
+
+    for (int i = inNumFrames; i > 0; i--) {
+        const auto& input = inBuffer[(size_t) _wrapIndex(inNextIdx - i, buffer_size)];
+        std::copy(input.begin(), input.end(), ioAlignedInput.begin());
+        ioModel.forward(ioAlignedInput.data());
+    }
 }
 
 void BasicPitchCNN::_runModels()
 {
-    // Run models and push results in appropriate circular buffer
-    mCNNOnsetInput.forward(mInputArray.data());
-    std::copy(mCNNOnsetInput.getOutputs(),
-              mCNNOnsetInput.getOutputs() + 32 * NUM_FREQ_OUT,
-              mConcat2CircularBuffer[(size_t) mConcat2Idx].begin());
+    const bool parallel_branches = getParallelBranches();
+
+    // Run models and push results in appropriate circular buffer.
+    // The onset input branch only joins the others at the concat operation.
+    if (parallel_branches) {
+        mNumFramesRequested.store(mNumFramesRequested.load(std::memory_order_relaxed) + 1);
+
+        if (mIsWorkerParked.load()) {
+            std::lock_guard<std::mutex> lock(mParkMutex);
+            mParkCondition.notify_one();
+        }
+    } else {
+        _runOnsetInput();
+    }
 
     mCNNContour.forward(mInputArray.data());
     std::copy(mCNNContour.getOutputs(),
               mCNNContour.getOutputs() + NUM_FREQ_IN,
               mContoursCircularBuffer[(size_t) mContourIdx].begin());
+    std::copy(mCNNContour.getOutputs(),
+              mCNNContour.getOutputs() + NUM_FREQ_IN,
+              mNoteInputsCircularBuffer[(size_t) mNoteInputIdx].begin());
 
     mCNNNote.forward(mCNNContour.getOutputs());
     std::copy(
         mCNNNote.getOutputs(), mCNNNote.getOutputs() + NUM_FREQ_OUT, mNotesCircularBuffer[(size_t) mNoteIdx].begin());
 
+    if (parallel_branches) {
+        _waitForOnsetInputDone();
+    }
+
     // Concat operation with correct frame shift
     _concat();
 
@@ -138,4 +277,68 @@ void BasicPitchCNN::_concat()
                   mConcat2CircularBuffer[concat2_index].begin() + (i + 1) * 32,
                   mConcatArray.begin() + i * 33 + 1);
     }
+
+    std::copy(mConcatArray.begin(), mConcatArray.end(), mConcatCircularBuffer[(size_t) mConcatIdx].begin());
+}
+
+void BasicPitchCNN::_runOnsetInput()
+{
+    mCNNOnsetInput.forward(mInputArray.data());
+    std::copy(mCNNOnsetInput.getOutputs(),
+              mCNNOnsetInput.getOutputs() + 32 * NUM_FREQ_OUT,
+              mConcat2CircularBuffer[(size_t) mConcat2Idx].begin());
+}
+
+void BasicPitchCNN::_onsetInputWorker()
+{
+    uint64_t num_frames_done = 0;
+
+    while (_waitForOnsetInputRequest(num_frames_done)) {
+        _runOnsetInput();
+        mNumFramesDone.store(++num_frames_done, std::memory_order_release);
+    }
+}
+
+bool BasicPitchCNN::_waitForOnsetInputRequest(uint64_t inNumFramesDone)
+{
+    auto is_requested = [this, inNumFramesDone] { return mNumFramesRequested.load() > inNumFramesDone; };
+
+    for (int i = 0;; i++) {
+        if (mShouldStopWorker.load()) {
+            return false;
+        }
+
+        if (is_requested()) {
+            return true;
+        }
+
+        if (i < mNumSpins) {
+            continue;
+        }
+
+        if (i < mNumSpins + mNumYields) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Idle for a while (e.g. between transcriptions): sleep until the next request.
+        // Setting the flag before checking the counter, while _runModels does the opposite, ensures one of the two
+        // sides sees the other so that no request is missed.
+        std::unique_lock<std::mutex> lock(mParkMutex);
+        mIsWorkerParked.store(true);
+        mParkCondition.wait(lock, [this, &is_requested] { return mShouldStopWorker.load() || is_requested(); });
+        mIsWorkerParked.store(false);
+        i = 0;
+    }
+}
+
+void BasicPitchCNN::_waitForOnsetInputDone() const
+{
+    const auto num_frames_requested = mNumFramesRequested.load(std::memory_order_relaxed);
+
+    for (int i = 0; mNumFramesDone.load(std::memory_order_acquire) < num_frames_requested; i++) {
+        if (i >= mNumSpins) {
+            std::this_thread::yield();
+        }
+    }
 }
@@ -5,9 +5,17 @@
 #ifndef BasicPitchCNN_h
 #define BasicPitchCNN_h
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
 #include "RTNeural/RTNeural.h"
 
-#include "BinaryData.h"
+#include "ModelBundle.h"
 #include "BasicPitchConstants.h"
 
 /**
@@ -18,7 +26,10 @@ class BasicPitchCNN
 public:
     BasicPitchCNN();
 
-    ~BasicPitchCNN() = default;
+    ~BasicPitchCNN();
+
+    BasicPitchCNN(const BasicPitchCNN&) = delete;
+    BasicPitchCNN& operator=(const BasicPitchCNN&) = delete;
 
     /**
      * Resets the internal state of the CNN.
@@ -32,6 +43,18 @@ public:
      */
     static int getNumFramesLookahead();
 
+    /**
+     * Run the onset input model on a worker thread, in parallel with the contour and note models, instead of running
+     * the four models in sequence on the calling thread. Outputs are identical, the latency of frameInference is
+     * roughly halved at the cost of a second core kept busy while frames are processed.
+     * The worker hands frames over through atomic counters, and only sleeps after being idle for a while.
+     * Must not be called while frameInference is running.
+     * @param inParallelBranches True to start the worker thread, false to stop it.
+     */
+    void setParallelBranches(bool inParallelBranches);
+
+    bool getParallelBranches() const { return mOnsetInputThread.joinable(); }
+
     /**
      * Run inference for a single frame. inData should have 8 * 264 elements
      * @param inData input features (CQT harmonically stacked).
@@ -44,6 +67,28 @@ public:
                         std::vector<float>& outNotes,
                         std::vector<float>& outOnsets);
 
+    /**
+     * Streaming state of the CNN: everything the next outputs of frameInference depend on besides the weights.
+     * Trivially copyable (about 200 kB), so checkpoints can be kept in memory or copied as raw bytes.
+     */
+    struct State;
+
+    /**
+     * Save the streaming state, e.g. every few seconds of audio, to resume inference from there later.
+     * @param outState State to write into. Better allocated on the heap given its size.
+     */
+    void saveState(State& outState) const;
+
+    /**
+     * Resume from a state saved by saveState, on this or another instance with the same weights. The following
+     * outputs of frameInference are identical to the ones the saving instance would have given.
+     * The RTNeural layers keep their state privately, so it is rebuilt by feeding each model the few past inputs that
+     * determine it (the sum of its kernel time sizes minus one), far fewer than the warm-up frames.
+     * Must not be called while frameInference is running.
+     * @param inState Previously saved state.
+     */
+    void restoreState(const State& inState);
+
 private:
     /**
      * Run different sequential models with correct time offset ...
@@ -55,6 +100,39 @@ private:
      */
     void _concat();
 
+    /**
+     * Run the onset input model on mInputArray and push its output in the concat 2 circular buffer.
+     */
+    void _runOnsetInput();
+
+    /**
+     * Loop of the worker thread when running the branches in parallel.
+     */
+    void _onsetInputWorker();
+
+    /**
+     * Wait on the worker thread for a frame after inNumFramesDone to be requested.
+     * @return False if the worker should stop instead.
+     */
+    bool _waitForOnsetInputRequest(uint64_t inNumFramesDone);
+
+    /**
+     * Wait on the calling thread for the worker to be done with the last requested frame.
+     */
+    void _waitForOnsetInputDone() const;
+
+    /**
+     * Reset the model and run it on the last inNumFrames inputs of a circular buffer, to rebuild its internal state.
+     * @param ioModel RTNeural model to rebuild
+     * @param inBuffer Circular buffer of model inputs
+     * @param inNextIdx Index of the next input to be written in inBuffer, i.e. of the oldest one
+     * @param inNumFrames Number of inputs to run, at most the size of inBuffer
+     * @param ioAlignedInput Aligned array to copy each input to before running the model
+     */
+    template <typename ModelType, typename BufferType, typename ArrayType>
+    static void _replayInputs(
+        ModelType& ioModel, const BufferType& inBuffer, int inNextIdx, int inNumFrames, ArrayType& ioAlignedInput);
+
     /**
      * Return in-range index for given size as if periodic.
      * @param inIndex maybe out of range index
@@ -67,6 +145,9 @@ private:
 
     alignas(RTNEURAL_DEFAULT_ALIGNMENT) std::array<float, 33 * NUM_FREQ_OUT> mConcatArray {};
 
+    // Only used to replay the contours in the note model when restoring a state.
+    alignas(RTNEURAL_DEFAULT_ALIGNMENT) std::array<float, NUM_FREQ_IN> mContourArray {};
+
     static constexpr int mLookaheadCNNContour = 3;
     static constexpr int mLookaheadCNNNote = 6;
     static constexpr int mLookaheadCNNOnsetInput = 2;
@@ -77,6 +158,17 @@ private:
     static constexpr int mNumNoteStored = mTotalLookahead - (mLookaheadCNNContour + mLookaheadCNNNote) + 1;
     static constexpr int mNumConcat2Stored = mLookaheadCNNContour + mLookaheadCNNNote - mLookaheadCNNOnsetInput + 1;
 
+    // Number of past inputs determining the internal state of each model: sum of (kernel time size - 1) over its layers.
+    static constexpr int mNumInputsCNNContour = (3 - 1) + (5 - 1);
+    static constexpr int mNumInputsCNNNote = (7 - 1) + (7 - 1);
+    static constexpr int mNumInputsCNNOnsetInput = 5 - 1;
+    static constexpr int mNumInputsCNNOnsetOutput = 3 - 1;
+
+    static constexpr int mNumInputsStored = std::max(mNumInputsCNNContour, mNumInputsCNNOnsetInput);
+    static constexpr int mNumConcatStored = mNumInputsCNNOnsetOutput;
+    static constexpr int mMaxNumInputsStored =
+        std::max({mNumInputsCNNContour, mNumInputsCNNNote, mNumInputsCNNOnsetInput, mNumInputsCNNOnsetOutput});
+
     std::array<std::array<float, NUM_FREQ_IN>, mNumContourStored> mContoursCircularBuffer {};
     std::array<std::array<float, NUM_FREQ_OUT>, mNumNoteStored> mNotesCircularBuffer {}; // Also concat 1
     std::array<std::array<float, 32 * NUM_FREQ_OUT>, mNumConcat2Stored> mConcat2CircularBuffer {};
@@ -85,6 +177,30 @@ private:
     int mNoteIdx = 0;
     int mConcat2Idx = 0;
 
+    // Past inputs of the models, only kept to restore a state. The note model depends on more past contours than the
+    // ones kept for the output alignment, so they have their own buffer.
+    std::array<std::array<float, NUM_FREQ_IN * NUM_HARMONICS>, mNumInputsStored> mInputsCircularBuffer {};
+    std::array<std::array<float, NUM_FREQ_IN>, mNumInputsCNNNote> mNoteInputsCircularBuffer {};
+    std::array<std::array<float, 33 * NUM_FREQ_OUT>, mNumConcatStored> mConcatCircularBuffer {};
+    int mInputIdx = 0;
+    int mNoteInputIdx = 0;
+    int mConcatIdx = 0;
+
+    // Frames run since the last reset, capped to mMaxNumInputsStored. Fewer past inputs are replayed if lower.
+    int mNumFramesSinceReset = 0;
+
+    // Number of busy polls, then of yields, before the waiting thread gives up its core.
+    static constexpr int mNumSpins = 1000;
+    static constexpr int mNumYields = 10000;
+
+    std::thread mOnsetInputThread;
+    std::atomic<uint64_t> mNumFramesRequested {0};
+    std::atomic<uint64_t> mNumFramesDone {0};
+    std::atomic<bool> mShouldStopWorker {false};
+    std::atomic<bool> mIsWorkerParked {false};
+    std::mutex mParkMutex;
+    std::condition_variable mParkCondition;
+
     RTNeural::ModelT<float,
                      NUM_FREQ_IN * NUM_HARMONICS,
                      NUM_FREQ_IN,
@@ -118,4 +234,23 @@ private:
         mCNNOnsetOutput;
 };
 
+struct BasicPitchCNN::State {
+    std::array<std::array<float, NUM_FREQ_IN>, mNumContourStored> contours;
+    std::array<std::array<float, NUM_FREQ_OUT>, mNumNoteStored> notes;
+    std::array<std::array<float, 32 * NUM_FREQ_OUT>, mNumConcat2Stored> concat2;
+    std::array<std::array<float, NUM_FREQ_IN * NUM_HARMONICS>, mNumInputsStored> inputs;
+    std::array<std::array<float, NUM_FREQ_IN>, mNumInputsCNNNote> noteInputs;
+    std::array<std::array<float, 33 * NUM_FREQ_OUT>, mNumConcatStored> concat;
+
+    int contourIdx;
+    int noteIdx;
+    int concat2Idx;
+    int inputIdx;
+    int noteInputIdx;
+    int concatIdx;
+    int numFramesSinceReset;
+};
+
+static_assert(std::is_trivially_copyable_v<BasicPitchCNN::State>);
+
 #endif // BasicPitchCNN_h
@@ -14,7 +14,19 @@ Features::Features()
         mSessionOptions.SetInterOpNumThreads(1);
         mSessionOptions.SetIntraOpNumThreads(1);
 
-        mSession = Ort::Session(mEnv, BinaryData::features_model_ort, BinaryData::features_model_ortSize, mSessionOptions);
+        auto model_data = ModelBundle::getModelData(ModelBundle::ModelFile::Features);
+
+        if (!model_data.isValid()) {
+            mErrorMessage = "Features model not available: " + ModelBundle::getErrorMessage();
+            return;
+        }
+
+        // The model data is either embedded or mapped for the lifetime of the process: let ORT use it in place
+        // (including initializers) instead of copying it for every session.
+        mSessionOptions.AddConfigEntry("session.use_ort_model_bytes_directly", "1");
+        mSessionOptions.AddConfigEntry("session.use_ort_model_bytes_for_initializers", "1");
+
+        mSession = Ort::Session(mEnv, model_data.data, model_data.size, mSessionOptions);
 
         mIsInitialized = true;
     } catch (const Ort::Exception& e) {
@@ -8,7 +8,7 @@
 #include "cassert"
 #include <onnxruntime_cxx_api.h>
 
-#include "BinaryData.h"
+#include "ModelBundle.h"
 #include "BasicPitchConstants.h"
 
 /**
@@ -0,0 +1,196 @@
+#include "ModelBundle.h"
+
+#include <array>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if NN_EMBED_MODEL_DATA
+#include "ModelBinaryData.h"
+#else
+#include "ReadOnlyFileMapping.h"
+#endif
+
+namespace ModelBundle
+{
+
+namespace
+{
+constexpr size_t numModelFiles = static_cast<size_t>(ModelFile::NumModelFiles);
+
+#if NN_EMBED_MODEL_DATA
+
+ModelData getEmbeddedModelData(ModelFile inModelFile)
+{
+    switch (inModelFile) {
+        case ModelFile::Features:
+            return {ModelBinaryData::features_model_ort, static_cast<size_t>(ModelBinaryData::features_model_ortSize)};
+        case ModelFile::CNNContour:
+            return {ModelBinaryData::cnn_contour_model_json,
+                    static_cast<size_t>(ModelBinaryData::cnn_contour_model_jsonSize)};
+        case ModelFile::CNNNote:
+            return {ModelBinaryData::cnn_note_model_json,
+                    static_cast<size_t>(ModelBinaryData::cnn_note_model_jsonSize)};
+        case ModelFile::CNNOnsetInput:
+            return {ModelBinaryData::cnn_onset_1_model_json,
+                    static_cast<size_t>(ModelBinaryData::cnn_onset_1_model_jsonSize)};
+        case ModelFile::CNNOnsetOutput:
+            return {ModelBinaryData::cnn_onset_2_model_json,
+                    static_cast<size_t>(ModelBinaryData::cnn_onset_2_model_jsonSize)};
+        default:
+            return {};
+    }
+}
+
+#else
+
+namespace fs = std::filesystem;
+
+constexpr std::array<const char*, numModelFiles> modelFileNames {
+    "features_model.ort", "cnn_contour_model.json", "cnn_note_model.json", "cnn_onset_1_model.json",
+    "cnn_onset_2_model.json"};
+
+fs::path envPath(const char* inName)
+{
+    const char* value = std::getenv(inName);
+    if (value == nullptr || *value == '\0') {
+        return {};
+    }
+    return fs::path(value);
+}
+
+std::vector<fs::path> candidateDirectories()
+{
+    std::vector<fs::path> dirs;
+
+    if (auto env = envPath("NEURALNOTE_MODEL_DIR"); !env.empty()) {
+        dirs.push_back(env);
+    }
+
+#ifdef NN_MODEL_BUNDLE_DIR
+    if (std::string(NN_MODEL_BUNDLE_DIR).size() > 0) {
+        dirs.emplace_back(NN_MODEL_BUNDLE_DIR);
+    }
+#endif
+
+#if defined(_WIN32)
+    if (auto app_data = envPath("APPDATA"); !app_data.empty()) {
+        dirs.push_back(app_data / "NeuralNote" / "Models");
+    }
+#else
+    if (auto home = envPath("HOME"); !home.empty()) {
+        dirs.push_back(home / ".neuralnote" / "models");
+#if defined(__APPLE__)
+        dirs.push_back(home / "Library" / "Application Support" / "NeuralNote" / "Models");
+#else
+        dirs.push_back(home / ".local" / "share" / "NeuralNote" / "Models");
+#endif
+    }
+#endif
+
+    std::error_code error;
+    dirs.push_back(fs::current_path(error) / "NeuralNoteModels");
+
+    return dirs;
+}
+
+bool containsAllModelFiles(const fs::path& inDirectory)
+{
+    std::error_code error;
+
+    for (const auto* name: modelFileNames) {
+        if (!fs::is_regular_file(inDirectory / name, error)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+struct Bundle {
+    std::once_flag directoryFound;
+    fs::path directory;
+    std::string errorMessage;
+
+    std::mutex mappingsMutex;
+    std::array<std::unique_ptr<ReadOnlyFileMapping>, numModelFiles> mappings;
+};
+
+Bundle& getBundle()
+{
+    // Shared by all plugin instances of the process, never destroyed so the data outlives every ORT session
+    static auto* bundle = new Bundle();
+
+    std::call_once(bundle->directoryFound, [] {
+        for (const auto& dir: candidateDirectories()) {
+            if (containsAllModelFiles(dir)) {
+                bundle->directory = dir;
+                return;
+            }
+        }
+
+        bundle->errorMessage = "Model bundle not found. Set NEURALNOTE_MODEL_DIR to a directory containing "
+                               "features_model.ort and the cnn_*_model.json files.";
+    });
+
+    return *bundle;
+}
+
+#endif
+} // namespace
+
+ModelData getModelData(ModelFile inModelFile)
+{
+    if (inModelFile == ModelFile::NumModelFiles) {
+        return {};
+    }
+
+#if NN_EMBED_MODEL_DATA
+    return getEmbeddedModelData(inModelFile);
+#else
+    auto& bundle = getBundle();
+
+    if (bundle.directory.empty()) {
+        return {};
+    }
+
+    const auto idx = static_cast<size_t>(inModelFile);
+
+    std::lock_guard<std::mutex> lock(bundle.mappingsMutex);
+
+    if (bundle.mappings[idx] == nullptr) {
+        bundle.mappings[idx] = std::make_unique<ReadOnlyFileMapping>(bundle.directory / modelFileNames[idx]);
+
+        if (!bundle.mappings[idx]->isValid()) {
+            bundle.errorMessage = bundle.mappings[idx]->getErrorMessage();
+        }
+    }
+
+    const auto& mapping = *bundle.mappings[idx];
+    return {mapping.getData(), mapping.getSize()};
+#endif
+}
+
+std::string getBundleDirectory()
+{
+#if NN_EMBED_MODEL_DATA
+    return {};
+#else
+    return getBundle().directory.string();
+#endif
+}
+
+std::string getErrorMessage()
+{
+#if NN_EMBED_MODEL_DATA
+    return {};
+#else
+    auto& bundle = getBundle();
+    std::lock_guard<std::mutex> lock(bundle.mappingsMutex);
+    return bundle.errorMessage;
+#endif
+}
+
+} // namespace ModelBundle
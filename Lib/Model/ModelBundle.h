@@ -0,0 +1,50 @@
+#ifndef ModelBundle_h
+#define ModelBundle_h
+
+#include <cstddef>
+#include <string>
+
+#ifndef NN_EMBED_MODEL_DATA
+#define NN_EMBED_MODEL_DATA 1
+#endif
+
+/**
+ * Access to the transcription model files (Features ORT model and the four CNN json files).
+ *
+ * With NN_EMBED_MODEL_DATA (CMake option EMBED_MODEL_DATA, default) they come from ModelBinaryData (model_data
+ * target). Otherwise they are memory-mapped read-only from a model bundle directory on disk, so that their pages are
+ * shared through the OS page cache between all plugin instances and processes instead of being part of every binary's
+ * data segment.
+ * The data returned stays valid for the lifetime of the process.
+ */
+namespace ModelBundle
+{
+enum class ModelFile { Features = 0, CNNContour, CNNNote, CNNOnsetInput, CNNOnsetOutput, NumModelFiles };
+
+struct ModelData {
+    const char* data = nullptr;
+    size_t size = 0;
+
+    bool isValid() const { return data != nullptr && size > 0; }
+};
+
+/**
+ * Get the content of a model file. Files of the bundle are mapped on first use.
+ * @param inModelFile Model file to get.
+ * @return Data and size, invalid if the file could not be found or mapped.
+ */
+ModelData getModelData(ModelFile inModelFile);
+
+/**
+ * @return Directory the model files are mapped from, empty if they are embedded or no bundle was found.
+ */
+std::string getBundleDirectory();
+
+/**
+ * @return Why the model files could not be found, empty if no error.
+ */
+std::string getErrorMessage();
+
+} // namespace ModelBundle
+
+#endif // ModelBundle_h
@@ -3,6 +3,10 @@
 //
 
 #include "Notes.h"
+#include "ResourceStats.h"
+
+#include <numeric>
+#include <tuple>
 
 bool Notes::Event::operator==(const Notes::Event& other) const
 {
@@ -11,6 +15,84 @@ bool Notes::Event::operator==(const Notes::Event& other) const
            && this->bends == other.bends;
 }
 
+Notes::EventsDiff Notes::computeEventsDiff(const std::vector<Event>& inPrevious, const std::vector<Event>& inNew)
+{
+    // Total order on events so that identical events end up at the same position in both sorted index vectors
+    auto event_less = [](const Event& a, const Event& b) {
+        return std::tie(a.startFrame, a.pitch, a.endFrame, a.startTime, a.endTime, a.amplitude, a.bends)
+               < std::tie(b.startFrame, b.pitch, b.endFrame, b.startTime, b.endTime, b.amplitude, b.bends);
+    };
+
+    auto sorted_indices = [&event_less](const std::vector<Event>& inEvents) {
+        std::vector<size_t> indices(inEvents.size());
+        std::iota(indices.begin(), indices.end(), 0);
+        std::sort(indices.begin(), indices.end(), [&](size_t a, size_t b) {
+            return event_less(inEvents[a], inEvents[b]);
+        });
+        return indices;
+    };
+
+    const auto prev_indices = sorted_indices(inPrevious);
+    const auto new_indices = sorted_indices(inNew);
+
+    EventsDiff diff;
+    bool has_bounds = false;
+
+    auto extend_bounds = [&diff, &has_bounds](const Event& inEvent) {
+        if (!has_bounds) {
+            diff.minTime = inEvent.startTime;
+            diff.maxTime = inEvent.endTime;
+            diff.minPitch = inEvent.pitch;
+            diff.maxPitch = inEvent.pitch;
+            has_bounds = true;
+        } else {
+            diff.minTime = std::min(diff.minTime, inEvent.startTime);
+            diff.maxTime = std::max(diff.maxTime, inEvent.endTime);
+            diff.minPitch = std::min(diff.minPitch, inEvent.pitch);
+            diff.maxPitch = std::max(diff.maxPitch, inEvent.pitch);
+        }
+    };
+
+    size_t i = 0;
+    size_t j = 0;
+
+    while (i < prev_indices.size() && j < new_indices.size()) {
+        const auto& prev_event = inPrevious[prev_indices[i]];
+        const auto& new_event = inNew[new_indices[j]];
+
+        if (prev_event == new_event) {
+            i++;
+            j++;
+        } else if (prev_event.startFrame == new_event.startFrame && prev_event.pitch == new_event.pitch) {
+            diff.modified.emplace_back(prev_event, new_event);
+            extend_bounds(prev_event);
+            extend_bounds(new_event);
+            i++;
+            j++;
+        } else if (event_less(prev_event, new_event)) {
+            diff.removed.push_back(prev_event);
+            extend_bounds(prev_event);
+            i++;
+        } else {
+            diff.added.push_back(new_event);
+            extend_bounds(new_event);
+            j++;
+        }
+    }
+
+    for (; i < prev_indices.size(); i++) {
+        diff.removed.push_back(inPrevious[prev_indices[i]]);
+        extend_bounds(inPrevious[prev_indices[i]]);
+    }
+
+    for (; j < new_indices.size(); j++) {
+        diff.added.push_back(inNew[new_indices[j]]);
+        extend_bounds(inNew[new_indices[j]]);
+    }
+
+    return diff;
+}
+
 std::vector<Notes::Event> Notes::convert(const std::vector<std::vector<float>>& inNotesPG,
                                          const std::vector<std::vector<float>>& inOnsetsPG,
                                          const std::vector<std::vector<float>>& inContoursPG,
@@ -31,66 +113,106 @@ std::vector<Notes::Event> Notes::convert(const std::vector<std::vector<float>>&
     assert(n_notes == inOnsetsPG[0].size());
     assert(n_notes == NUM_FREQ_OUT);
 
-    std::vector<std::vector<float>> inferred_onsets;
-    auto onsets_ptr = &inOnsetsPG;
-    if (inParams.inferOnsets) {
-        inferred_onsets = _inferredOnsets<float>(inOnsetsPG, inNotesPG);
-        onsets_ptr = &inferred_onsets;
+    if (inNewAudio) {
+        prepareNewAudio(static_cast<size_t>(n_frames));
+        prepareFrames(inNotesPG, inOnsetsPG, 0, static_cast<size_t>(n_frames));
     }
-    auto& onsets = *onsets_ptr;
 
-    if (inNewAudio) {
-        mRemainingEnergy = inNotesPG;
+    assert(mNumPreparedFrames == n_frames);
+    auto& onsets = inParams.inferOnsets ? mInferredOnsets : inOnsetsPG;
+
+    // constrain frequencies
+    const auto max_note_idx =
+        inParams.maxFrequency < 0
+            ? n_notes - 1
+            : std::clamp(NoteUtils::hzToMidi(inParams.maxFrequency) - MIDI_OFFSET, 0, n_notes - 1);
+    const auto min_note_idx =
+        inParams.minFrequency < 0
+            ? 0
+            : std::clamp(NoteUtils::hzToMidi(inParams.minFrequency) - MIDI_OFFSET, 0, n_notes - 1);
+
+    if (min_note_idx > max_note_idx) {
+        return events;
+    }
+
+    // Copy without changing the location of the original data. Notes out of the range are never read.
+    assert(mRemainingEnergy.size() == n_frames);
+    for (size_t f = 0; f < n_frames; f++) {
+        assert(inNotesPG[f].size() == NUM_FREQ_OUT);
+        assert(mRemainingEnergy[f].size() == NUM_FREQ_OUT);
+
+        std::copy(inNotesPG[f].begin() + min_note_idx,
+                  inNotesPG[f].begin() + max_note_idx + 1,
+                  mRemainingEnergy[f].begin() + min_note_idx);
+    }
+
+    // stop 1 frame early to prevent edge case
+    // as per https://github.com/spotify/basic-pitch/blob/f85a8e9ade1f297b8adb39b155c483e2312e1aca/basic_pitch/note_creation.py#L399
+    const int last_frame = n_frames - 1;
+
+    const auto partitions = _findPartitions(inParams, min_note_idx, max_note_idx, last_frame);
+
+    if (partitions.size() > 1) {
+        _convertPartitions(partitions, inNotesPG, onsets, inParams, min_note_idx, max_note_idx, last_frame, events);
     } else {
-        // Copy without changing the location of the original data
-        assert(mRemainingEnergy.size() == n_frames);
-        for (size_t f = 0; f < n_frames; f++) {
-            assert(inNotesPG[f].size() == NUM_FREQ_OUT);
-            assert(mRemainingEnergy[f].size() == NUM_FREQ_OUT);
+        _addOnsetNotes(onsets, inParams, min_note_idx, max_note_idx, 0, last_frame, last_frame, events);
+
+        if (inParams.melodiaTrick) {
+            // With a constrained range, only sort and go through the notes of the range, moved to the front.
+            auto index_end = mRemainingEnergyIndex.end();
+
+            if (min_note_idx > 0 || max_note_idx < n_notes - 1) {
+                index_end = std::partition(
+                    mRemainingEnergyIndex.begin(), mRemainingEnergyIndex.end(), [=](const _pg_index& inIndex) {
+                        return inIndex.noteIdx >= min_note_idx && inIndex.noteIdx <= max_note_idx;
+                    });
+            }
+
+            std::sort(mRemainingEnergyIndex.begin(), index_end, _isHigherEnergy);
 
-            std::copy(inNotesPG[f].begin(), inNotesPG[f].end(), mRemainingEnergy[f].begin());
+            _addMelodiaNotes(
+                mRemainingEnergyIndex.begin(), index_end, inNotesPG, inParams, last_frame, events, nullptr);
         }
     }
 
-    if (inParams.melodiaTrick) {
-        if (inNewAudio) {
-            // Fill mRemainingEnergyIndex
-            mRemainingEnergyIndex.clear();
-            mRemainingEnergyIndex.reserve(static_cast<size_t>(n_frames) * static_cast<size_t>(NUM_FREQ_OUT));
-
-            for (int frame_idx = 0; frame_idx < n_frames; frame_idx++) {
-                for (int freq_idx = 0; freq_idx < NUM_FREQ_OUT; freq_idx++) {
-                    mRemainingEnergyIndex.push_back(
-                        {&mRemainingEnergy[static_cast<size_t>(frame_idx)][static_cast<size_t>(freq_idx)],
-                         frame_idx,
-                         freq_idx});
-                }
-            }
+    sortEvents(events);
 
-            mRemainingEnergyIndex.shrink_to_fit();
+    if (inParams.pitchBend != NoPitchBend) {
+        _addPitchBends(events, inContoursPG);
+        if (inParams.pitchBend == SinglePitchBend) {
+            dropOverlappingPitchBends(events);
         }
     }
 
-    const auto frame_threshold = inParams.frameThreshold;
-    // TODO: infer frame_threshold if < 0, can be merged with inferredOnsets.
+    return events;
+}
 
-    // constrain frequencies
-    const auto max_note_idx =
-        inParams.maxFrequency < 0 ? n_notes - 1 : NoteUtils::hzToMidi(inParams.maxFrequency) - MIDI_OFFSET;
-    const auto min_note_idx = inParams.minFrequency < 0 ? 0 : NoteUtils::hzToMidi(inParams.minFrequency) - MIDI_OFFSET;
+void Notes::setNumThreads(size_t inNumThreads, int inMinFramesPerPartition)
+{
+    mNumThreads = std::max(inNumThreads, size_t(1));
+    mMinFramesPerPartition = std::max(inMinFramesPerPartition, 1);
+}
 
-    // stop 1 frame early to prevent edge case
-    // as per https://github.com/spotify/basic-pitch/blob/f85a8e9ade1f297b8adb39b155c483e2312e1aca/basic_pitch/note_creation.py#L399
-    const int last_frame = n_frames - 1;
+void Notes::_addOnsetNotes(const std::vector<std::vector<float>>& inOnsets,
+                           const ConvertParams& inParams,
+                           int inMinNoteIdx,
+                           int inMaxNoteIdx,
+                           int inBeginFrame,
+                           int inEndFrame,
+                           int inLastFrame,
+                           std::vector<Event>& ioEvents)
+{
+    const auto frame_threshold = inParams.frameThreshold;
+    // TODO: infer frame_threshold if < 0, can be merged with inferredOnsets.
 
     // Go backwards in time
-    for (int frame_idx = last_frame - 1; frame_idx >= 0; frame_idx--) {
-        for (int note_idx = max_note_idx; note_idx >= min_note_idx; note_idx--) {
-            auto onset = onsets[frame_idx][note_idx];
+    for (int frame_idx = inEndFrame - 1; frame_idx >= inBeginFrame; frame_idx--) {
+        for (int note_idx = inMaxNoteIdx; note_idx >= inMinNoteIdx; note_idx--) {
+            auto onset = inOnsets[frame_idx][note_idx];
 
             // equivalent to argrelmax logic
-            auto prev = frame_idx <= 0 ? onset : onsets[frame_idx - 1][note_idx];
-            auto next = frame_idx >= last_frame ? onset : onsets[frame_idx + 1][note_idx];
+            auto prev = frame_idx <= 0 ? onset : inOnsets[frame_idx - 1][note_idx];
+            auto next = frame_idx >= inLastFrame ? onset : inOnsets[frame_idx + 1][note_idx];
 
             if (onset < inParams.onsetThreshold || onset < prev || onset < next) {
                 continue;
@@ -99,7 +221,7 @@ std::vector<Notes::Event> Notes::convert(const std::vector<std::vector<float>>&
             // find time index at this frequency band where the frames drop below an energy threshold
             int i = frame_idx + 1;
             int k = 0; // number of frames since energy dropped below threshold
-            while (i < last_frame && k < inParams.energyThreshold) {
+            while (i < inLastFrame && k < inParams.energyThreshold) {
                 if (mRemainingEnergy[i][note_idx] < frame_threshold) {
                     k++;
                 } else {
@@ -130,7 +252,7 @@ std::vector<Notes::Event> Notes::convert(const std::vector<std::vector<float>>&
 
             amplitude /= (i - frame_idx);
 
-            events.push_back(Event {
+            ioEvents.push_back(Event {
                 _modelFrameToTime(frame_idx) /* startTime */,
                 _modelFrameToTime(i) /* endTime */,
                 frame_idx /* startFrame */,
@@ -140,98 +262,312 @@ std::vector<Notes::Event> Notes::convert(const std::vector<std::vector<float>>&
             });
         }
     }
+}
 
-    if (inParams.melodiaTrick) {
-        std::sort(mRemainingEnergyIndex.begin(),
-                  mRemainingEnergyIndex.end(),
-                  [](const _pg_index& a, const _pg_index& b) { return *a.value > *b.value; });
+void Notes::_addMelodiaNotes(std::vector<_pg_index>::iterator inBegin,
+                             std::vector<_pg_index>::iterator inEnd,
+                             const std::vector<std::vector<float>>& inNotesPG,
+                             const ConvertParams& inParams,
+                             int inLastFrame,
+                             std::vector<Event>& ioEvents,
+                             std::vector<_peak>* outPeaks)
+{
+    const auto frame_threshold = inParams.frameThreshold;
 
-        // loop through each remaining note probability in descending order
-        // until reaching frame_threshold.
-        for (auto& [energy_ptr, frame_idx, note_idx]: mRemainingEnergyIndex) {
-            auto& energy = *energy_ptr;
+    // loop through each remaining note probability in descending order
+    // until reaching frame_threshold.
+    for (auto it = inBegin; it != inEnd; ++it) {
+        auto& [energy_ptr, frame_idx, note_idx] = *it;
+        auto& energy = *energy_ptr;
 
-            // skip those that have already been zeroed
-            if (energy == 0.0f) {
-                continue;
+        // skip those that have already been zeroed
+        if (energy == 0.0f) {
+            continue;
+        }
+
+        if (energy <= frame_threshold) {
+            break;
+        }
+
+        const _peak peak {energy, frame_idx, note_idx};
+        energy = 0;
+
+        // this inhibit function zeroes out neighbor notes and keeps track (with k)
+        // on how many consecutive frames were below frame_threshold.
+        auto inhibit = [frame_threshold](std::vector<std::vector<float>>& pg, int frame_i, int note_i, int k) {
+            if (pg[frame_i][note_i] < frame_threshold) {
+                k++;
+            } else {
+                k = 0;
             }
 
-            if (energy <= frame_threshold) {
-                break;
+            pg[frame_i][note_i] = 0;
+            if (note_i < MAX_NOTE_IDX) {
+                pg[frame_i][note_i + 1] = 0;
+            }
+            if (note_i > 0) {
+                pg[frame_i][note_i - 1] = 0;
             }
-            energy = 0;
+            return k;
+        };
+
+        // forward pass
+        int i = frame_idx + 1;
+        int k = 0;
+        while (i < inLastFrame && k < inParams.energyThreshold) {
+            k = inhibit(mRemainingEnergy, i, note_idx, k);
+            i++;
+        }
 
-            // this inhibit function zeroes out neighbor notes and keeps track (with k)
-            // on how many consecutive frames were below frame_threshold.
-            auto inhibit = [frame_threshold](std::vector<std::vector<float>>& pg, int frame_i, int note_i, int k) {
-                if (pg[frame_i][note_i] < frame_threshold) {
-                    k++;
-                } else {
-                    k = 0;
-                }
+        const auto i_end = i - 1 - k;
 
-                pg[frame_i][note_i] = 0;
-                if (note_i < MAX_NOTE_IDX) {
-                    pg[frame_i][note_i + 1] = 0;
-                }
-                if (note_i > 0) {
-                    pg[frame_i][note_i - 1] = 0;
-                }
-                return k;
-            };
+        // backward pass
+        i = frame_idx - 1;
+        k = 0;
+        while (i > 0 && k < inParams.energyThreshold) {
+            k = inhibit(mRemainingEnergy, i, note_idx, k);
+            i--;
+        }
 
-            // forward pass
-            int i = frame_idx + 1;
-            int k = 0;
-            while (i < last_frame && k < inParams.energyThreshold) {
-                k = inhibit(mRemainingEnergy, i, note_idx, k);
-                i++;
-            }
+        const auto i_start = i + 1 + k;
 
-            const auto i_end = i - 1 - k;
+        // if the note is too short, skip it
+        if (i_end - i_start <= inParams.minNoteLength) {
+            continue;
+        }
 
-            // backward pass
-            i = frame_idx - 1;
-            k = 0;
-            while (i > 0 && k < inParams.energyThreshold) {
-                k = inhibit(mRemainingEnergy, i, note_idx, k);
-                i--;
-            }
+        double amplitude = 0.0;
+        for (i = i_start; i < i_end; i++) {
+            amplitude += inNotesPG[i][note_idx];
+        }
+        amplitude /= (i_end - i_start);
+
+        ioEvents.push_back(Event {
+            _modelFrameToTime(i_start /* startTime */),
+            _modelFrameToTime(i_end) /* endTime */,
+            i_start /* startFrame */,
+            i_end /* endFrame */,
+            note_idx + MIDI_OFFSET /* pitch */,
+            amplitude /* amplitude */,
+        });
+
+        if (outPeaks != nullptr) {
+            outPeaks->push_back(peak);
+        }
+    }
+}
 
-            const auto i_start = i + 1 + k;
+std::vector<std::pair<int, int>>
+    Notes::_findPartitions(const ConvertParams& inParams, int inMinNoteIdx, int inMaxNoteIdx, int inLastFrame) const
+{
+    // Notes of one frame long could start in the low energy frames isolating the partitions
+    if (mNumThreads <= 1 || inParams.minNoteLength < 1 || inParams.energyThreshold < 1
+        || inLastFrame < 2 * mMinFramesPerPartition) {
+        return {{0, inLastFrame}};
+    }
 
-            // if the note is too short, skip it
-            if (i_end - i_start <= inParams.minNoteLength) {
-                continue;
+    // Two partitions per thread to balance the load
+    const int target_num_frames =
+        std::max(mMinFramesPerPartition, inLastFrame / static_cast<int>(2 * mNumThreads));
+    const int energy_threshold = inParams.energyThreshold;
+
+    std::vector<std::pair<int, int>> partitions;
+    int partition_begin = 0;
+    int low_run_begin = 0;
+    int low_run_length = 0;
+
+    for (int frame_idx = 0; frame_idx < inLastFrame; frame_idx++) {
+        const auto& energy = mRemainingEnergy[frame_idx];
+        const bool is_low =
+            std::all_of(energy.begin() + inMinNoteIdx, energy.begin() + inMaxNoteIdx + 1, [&](float inEnergy) {
+                return inEnergy < inParams.frameThreshold;
+            });
+
+        if (!is_low) {
+            low_run_length = 0;
+            continue;
+        }
+
+        if (low_run_length++ == 0) {
+            low_run_begin = frame_idx;
+        }
+
+        // Below the frame threshold, the scans of both passes stop after energyThreshold frames. Over a run of three
+        // times that, cutting after the first third, the frames read or written by each side never overlap.
+        if (low_run_length == 3 * energy_threshold) {
+            const int cut = low_run_begin + energy_threshold;
+
+            if (cut - partition_begin >= target_num_frames && inLastFrame - cut >= mMinFramesPerPartition) {
+                partitions.emplace_back(partition_begin, cut);
+                partition_begin = cut;
             }
+        }
+    }
 
-            double amplitude = 0.0;
-            for (i = i_start; i < i_end; i++) {
-                amplitude += inNotesPG[i][note_idx];
+    partitions.emplace_back(partition_begin, inLastFrame);
+
+    return partitions;
+}
+
+void Notes::_convertPartitions(const std::vector<std::pair<int, int>>& inPartitions,
+                               const std::vector<std::vector<float>>& inNotesPG,
+                               const std::vector<std::vector<float>>& inOnsets,
+                               const ConvertParams& inParams,
+                               int inMinNoteIdx,
+                               int inMaxNoteIdx,
+                               int inLastFrame,
+                               std::vector<Event>& ioEvents)
+{
+    const auto num_partitions = inPartitions.size();
+
+    std::vector<std::vector<Event>> onset_events(num_partitions);
+    std::vector<std::vector<Event>> melodia_events(num_partitions);
+    std::vector<std::vector<_peak>> melodia_peaks(num_partitions);
+
+    // All the onset notes are created before the melodia trick runs, as in the serial conversion
+    _runInParallel(num_partitions, [&](size_t inPartition) {
+        const auto [begin_frame, end_frame] = inPartitions[inPartition];
+        _addOnsetNotes(inOnsets,
+                       inParams,
+                       inMinNoteIdx,
+                       inMaxNoteIdx,
+                       begin_frame,
+                       end_frame,
+                       inLastFrame,
+                       onset_events[inPartition]);
+    });
+
+    if (inParams.melodiaTrick) {
+        _runInParallel(num_partitions, [&](size_t inPartition) {
+            const auto [begin_frame, end_frame] = inPartitions[inPartition];
+
+            // Only the energy above the threshold is ever used as a peak
+            std::vector<_pg_index> index;
+
+            for (int frame_idx = begin_frame; frame_idx < end_frame; frame_idx++) {
+                for (int note_idx = inMinNoteIdx; note_idx <= inMaxNoteIdx; note_idx++) {
+                    auto& energy = mRemainingEnergy[frame_idx][note_idx];
+
+                    if (energy > inParams.frameThreshold) {
+                        index.push_back({&energy, frame_idx, note_idx});
+                    }
+                }
             }
-            amplitude /= (i_end - i_start);
 
-            events.push_back(Event {
-                _modelFrameToTime(i_start /* startTime */),
-                _modelFrameToTime(i_end) /* endTime */,
-                i_start /* startFrame */,
-                i_end /* endFrame */,
-                note_idx + MIDI_OFFSET /* pitch */,
-                amplitude /* amplitude */,
-            });
+            std::sort(index.begin(), index.end(), _isHigherEnergy);
+
+            _addMelodiaNotes(index.begin(),
+                             index.end(),
+                             inNotesPG,
+                             inParams,
+                             inLastFrame,
+                             melodia_events[inPartition],
+                             &melodia_peaks[inPartition]);
+        });
+    }
+
+    // Same order of the events as the serial conversion, so that sorting them gives the same result:
+    // onset notes backwards in time, then melodia notes by decreasing peak energy.
+    for (auto partition = num_partitions; partition-- > 0;) {
+        ioEvents.insert(ioEvents.end(), onset_events[partition].begin(), onset_events[partition].end());
+    }
+
+    std::vector<std::pair<_peak, const Event*>> all_melodia_events;
+
+    for (size_t partition = 0; partition < num_partitions; partition++) {
+        for (size_t i = 0; i < melodia_events[partition].size(); i++) {
+            all_melodia_events.emplace_back(melodia_peaks[partition][i], &melodia_events[partition][i]);
         }
     }
 
-    sortEvents(events);
+    std::sort(all_melodia_events.begin(), all_melodia_events.end(), [](const auto& a, const auto& b) {
+        return _isHigherPeak(a.first, b.first);
+    });
 
-    if (inParams.pitchBend != NoPitchBend) {
-        _addPitchBends(events, inContoursPG);
-        if (inParams.pitchBend == SinglePitchBend) {
-            dropOverlappingPitchBends(events);
+    for (const auto& [peak, event]: all_melodia_events) {
+        ioEvents.push_back(*event);
+    }
+}
+
+void Notes::_runInParallel(size_t inNumTasks, const std::function<void(size_t)>& inTask) const
+{
+    mWorkerPool->runInParallel(inNumTasks, mNumThreads, inTask);
+}
+
+void Notes::prepareNewAudio(size_t inNumFrames)
+{
+    mPitchBendsCache.clear();
+
+    mRemainingEnergy.assign(inNumFrames, std::vector<float>(NUM_FREQ_OUT, 0.0f));
+
+    // prepareFrames appends to it while the CNN runs: reserve for the whole file so it is never reallocated
+    mRemainingEnergyIndex.clear();
+    mRemainingEnergyIndex.reserve(inNumFrames * NUM_FREQ_OUT);
+
+    // Initialized to 1 to not interfere with the minima, the note posteriorgrams being probabilities < 1
+    mInferredOnsets.assign(inNumFrames, std::vector<float>(NUM_FREQ_OUT, 1.0f));
+    mMaxOnset = 0.0f;
+    mMaxMinNotesDiff = 0.0f;
+
+    mNumPreparedFrames = 0;
+}
+
+void Notes::prepareFrames(const std::vector<std::vector<float>>& inNotesPG,
+                          const std::vector<std::vector<float>>& inOnsetsPG,
+                          size_t inBeginFrame,
+                          size_t inEndFrame)
+{
+    assert(inBeginFrame == mNumPreparedFrames && inEndFrame <= mInferredOnsets.size());
+
+    // Maximum offset between the frames compared to infer onsets
+    constexpr int num_diffs = 2;
+
+    for (size_t f = inBeginFrame; f < inEndFrame; f++) {
+        const int frame_idx = static_cast<int>(f);
+
+        for (int note_idx = 0; note_idx < NUM_FREQ_OUT; note_idx++) {
+            mRemainingEnergyIndex.push_back({&mRemainingEnergy[f][static_cast<size_t>(note_idx)], frame_idx, note_idx});
+        }
+
+        // Minimum over the offsets of the increase of the note posteriorgrams since the frame behind by offset
+        for (int offset = 1; offset <= num_diffs; offset++) {
+            const int frame_behind = frame_idx - offset;
+
+            for (int note_idx = 0; note_idx < NUM_FREQ_OUT; note_idx++) {
+                auto diff = inNotesPG[f][note_idx] - ((frame_behind >= 0) ? inNotesPG[frame_behind][note_idx] : 0);
+
+                // Basic Pitch calculates the minimum amongst positive and negative diffs instead of ignoring negative
+                // diffs (which mean "end of note") while we are only looking for "start of note" (aka onset).
+                // TODO: the zeroing of negative diff should probably happen before searching for minimum
+                auto& min = mInferredOnsets[f][note_idx];
+                if (diff < min) {
+                    diff = (diff < 0) ? 0 : diff;
+                    // https://github.com/spotify/basic-pitch/blob/86fc60dab06e3115758eb670c92ead3b62a89b47/basic_pitch/note_creation.py#L298
+                    min = (frame_idx >= num_diffs) ? diff : 0;
+                }
+            }
+        }
+
+        for (int note_idx = 0; note_idx < NUM_FREQ_OUT; note_idx++) {
+            mMaxOnset = std::max(mMaxOnset, inOnsetsPG[f][note_idx]);
+            mMaxMinNotesDiff = std::max(mMaxMinNotesDiff, mInferredOnsets[f][note_idx]);
         }
     }
 
-    return events;
+    mNumPreparedFrames = inEndFrame;
+
+    if (mNumPreparedFrames < mInferredOnsets.size()) {
+        return;
+    }
+
+    // Rescale the increases to the scale of the original onsets and take the element-wise max with them
+    for (size_t f = 0; f < mInferredOnsets.size(); f++) {
+        for (int note_idx = 0; note_idx < NUM_FREQ_OUT; note_idx++) {
+            auto& inferred = mInferredOnsets[f][note_idx];
+            inferred = mMaxOnset * inferred / mMaxMinNotesDiff;
+            inferred = std::max(inferred, inOnsetsPG[f][note_idx]);
+        }
+    }
 }
 
 void Notes::clear()
@@ -241,13 +577,46 @@ void Notes::clear()
 
     mRemainingEnergyIndex.clear();
     mRemainingEnergyIndex.shrink_to_fit();
+
+    mInferredOnsets.clear();
+    mInferredOnsets.shrink_to_fit();
+
+    mPitchBendsCache.clear();
+
+    mNumPreparedFrames = 0;
+}
+
+size_t Notes::getScratchSizeInBytes() const
+{
+    size_t num_bytes = ResourceStats::getAllocatedBytes(mRemainingEnergy)
+                       + ResourceStats::getAllocatedBytes(mRemainingEnergyIndex)
+                       + ResourceStats::getAllocatedBytes(mInferredOnsets);
+
+    for (const auto& [key, bends]: mPitchBendsCache) {
+        num_bytes += sizeof(key) + sizeof(bends) + ResourceStats::getAllocatedBytes(bends);
+    }
+
+    return num_bytes;
 }
 
 void Notes::_addPitchBends(std::vector<Event>& inOutEvents,
                            const std::vector<std::vector<float>>& inContoursPG,
                            int inNumBinsTolerance)
 {
+    // The bends of a note only depend on its frames and pitch: notes left unchanged by a parameter update reuse them.
+    // Only the bends of the current notes are kept so that the cache does not grow with the updates.
+    std::unordered_map<uint64_t, std::vector<int>> pitch_bends_cache;
+    pitch_bends_cache.reserve(inOutEvents.size());
+
     for (auto& event: inOutEvents) {
+        const auto key = _getPitchBendsKey(event);
+
+        if (auto cached = mPitchBendsCache.find(key); cached != mPitchBendsCache.end()) {
+            event.bends = cached->second;
+            pitch_bends_cache.emplace(key, std::move(cached->second));
+            continue;
+        }
+
         // midi_pitch_to_contour_bin
         int note_idx =
             CONTOURS_BINS_PER_SEMITONE
@@ -280,5 +649,9 @@ void Notes::_addPitchBends(std::vector<Event>& inOutEvents,
             }
             event.bends.emplace_back(bend - pb_shift);
         }
+
+        pitch_bends_cache.emplace(key, event.bends);
     }
+
+    mPitchBendsCache = std::move(pitch_bends_cache);
 }
\ No newline at end of file
@@ -5,12 +5,20 @@
 #ifndef Notes_h
 #define Notes_h
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "BasicPitchConstants.h"
-#include "NoteUtils.h"
+#include "NoteUtilsCore.h"
+#include "WorkerPool.h"
 
 enum PitchBendModes { NoPitchBend = 0, SinglePitchBend, MultiPitchBend };
 
@@ -63,11 +71,46 @@ public:
                                const ConvertParams& inParams,
                                bool inNewAudio);
 
+    /**
+     * Start preparing the conversion of new audio while its posteriorgrams are still being computed. The frames are
+     * then given in order to prepareFrames, from any single thread, and convert is called with inNewAudio = false once
+     * all of them are prepared. The events are the same as with convert and inNewAudio = true.
+     * @param inNumFrames Number of frames of the posteriorgrams
+     */
+    void prepareNewAudio(size_t inNumFrames);
+
+    /**
+     * Do the work of convert that only depends on past frames (buffer allocation, inferred onsets) for new frames.
+     * @param inNotesPG Note posteriorgrams. Frames before inEndFrame must be final.
+     * @param inOnsetsPG Onset posteriorgrams. Frames before inEndFrame must be final.
+     * @param inBeginFrame First frame to prepare, the end of the previous call
+     * @param inEndFrame End of the frames to prepare (exclusive)
+     */
+    void prepareFrames(const std::vector<std::vector<float>>& inNotesPG,
+                       const std::vector<std::vector<float>>& inOnsetsPG,
+                       size_t inBeginFrame,
+                       size_t inEndFrame);
+
+    /**
+     * Number of threads used by convert, 1 (default) to run on the calling thread only. With more, the timeline is
+     * partitioned at runs of frames below the frame threshold, long enough for notes on both sides to never reach
+     * each other, and the onset notes and the melodia trick run per partition on the worker pool. Audio shorter than
+     * two partitions is converted on the calling thread. The events are the same as with one thread.
+     * @param inNumThreads Maximum number of threads, including the calling one
+     * @param inMinFramesPerPartition Partitions shorter than this are not worth a thread
+     */
+    void setNumThreads(size_t inNumThreads, int inMinFramesPerPartition = 2000);
+
     /**
      * Release any memory allocated by the class.
      */
     void clear();
 
+    /**
+     * @return Bytes allocated by the buffers kept between calls to convert.
+     */
+    size_t getScratchSizeInBytes() const;
+
     /**
      * Inplace sort of note events.
      * @param inOutEvents
@@ -128,14 +171,122 @@ public:
         }
     }
 
+    /**
+     * Changes between two note event vectors, e.g. before and after a parameter update.
+     */
+    typedef struct EventsDiff {
+        std::vector<Event> added;
+        std::vector<Event> removed;
+        // Pairs of previous and new versions of events with same start frame and pitch but other differences.
+        std::vector<std::pair<Event, Event>> modified;
+
+        // Bounds of all the events above, valid only if the diff is not empty.
+        double minTime = 0.0;
+        double maxTime = 0.0;
+        int minPitch = 0;
+        int maxPitch = 0;
+
+        bool isEmpty() const { return added.empty() && removed.empty() && modified.empty(); }
+
+        size_t getNumChanges() const { return added.size() + removed.size() + modified.size(); }
+    } EventsDiff;
+
+    /**
+     * Compute the changes needed to go from inPrevious to inNew. Order of the input vectors does not matter.
+     * @param inPrevious Previous note events.
+     * @param inNew New note events.
+     * @return Added, removed and modified events with their time and pitch bounds.
+     */
+    static EventsDiff computeEventsDiff(const std::vector<Event>& inPrevious, const std::vector<Event>& inNew);
+
 private:
+    struct _pg_index {
+        float* value;
+        int frameIdx;
+        int noteIdx;
+    };
+
+    // Energy of a melodia peak when it was sorted, to order the notes of different partitions
+    struct _peak {
+        float value;
+        int frameIdx;
+        int noteIdx;
+    };
+
+    /**
+     * Order of the melodia trick: decreasing energy, then by frame and note so that ties are always in the same order.
+     */
+    static inline bool _isHigherPeak(const _peak& a, const _peak& b)
+    {
+        return a.value > b.value
+               || (a.value == b.value && std::tie(a.frameIdx, a.noteIdx) < std::tie(b.frameIdx, b.noteIdx));
+    }
+
+    static inline bool _isHigherEnergy(const _pg_index& a, const _pg_index& b)
+    {
+        return _isHigherPeak({*a.value, a.frameIdx, a.noteIdx}, {*b.value, b.frameIdx, b.noteIdx});
+    }
+
+    /**
+     * Create the notes starting at an onset in [inBeginFrame, inEndFrame), going backwards in time, and remove their
+     * energy from mRemainingEnergy.
+     */
+    void _addOnsetNotes(const std::vector<std::vector<float>>& inOnsets,
+                        const ConvertParams& inParams,
+                        int inMinNoteIdx,
+                        int inMaxNoteIdx,
+                        int inBeginFrame,
+                        int inEndFrame,
+                        int inLastFrame,
+                        std::vector<Event>& ioEvents);
+
     /**
-     * Add pitch bend vector to note events.
+     * Melodia trick: create notes around the energy left by the onset notes, from the highest peak down to the frame
+     * threshold.
+     * @param inBegin Begin of the index of the energy to go through, sorted with _isHigherEnergy
+     * @param inEnd End of the index
+     * @param outPeaks If not null, the peak of each created note is added to it
+     */
+    void _addMelodiaNotes(std::vector<_pg_index>::iterator inBegin,
+                          std::vector<_pg_index>::iterator inEnd,
+                          const std::vector<std::vector<float>>& inNotesPG,
+                          const ConvertParams& inParams,
+                          int inLastFrame,
+                          std::vector<Event>& ioEvents,
+                          std::vector<_peak>* outPeaks);
+
+    /**
+     * @return Frame ranges to convert in parallel, covering [0, inLastFrame). A single one if not worth it.
+     */
+    std::vector<std::pair<int, int>>
+        _findPartitions(const ConvertParams& inParams, int inMinNoteIdx, int inMaxNoteIdx, int inLastFrame) const;
+
+    /**
+     * Same as the serial conversion before the pitch bends, with each step run in parallel over the partitions.
+     */
+    void _convertPartitions(const std::vector<std::pair<int, int>>& inPartitions,
+                            const std::vector<std::vector<float>>& inNotesPG,
+                            const std::vector<std::vector<float>>& inOnsets,
+                            const ConvertParams& inParams,
+                            int inMinNoteIdx,
+                            int inMaxNoteIdx,
+                            int inLastFrame,
+                            std::vector<Event>& ioEvents);
+
+    /**
+     * Run inTask(0) to inTask(inNumTasks - 1) over up to mNumThreads threads of the worker pool shared by the
+     * instances, including the calling one, and wait for all of them.
+     */
+    void _runInParallel(size_t inNumTasks, const std::function<void(size_t)>& inTask) const;
+
+    /**
+     * Add pitch bend vector to note events. Bends of notes already present in the previous call for the same audio are
+     * taken from mPitchBendsCache instead of scanning the contours again.
      * @param inOutEvents event vector (input and output)
      * @param inContoursPG Contour posteriorgram matrix
      * @param inNumBinsTolerance
      */
-    static void _addPitchBends(std::vector<Notes::Event>& inOutEvents,
+    void _addPitchBends(std::vector<Notes::Event>& inOutEvents,
                                const std::vector<std::vector<float>>& inContoursPG,
                                int inNumBinsTolerance = 25);
 
@@ -168,98 +319,33 @@ private:
     }
 
     /**
-     * Returns a version of inOnsetsPG augmented by detecting differences in note posteriorgrams
-     * across frames separated by varying offsets (up to inNumDiffs).
-     * @tparam T
-     * @param inOnsetsPG Onset posteriorgrams
-     * @param inNotesPG Note posteriorgrams
-     * @param inNumDiffs max varying offset.
-     * @return
+     * @return Identity of a note for the pitch bends cache: its start and end frames and its pitch.
+     * Unique as long as the end frame is below 2^25 (several days of audio).
      */
-    // TODO: change to float
-    template <typename T>
-    static std::vector<std::vector<T>> _inferredOnsets(const std::vector<std::vector<T>>& inOnsetsPG,
-                                                       const std::vector<std::vector<T>>& inNotesPG,
-                                                       int inNumDiffs = 2)
+    static inline uint64_t _getPitchBendsKey(const Event& inEvent)
     {
-        auto n_frames = inNotesPG.size();
-        auto n_notes = inNotesPG[0].size();
-
-        // The algorithm starts by calculating a diff of note posteriorgrams, hence the name notes_diff.
-        // This same variable will later morph into the inferred onsets output
-        // notes_diff needs to be initialized to all 1 to not interfere with minima
-        // calculations, assuming all values in inNotesPG are probabilities < 1.
-        auto notes_diff = std::vector<std::vector<T>>(n_frames, std::vector<T>(n_notes, 1));
-
-        // max of minima of notes_diff
-        T max_min_notes_diff = 0;
-        // max of onsets
-        T max_onset = 0;
-
-        // for each frame offset
-        for (int n = 0; n < inNumDiffs; n++) {
-            auto offset = n + 1;
-            // for each frame
-            for (int i = 0; i < n_frames; i++) {
-                // frame index slided back by offset
-                auto i_behind = i - offset;
-                // for each note
-                for (int j = 0; j < n_notes; j++) {
-                    // calculate the difference in note probabilities between frame i and
-                    // frame i_behind (the frame behind by offset).
-                    auto diff = inNotesPG[i][j] - ((i_behind >= 0) ? inNotesPG[i_behind][j] : 0);
-
-                    // Basic Pitch calculates the minimum amongst positive and negative
-                    // diffs instead of ignoring negative diffs (which mean "end of note")
-                    // while we are only looking for "start of note" (aka onset).
-                    // TODO: the zeroing of negative diff should probably happen before
-                    // searching for minimum
-                    auto& min = notes_diff[i][j];
-                    if (diff < min) {
-                        diff = (diff < 0) ? 0 : diff;
-                        // https://github.com/spotify/basic-pitch/blob/86fc60dab06e3115758eb670c92ead3b62a89b47/basic_pitch/note_creation.py#L298
-                        min = (i >= inNumDiffs) ? diff : 0;
-                    }
-
-                    // if last diff, max_min_notes_diff can be computed
-                    if (offset == inNumDiffs) {
-                        auto onset = inOnsetsPG[i][j];
-                        if (onset > max_onset) {
-                            max_onset = onset;
-                        }
-                        if (min > max_min_notes_diff) {
-                            max_min_notes_diff = min;
-                        }
-                    }
-                }
-            }
-        }
-
-        // Rescale notes_diff in-place to match scale of original onsets
-        // and choose the element-wise max between it and the original onsets.
-        // This is where notes_diff morphs truly into the inferred onsets.
-        for (int i = 0; i < n_frames; i++) {
-            for (int j = 0; j < n_notes; j++) {
-                auto& inferred = notes_diff[i][j];
-                inferred = max_onset * inferred / max_min_notes_diff;
-                auto orig = inOnsetsPG[i][j];
-                if (orig > inferred) {
-                    inferred = orig;
-                }
-            }
-        }
-
-        return notes_diff;
+        return (static_cast<uint64_t>(inEvent.startFrame) << 32) | (static_cast<uint64_t>(inEvent.endFrame) << 7)
+               | static_cast<uint64_t>(inEvent.pitch & 0x7F);
     }
 
-    struct _pg_index {
-        float* value;
-        int frameIdx;
-        int noteIdx;
-    };
-
     std::vector<std::vector<float>> mRemainingEnergy;
     std::vector<_pg_index> mRemainingEnergyIndex;
+
+    // Onsets augmented by detecting increases of the note posteriorgrams, as in basic-pitch. Depend on the
+    // posteriorgrams only, so they are kept while the parameters change.
+    std::vector<std::vector<float>> mInferredOnsets;
+    // Maximum of the onsets and of the note posteriorgram increases, to rescale the increases once all frames are known
+    float mMaxOnset = 0.0f;
+    float mMaxMinNotesDiff = 0.0f;
+    size_t mNumPreparedFrames = 0;
+
+    size_t mNumThreads = 1;
+    int mMinFramesPerPartition = 2000;
+    // Held so that the workers are stopped with the last instance
+    std::shared_ptr<WorkerPool> mWorkerPool = WorkerPool::getInstance();
+
+    // Pitch bends of the notes returned by the last convert, by _getPitchBendsKey. Cleared for new audio.
+    std::unordered_map<uint64_t, std::vector<int>> mPitchBendsCache;
 };
 
 #endif // Notes_h
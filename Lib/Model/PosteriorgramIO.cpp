@@ -0,0 +1,71 @@
+#include "PosteriorgramIO.h"
+#include "NpyIO.h"
+
+namespace PosteriorgramIO
+{
+
+namespace
+{
+std::string getFilePath(const std::string& inDirectory, const char* inFileName)
+{
+    if (inDirectory.empty() || inDirectory.back() == '/' || inDirectory.back() == '\\') {
+        return inDirectory + inFileName;
+    }
+
+    return inDirectory + "/" + inFileName;
+}
+
+bool loadMatrix(const std::string& inDirectory,
+                const char* inFileName,
+                size_t inExpectedNumColumns,
+                std::vector<std::vector<float>>& outMatrix,
+                std::string& outError)
+{
+    size_t num_columns = 0;
+
+    if (!NpyIO::readMatrix(getFilePath(inDirectory, inFileName), outMatrix, num_columns, outError)) {
+        return false;
+    }
+
+    if (num_columns != inExpectedNumColumns) {
+        outError = std::string(inFileName) + " has " + std::to_string(num_columns) + " columns, expected "
+                   + std::to_string(inExpectedNumColumns);
+        return false;
+    }
+
+    return true;
+}
+} // namespace
+
+bool save(const BasicPitch::Posteriorgrams& inPosteriorgrams, const std::string& inDirectory, std::string& outError)
+{
+    return NpyIO::writeMatrix(
+               getFilePath(inDirectory, CONTOURS_FILE_NAME), inPosteriorgrams.contours, NUM_FREQ_IN, outError)
+           && NpyIO::writeMatrix(
+               getFilePath(inDirectory, NOTES_FILE_NAME), inPosteriorgrams.notes, NUM_FREQ_OUT, outError)
+           && NpyIO::writeMatrix(
+               getFilePath(inDirectory, ONSETS_FILE_NAME), inPosteriorgrams.onsets, NUM_FREQ_OUT, outError);
+}
+
+bool load(const std::string& inDirectory, BasicPitch::Posteriorgrams& outPosteriorgrams, std::string& outError)
+{
+    BasicPitch::Posteriorgrams posteriorgrams;
+
+    if (!loadMatrix(inDirectory, CONTOURS_FILE_NAME, NUM_FREQ_IN, posteriorgrams.contours, outError)
+        || !loadMatrix(inDirectory, NOTES_FILE_NAME, NUM_FREQ_OUT, posteriorgrams.notes, outError)
+        || !loadMatrix(inDirectory, ONSETS_FILE_NAME, NUM_FREQ_OUT, posteriorgrams.onsets, outError)) {
+        return false;
+    }
+
+    if (posteriorgrams.contours.size() != posteriorgrams.notes.size()
+        || posteriorgrams.onsets.size() != posteriorgrams.notes.size()) {
+        outError = "The posteriorgrams do not have the same number of frames";
+        return false;
+    }
+
+    outPosteriorgrams = std::move(posteriorgrams);
+
+    return true;
+}
+
+} // namespace PosteriorgramIO
@@ -0,0 +1,40 @@
+#ifndef PosteriorgramIO_h
+#define PosteriorgramIO_h
+
+#include <string>
+
+#include "BasicPitch.h"
+
+/**
+ * Save and load the three posteriorgrams of BasicPitch as contours.npy (frames x 264), notes.npy (frames x 88) and
+ * onsets.npy (frames x 88) in a directory, to run note creation offline (e.g. in Python) without running the model
+ * again, or to create notes from posteriorgrams computed elsewhere.
+ */
+namespace PosteriorgramIO
+{
+
+constexpr const char* CONTOURS_FILE_NAME = "contours.npy";
+constexpr const char* NOTES_FILE_NAME = "notes.npy";
+constexpr const char* ONSETS_FILE_NAME = "onsets.npy";
+
+/**
+ * Write the posteriorgrams to an existing directory.
+ * @param inPosteriorgrams Posteriorgrams to write
+ * @param inDirectory Path of the directory
+ * @param outError Set to the reason of the failure if false is returned
+ * @return Whether the three files were written
+ */
+bool save(const BasicPitch::Posteriorgrams& inPosteriorgrams, const std::string& inDirectory, std::string& outError);
+
+/**
+ * Read posteriorgrams written by save (or by numpy.save with the same shapes).
+ * @param inDirectory Path of the directory
+ * @param outPosteriorgrams Loaded posteriorgrams
+ * @param outError Set to the reason of the failure if false is returned
+ * @return Whether the three files were read and have consistent shapes
+ */
+bool load(const std::string& inDirectory, BasicPitch::Posteriorgrams& outPosteriorgrams, std::string& outError);
+
+} // namespace PosteriorgramIO
+
+#endif // PosteriorgramIO_h
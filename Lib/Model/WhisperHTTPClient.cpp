@@ -1,34 +1,418 @@
 #include "WhisperHTTPClient.h"
 
+#if JUCE_MAC || JUCE_LINUX
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define NN_HAS_UNIX_SOCKETS 1
+#else
+#define NN_HAS_UNIX_SOCKETS 0
+#endif
+
+namespace
+{
+const juce::String unixScheme = "unix://";
+const juce::String socketFileName = "neuralnote-whisper.sock";
+
+/** Status code of an HTTP status line such as "HTTP/1.1 200 OK", or -1 if invalid */
+int parseStatusCode(const juce::String& inStatusLine)
+{
+    if (!inStatusLine.startsWith("HTTP/"))
+        return -1;
+
+    auto code = inStatusLine.fromFirstOccurrenceOf(" ", false, false).upToFirstOccurrenceOf(" ", false, false);
+    return code.containsOnly("0123456789") && code.isNotEmpty() ? code.getIntValue() : -1;
+}
+
+#if NN_HAS_UNIX_SOCKETS
+#if JUCE_LINUX
+constexpr int sendFlags = MSG_NOSIGNAL;
+#else
+constexpr int sendFlags = 0;
+#endif
+
+/** Closes the socket when going out of scope */
+struct ScopedSocket {
+    explicit ScopedSocket(int inFd)
+        : fd(inFd)
+    {
+    }
+
+    ~ScopedSocket()
+    {
+        if (fd >= 0)
+            ::close(fd);
+    }
+
+    int fd;
+};
+
+/** Waits in short slices, so that an abort does not have to wait for the timeout */
+bool waitForSocket(int inFd, short inEvents, int inTimeoutMs, const std::atomic<bool>& inShouldAbort)
+{
+    constexpr int slice_ms = 100;
+
+    for (int waited_ms = 0; waited_ms < inTimeoutMs && !inShouldAbort; waited_ms += slice_ms) {
+        pollfd pfd {inFd, inEvents, 0};
+        if (::poll(&pfd, 1, std::min(slice_ms, inTimeoutMs - waited_ms)) > 0)
+            return true;
+    }
+
+    return false;
+}
+
+int connectUnixSocket(const juce::String& inPath)
+{
+    sockaddr_un address {};
+
+    if (inPath.getNumBytesAsUTF8() >= sizeof(address.sun_path))
+        return -1;
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+
+#if JUCE_MAC
+    // Report a closed connection as an error instead of raising SIGPIPE
+    int no_sigpipe = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe, sizeof(no_sigpipe));
+#endif
+
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, inPath.toRawUTF8(), sizeof(address.sun_path) - 1);
+
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+/** Index of the first occurrence of inPattern in inData at or after inStart, or -1 */
+int findBytes(const char* inData, size_t inSize, size_t inStart, const char* inPattern)
+{
+    const auto pattern_size = std::strlen(inPattern);
+
+    for (size_t i = inStart; i + pattern_size <= inSize; i++) {
+        if (std::memcmp(inData + i, inPattern, pattern_size) == 0)
+            return static_cast<int>(i);
+    }
+
+    return -1;
+}
+
+/**
+ * Decode a body sent with Transfer-Encoding: chunked. Chunk sizes are in bytes, so this is done on the raw bytes
+ * before the UTF-8 conversion.
+ */
+juce::MemoryBlock decodeChunkedBody(const char* inBody, size_t inSize)
+{
+    juce::MemoryBlock decoded;
+    size_t position = 0;
+
+    while (position < inSize) {
+        auto size_end = findBytes(inBody, inSize, position, "\r\n");
+        if (size_end < 0)
+            break;
+
+        // Chunk extensions after ';' are ignored
+        auto size_line = juce::String::fromUTF8(inBody + position, size_end - static_cast<int>(position));
+        auto chunk_size = static_cast<size_t>(size_line.upToFirstOccurrenceOf(";", false, false).getHexValue64());
+        auto chunk_start = static_cast<size_t>(size_end) + 2;
+
+        if (chunk_size == 0 || chunk_start + chunk_size > inSize)
+            break;
+
+        decoded.append(inBody + chunk_start, chunk_size);
+        position = chunk_start + chunk_size + 2;
+    }
+
+    return decoded;
+}
+
+/** True if inPath is a socket owned by the current user, in a directory owned by the current user */
+bool isOwnSocket(const juce::String& inPath)
+{
+    struct stat socket_stat {};
+    struct stat dir_stat {};
+
+    if (::lstat(inPath.toRawUTF8(), &socket_stat) != 0
+        || ::stat(juce::File(inPath).getParentDirectory().getFullPathName().toRawUTF8(), &dir_stat) != 0)
+        return false;
+
+    return S_ISSOCK(socket_stat.st_mode) && socket_stat.st_uid == ::getuid() && dir_stat.st_uid == ::getuid();
+}
+#endif
+} // namespace
+
 WhisperHTTPClient::WhisperHTTPClient(const juce::String& serviceUrl)
     : mServiceUrl(serviceUrl)
 {
     if (mServiceUrl.endsWithChar('/')) {
         mServiceUrl = mServiceUrl.dropLastCharacters(1);
     }
+
+    if (mServiceUrl.startsWithIgnoreCase(unixScheme)) {
+        mSocketPath = mServiceUrl.substring(unixScheme.length());
+    }
 }
 
-bool WhisperHTTPClient::isServiceAvailable()
+juce::String WhisperHTTPClient::getDefaultServiceUrl()
 {
-    return sendHealthCheck();
+    auto env_url = juce::SystemStats::getEnvironmentVariable("NEURALNOTE_WHISPER_SERVICE_URL", {});
+    if (env_url.isNotEmpty()) {
+        return env_url;
+    }
+
+#if NN_HAS_UNIX_SOCKETS
+    // A socket left by a crashed service must not disable the TCP fallback: only use it if a service listens on it
+    auto socket_path = getDefaultSocketPath();
+
+    if (socket_path.isNotEmpty() && isOwnSocket(socket_path)) {
+        ScopedSocket socket(connectUnixSocket(socket_path));
+
+        if (socket.fd >= 0) {
+            return unixScheme + socket_path;
+        }
+    }
+#endif
+
+    return "http://127.0.0.1:8765";
 }
 
-bool WhisperHTTPClient::sendHealthCheck()
+juce::String WhisperHTTPClient::getDefaultSocketPath()
 {
-    try {
-        juce::URL healthUrl(mServiceUrl + "/health");
+#if JUCE_LINUX
+    auto runtime_dir = juce::SystemStats::getEnvironmentVariable("XDG_RUNTIME_DIR", {});
+#elif JUCE_MAC
+    auto runtime_dir = juce::SystemStats::getEnvironmentVariable("TMPDIR", {});
+#else
+    juce::String runtime_dir;
+#endif
+
+    if (runtime_dir.isEmpty() || !juce::File::isAbsolutePath(runtime_dir)) {
+        return {};
+    }
+
+    return juce::File(runtime_dir).getChildFile(socketFileName).getFullPathName();
+}
+
+bool WhisperHTTPClient::sendRequest(const juce::String& path,
+                                    const juce::String* postData,
+                                    int timeoutMs,
+                                    juce::String& outResponse)
+{
+    if (mShouldAbort) {
+        mLastError = "Whisper service request aborted";
+        return false;
+    }
+
+    if (usesUnixSocket()) {
+        return sendUnixSocketRequest(path, postData, timeoutMs, outResponse);
+    }
+
+    juce::URL url(mServiceUrl + path);
+
+    if (postData != nullptr) {
+        url = url.withPOSTData(juce::MemoryBlock(postData->toRawUTF8(), postData->getNumBytesAsUTF8()));
+    }
+
+    juce::WebInputStream stream(url, postData != nullptr);
+    stream.withConnectionTimeout(timeoutMs);
+
+    if (postData != nullptr) {
+        stream.withExtraHeaders("Content-Type: application/json");
+    }
+
+    // Published so that abort can cancel the blocking connect and read from another thread
+    {
+        const juce::ScopedLock lock(mActiveStreamLock);
+
+        if (mShouldAbort) {
+            mLastError = "Whisper service request aborted";
+            return false;
+        }
+
+        mActiveStream = &stream;
+    }
 
-        auto options = juce::URL::InputStreamOptions(juce::URL::ParameterHandling::inAddress)
-                          .withConnectionTimeoutMs(5000);
+    const bool is_connected = stream.connect(nullptr);
+    if (is_connected) {
+        outResponse = stream.readEntireStreamAsString();
+    }
+
+    {
+        const juce::ScopedLock lock(mActiveStreamLock);
+        mActiveStream = nullptr;
+    }
+
+    if (mShouldAbort) {
+        mLastError = "Whisper service request aborted";
+        return false;
+    }
+
+    if (!is_connected) {
+        mLastError = "Failed to connect to Whisper service at " + mServiceUrl;
+        return false;
+    }
+
+    return checkStatusCode(stream.getStatusCode(), outResponse);
+}
+
+void WhisperHTTPClient::abort()
+{
+    const juce::ScopedLock lock(mActiveStreamLock);
+    mShouldAbort = true;
+
+    if (mActiveStream != nullptr) {
+        mActiveStream->cancel();
+    }
+}
+
+bool WhisperHTTPClient::checkStatusCode(int statusCode, const juce::String& response)
+{
+    if (statusCode >= 200 && statusCode < 300) {
+        return true;
+    }
+
+    mLastError = "Whisper service returned HTTP " + juce::String(statusCode);
+
+    // The service reports the reason in the body, e.g. {"status": "error", "message": "Model not initialized"}
+    auto json = juce::JSON::parse(response);
+    auto message = json.getProperty("error", json.getProperty("message", {})).toString();
+
+    if (message.isNotEmpty()) {
+        mLastError << ": " << message;
+    }
+
+    return false;
+}
+
+bool WhisperHTTPClient::sendUnixSocketRequest(const juce::String& path,
+                                              const juce::String* postData,
+                                              int timeoutMs,
+                                              juce::String& outResponse)
+{
+#if NN_HAS_UNIX_SOCKETS
+    ScopedSocket socket(connectUnixSocket(mSocketPath));
+
+    if (socket.fd < 0) {
+        mLastError = "Failed to connect to Whisper service socket at " + mSocketPath;
+        return false;
+    }
+
+    juce::String request;
+    request << (postData != nullptr ? "POST " : "GET ") << path << " HTTP/1.1\r\n"
+            << "Host: localhost\r\n"
+            << "Connection: close\r\n";
+
+    if (postData != nullptr) {
+        request << "Content-Type: application/json\r\n"
+                << "Content-Length: " << juce::String(postData->getNumBytesAsUTF8()) << "\r\n";
+    }
+
+    request << "\r\n";
+
+    juce::MemoryBlock data(request.toRawUTF8(), request.getNumBytesAsUTF8());
+    if (postData != nullptr) {
+        data.append(postData->toRawUTF8(), postData->getNumBytesAsUTF8());
+    }
+
+    // Send the whole request
+    size_t num_sent = 0;
+    while (num_sent < data.getSize()) {
+        if (!waitForSocket(socket.fd, POLLOUT, timeoutMs, mShouldAbort)) {
+            mLastError =
+                mShouldAbort ? "Whisper service request aborted" : "Timed out sending request to Whisper service";
+            return false;
+        }
+
+        auto sent = ::send(
+            socket.fd, static_cast<const char*>(data.getData()) + num_sent, data.getSize() - num_sent, sendFlags);
+        if (sent <= 0) {
+            mLastError = "Failed to send request to Whisper service";
+            return false;
+        }
+
+        num_sent += static_cast<size_t>(sent);
+    }
 
-        std::unique_ptr<juce::InputStream> stream(healthUrl.createInputStream(options));
+    // Read until the server closes the connection
+    juce::MemoryOutputStream received;
+    char buffer[16384];
 
-        if (stream == nullptr) {
-            mLastError = "Failed to connect to Whisper service at " + mServiceUrl;
+    while (true) {
+        if (!waitForSocket(socket.fd, POLLIN, timeoutMs, mShouldAbort)) {
+            mLastError =
+                mShouldAbort ? "Whisper service request aborted" : "Timed out waiting for Whisper service response";
             return false;
         }
 
-        juce::String response = stream->readEntireStreamAsString();
+        auto num_read = ::recv(socket.fd, buffer, sizeof(buffer), 0);
+        if (num_read < 0) {
+            mLastError = "Failed to read Whisper service response";
+            return false;
+        }
+
+        if (num_read == 0)
+            break;
+
+        received.write(buffer, static_cast<size_t>(num_read));
+    }
+
+    // Split the headers from the body on the raw bytes: lengths in the body are byte counts
+    const auto* response = static_cast<const char*>(received.getData());
+    const auto response_size = received.getDataSize();
+    auto header_end = findBytes(response, response_size, 0, "\r\n\r\n");
+
+    if (header_end < 0) {
+        mLastError = "Invalid HTTP response from Whisper service";
+        return false;
+    }
+
+    auto headers = juce::String::fromUTF8(response, header_end);
+    auto status_code = parseStatusCode(headers.upToFirstOccurrenceOf("\r\n", false, false));
+
+    if (status_code < 0) {
+        mLastError = "Invalid HTTP response from Whisper service";
+        return false;
+    }
+
+    const auto* body = response + header_end + 4;
+    const auto body_size = response_size - static_cast<size_t>(header_end) - 4;
+
+    if (headers.containsIgnoreCase("Transfer-Encoding: chunked")) {
+        auto decoded = decodeChunkedBody(body, body_size);
+        outResponse = juce::String::fromUTF8(static_cast<const char*>(decoded.getData()),
+                                             static_cast<int>(decoded.getSize()));
+    } else {
+        outResponse = juce::String::fromUTF8(body, static_cast<int>(body_size));
+    }
+
+    return checkStatusCode(status_code, outResponse);
+#else
+    juce::ignoreUnused(path, postData, timeoutMs, outResponse);
+    mLastError = "Unix domain sockets are not supported on this platform";
+    return false;
+#endif
+}
+
+bool WhisperHTTPClient::isServiceAvailable()
+{
+    return sendHealthCheck();
+}
+
+bool WhisperHTTPClient::sendHealthCheck()
+{
+    try {
+        juce::String response;
+        if (!sendRequest("/health", nullptr, 5000, response)) {
+            return false;
+        }
 
         auto json = juce::JSON::parse(response);
         if (!json.isObject()) {
@@ -54,27 +438,13 @@ bool WhisperHTTPClient::sendHealthCheck()
 bool WhisperHTTPClient::sendTranscriptionRequest(const juce::var& requestBody, juce::var& response)
 {
     try {
-        juce::URL transcribeUrl(mServiceUrl + "/transcribe");
-
         juce::String jsonRequest = juce::JSON::toString(requestBody, false);
 
-        auto options = juce::URL::InputStreamOptions(juce::URL::ParameterHandling::inAddress)
-                          .withConnectionTimeoutMs(mTimeoutMs)
-                          .withExtraHeaders("Content-Type: application/json");
-
-        juce::MemoryBlock postData(jsonRequest.toRawUTF8(), jsonRequest.getNumBytesAsUTF8());
-
-        std::unique_ptr<juce::InputStream> stream(
-            transcribeUrl.withPOSTData(postData).createInputStream(options)
-        );
-
-        if (stream == nullptr) {
-            mLastError = "Failed to send transcription request";
+        juce::String responseText;
+        if (!sendRequest("/transcribe", &jsonRequest, mTimeoutMs, responseText)) {
             return false;
         }
 
-        juce::String responseText = stream->readEntireStreamAsString();
-
         response = juce::JSON::parse(responseText);
         if (!response.isObject()) {
             mLastError = "Invalid JSON response from service";
@@ -165,18 +535,11 @@ bool WhisperHTTPClient::transcribe(const float* audioData,
 juce::var WhisperHTTPClient::getModelInfo()
 {
     try {
-        juce::URL infoUrl(mServiceUrl + "/info");
-
-        auto options = juce::URL::InputStreamOptions(juce::URL::ParameterHandling::inAddress)
-                          .withConnectionTimeoutMs(5000);
-
-        std::unique_ptr<juce::InputStream> stream(infoUrl.createInputStream(options));
-
-        if (stream == nullptr) {
+        juce::String response;
+        if (!sendRequest("/info", nullptr, 5000, response)) {
             return juce::var();
         }
 
-        juce::String response = stream->readEntireStreamAsString();
         return juce::JSON::parse(response);
 
     } catch (...) {
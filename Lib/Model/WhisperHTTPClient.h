@@ -9,15 +9,19 @@
  *
  * This client provides a bridge between the C++ plugin and the Python-based
  * Hugging Face Transformers Whisper service running locally.
+ *
+ * The service can be reached over TCP (http://host:port) or, on macOS and Linux,
+ * over a Unix domain socket (unix:///path/to/socket). Both carry the same HTTP
+ * requests, the socket just avoids the loopback TCP stack and ephemeral ports.
  */
 class WhisperHTTPClient
 {
 public:
     /**
      * Constructor
-     * @param serviceUrl Base URL of the Whisper service (default: http://127.0.0.1:8765)
+     * @param serviceUrl Base URL of the Whisper service (http://host:port or unix:///path/to/socket)
      */
-    explicit WhisperHTTPClient(const juce::String& serviceUrl = "http://127.0.0.1:8765");
+    explicit WhisperHTTPClient(const juce::String& serviceUrl = getDefaultServiceUrl());
     ~WhisperHTTPClient() = default;
 
     /**
@@ -55,13 +59,58 @@ public:
      */
     void setTimeout(int timeoutMs) { mTimeoutMs = timeoutMs; }
 
+    /**
+     * Abort the request in progress and make the next ones fail, e.g. before destroying the client while a
+     * transcription is running. Can be called from any thread.
+     */
+    void abort();
+
+    /**
+     * @return True if requests go through a Unix domain socket rather than TCP.
+     */
+    bool usesUnixSocket() const { return mSocketPath.isNotEmpty(); }
+
+    /**
+     * Service URL to use when none is given: NEURALNOTE_WHISPER_SERVICE_URL if set, otherwise the default
+     * Unix socket if it is owned by the current user and a service is listening on it, otherwise
+     * http://127.0.0.1:8765.
+     */
+    static juce::String getDefaultServiceUrl();
+
+    /**
+     * Default path of the service socket, used when the service is started with --unix-socket: in the per-user runtime
+     * directory ($XDG_RUNTIME_DIR on Linux, $TMPDIR on macOS), so that other users cannot create or reach it.
+     * @return The path, or an empty string if there is no per-user runtime directory.
+     */
+    static juce::String getDefaultSocketPath();
+
 private:
     bool sendHealthCheck();
     bool sendTranscriptionRequest(const juce::var& requestBody, juce::var& response);
 
+    /**
+     * Send a GET (postData == nullptr) or a JSON POST request to the service and read the response body.
+     * @return False if the service could not be reached, with mLastError set.
+     */
+    bool sendRequest(const juce::String& path, const juce::String* postData, int timeoutMs, juce::String& outResponse);
+    bool sendUnixSocketRequest(const juce::String& path,
+                               const juce::String* postData,
+                               int timeoutMs,
+                               juce::String& outResponse);
+
+    /**
+     * @return False for anything but a 2xx status, with mLastError set from the status and the error in the body.
+     */
+    bool checkStatusCode(int statusCode, const juce::String& response);
+
     juce::String mServiceUrl;
+    juce::String mSocketPath;
     juce::String mLastError;
     int mTimeoutMs = 30000; // 30 seconds default timeout
 
+    std::atomic<bool> mShouldAbort = false;
+    juce::CriticalSection mActiveStreamLock;
+    juce::WebInputStream* mActiveStream = nullptr;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WhisperHTTPClient)
 };
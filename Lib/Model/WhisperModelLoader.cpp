@@ -1,7 +1,7 @@
 #include "WhisperModelLoader.h"
 
+#include <algorithm>
 #include <cstdlib>
-#include <fstream>
 #include <sstream>
 
 namespace WhisperModelLoader {
@@ -34,25 +34,12 @@ fs::path homePath()
 #endif
 }
 
-bool readFile(const fs::path& filePath, std::vector<uint8_t>& buffer, std::string& error)
+bool mapFile(const fs::path& filePath, std::unique_ptr<ReadOnlyFileMapping>& mapping, std::string& error)
 {
-    std::ifstream stream(filePath, std::ios::binary | std::ios::ate);
-    if (!stream.is_open()) {
-        error = "Failed to open file: " + filePath.string();
-        return false;
-    }
-
-    const std::streamsize size = stream.tellg();
-    if (size <= 0) {
-        error = "File is empty: " + filePath.string();
-        return false;
-    }
-
-    stream.seekg(0, std::ios::beg);
-    buffer.resize(static_cast<size_t>(size));
-    if (!stream.read(reinterpret_cast<char*>(buffer.data()), size)) {
-        error = "Failed to read file: " + filePath.string();
-        buffer.clear();
+    mapping = std::make_unique<ReadOnlyFileMapping>(filePath);
+    if (!mapping->isValid()) {
+        error = mapping->getErrorMessage();
+        mapping.reset();
         return false;
     }
 
@@ -105,7 +92,9 @@ std::vector<fs::path> candidateDirectories()
     return unique;
 }
 
-LoadResult loadInternal(const fs::path& directory, std::vector<uint8_t>& outEncoder, std::vector<uint8_t>& outDecoder)
+LoadResult loadInternal(const fs::path& directory,
+                        std::unique_ptr<ReadOnlyFileMapping>& outEncoder,
+                        std::unique_ptr<ReadOnlyFileMapping>& outDecoder)
 {
     LoadResult result;
     if (directory.empty()) {
@@ -124,17 +113,15 @@ LoadResult loadInternal(const fs::path& directory, std::vector<uint8_t>& outEnco
     }
 
     std::string error;
-    if (!readFile(encoderPath, outEncoder, error)) {
+    if (!mapFile(encoderPath, outEncoder, error)) {
         result.message = error;
-        outEncoder.clear();
-        outDecoder.clear();
+        outDecoder.reset();
         return result;
     }
 
-    if (!readFile(decoderPath, outDecoder, error)) {
+    if (!mapFile(decoderPath, outDecoder, error)) {
         result.message = error;
-        outEncoder.clear();
-        outDecoder.clear();
+        outEncoder.reset();
         return result;
     }
 
@@ -148,13 +135,14 @@ LoadResult loadInternal(const fs::path& directory, std::vector<uint8_t>& outEnco
 } // namespace
 
 LoadResult loadFromDirectory(const fs::path& directory,
-                             std::vector<uint8_t>& outEncoder,
-                             std::vector<uint8_t>& outDecoder)
+                             std::unique_ptr<ReadOnlyFileMapping>& outEncoder,
+                             std::unique_ptr<ReadOnlyFileMapping>& outDecoder)
 {
     return loadInternal(directory, outEncoder, outDecoder);
 }
 
-LoadResult loadFromDefaultLocations(std::vector<uint8_t>& outEncoder, std::vector<uint8_t>& outDecoder)
+LoadResult loadFromDefaultLocations(std::unique_ptr<ReadOnlyFileMapping>& outEncoder,
+                                    std::unique_ptr<ReadOnlyFileMapping>& outDecoder)
 {
     gLastScannedDirs = candidateDirectories();
 
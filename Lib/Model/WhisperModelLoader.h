@@ -2,9 +2,12 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "ReadOnlyFileMapping.h"
+
 /**
  * Helper utilities to locate Whisper ONNX model files on disk when they are not
  * embedded via BinaryData.
@@ -19,13 +22,15 @@ struct LoadResult {
 /**
  * Attempt to load whisper_encoder.ort and whisper_decoder.ort from a list of
  * default directories (environment variables, application data folders, and
- * repository-relative paths).
+ * repository-relative paths). Files are memory-mapped read-only rather than
+ * copied, so their pages are shared between plugin instances.
  *
- * @param outEncoder Buffer to fill with encoder bytes on success.
- * @param outDecoder Buffer to fill with decoder bytes on success.
+ * @param outEncoder Mapping of the encoder file on success.
+ * @param outDecoder Mapping of the decoder file on success.
  * @return Result structure detailing success and any error information.
  */
-LoadResult loadFromDefaultLocations(std::vector<uint8_t>& outEncoder, std::vector<uint8_t>& outDecoder);
+LoadResult loadFromDefaultLocations(std::unique_ptr<ReadOnlyFileMapping>& outEncoder,
+                                    std::unique_ptr<ReadOnlyFileMapping>& outDecoder);
 
 /**
  * Attempt to load models from a specific directory.
@@ -33,8 +38,8 @@ LoadResult loadFromDefaultLocations(std::vector<uint8_t>& outEncoder, std::vecto
  * @param directory Directory that should contain the .ort files.
  */
 LoadResult loadFromDirectory(const std::filesystem::path& directory,
-                             std::vector<uint8_t>& outEncoder,
-                             std::vector<uint8_t>& outDecoder);
+                             std::unique_ptr<ReadOnlyFileMapping>& outEncoder,
+                             std::unique_ptr<ReadOnlyFileMapping>& outDecoder);
 
 /**
  * Absolute paths that were inspected the last time loadFromDefaultLocations()
@@ -0,0 +1,261 @@
+#include "WhisperModelSelector.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace WhisperModelSelector {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr uint32_t GGML_FILE_MAGIC = 0x67676d6c; // "ggml"
+constexpr int32_t GGML_QNT_VERSION_FACTOR = 1000;
+constexpr int32_t ENGLISH_ONLY_VOCAB_SIZE = 51864;
+// Tokens decoded per 30 s window, for the decoder cost estimate
+constexpr double TOKENS_PER_WINDOW = 100.0;
+constexpr double WINDOW_DURATION_SECONDS = 30.0;
+
+struct WeightType {
+    int32_t fType;
+    const char* name;
+    int precisionRank; // Lower is more precise
+};
+
+constexpr std::array<WeightType, 13> weightTypes {{{0, "f32", 0},
+                                                   {1, "f16", 1},
+                                                   {7, "q8_0", 2},
+                                                   {14, "q6_k", 3},
+                                                   {9, "q5_1", 4},
+                                                   {8, "q5_0", 5},
+                                                   {13, "q5_k", 5},
+                                                   {3, "q4_1", 6},
+                                                   {4, "q4_1", 6},
+                                                   {2, "q4_0", 7},
+                                                   {12, "q4_k", 7},
+                                                   {11, "q3_k", 8},
+                                                   {10, "q2_k", 9}}};
+
+const WeightType* findWeightType(int32_t inFType)
+{
+    for (const auto& type: weightTypes) {
+        if (type.fType == inFType)
+            return &type;
+    }
+
+    return nullptr;
+}
+
+int precisionRank(const ModelInfo& inModel)
+{
+    const auto* type = findWeightType(inModel.fType);
+    return type != nullptr ? type->precisionRank : 10;
+}
+
+double envDouble(const char* name)
+{
+    const char* value = std::getenv(name);
+    if (value == nullptr || *value == '\0') {
+        return -1.0;
+    }
+    return std::atof(value);
+}
+
+} // namespace
+
+bool ModelInfo::isEnglishOnly() const
+{
+    return nVocab == ENGLISH_ONLY_VOCAB_SIZE;
+}
+
+std::string ModelInfo::getSizeName() const
+{
+    switch (nAudioLayer) {
+        case 4:
+            return "tiny";
+        case 6:
+            return "base";
+        case 12:
+            return "small";
+        case 24:
+            return "medium";
+        case 32:
+            return nTextLayer == 4 ? "large-turbo" : "large";
+        default:
+            return "custom";
+    }
+}
+
+std::string ModelInfo::getWeightTypeName() const
+{
+    const auto* type = findWeightType(fType);
+    return type != nullptr ? type->name : "ftype " + std::to_string(fType);
+}
+
+double ModelInfo::getNumEncoderParameters() const
+{
+    // Self-attention (4 d^2) and MLP (8 d^2) weights per layer
+    return 12.0 * nAudioLayer * static_cast<double>(nAudioState) * nAudioState;
+}
+
+uint64_t ModelInfo::getEstimatedMemoryBytes() const
+{
+    // f16 self and cross attention KV caches
+    const auto kv_self = 4ull * static_cast<uint64_t>(nTextLayer) * nTextCtx * nTextState;
+    const auto kv_cross = 4ull * static_cast<uint64_t>(nTextLayer) * nAudioCtx * nTextState;
+    // Encoder activations dominate the compute buffers
+    const auto compute = 16ull * sizeof(float) * static_cast<uint64_t>(nAudioCtx) * nAudioState;
+
+    return fileSize + kv_self + kv_cross + compute;
+}
+
+std::string ModelInfo::describe() const
+{
+    std::ostringstream description;
+    description << getSizeName() << (isEnglishOnly() ? ".en " : " ") << getWeightTypeName() << " ("
+                << fileSize / (1024 * 1024) << " MB)";
+    return description.str();
+}
+
+bool readModelInfo(const fs::path& inPath, ModelInfo& outInfo)
+{
+    std::ifstream stream(inPath, std::ios::binary);
+    if (!stream.is_open()) {
+        return false;
+    }
+
+    uint32_t magic = 0;
+    std::array<int32_t, 11> hparams {};
+
+    stream.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    stream.read(reinterpret_cast<char*>(hparams.data()), sizeof(hparams));
+
+    if (!stream || magic != GGML_FILE_MAGIC) {
+        return false;
+    }
+
+    ModelInfo info;
+    info.path = inPath;
+    info.nVocab = hparams[0];
+    info.nAudioCtx = hparams[1];
+    info.nAudioState = hparams[2];
+    info.nAudioHead = hparams[3];
+    info.nAudioLayer = hparams[4];
+    info.nTextCtx = hparams[5];
+    info.nTextState = hparams[6];
+    info.nTextHead = hparams[7];
+    info.nTextLayer = hparams[8];
+    info.nMels = hparams[9];
+    info.fType = hparams[10] % GGML_QNT_VERSION_FACTOR;
+
+    if (info.nAudioLayer <= 0 || info.nAudioState <= 0 || info.nTextLayer <= 0 || info.nTextState <= 0) {
+        return false;
+    }
+
+    std::error_code error;
+    info.fileSize = fs::file_size(inPath, error);
+    if (error) {
+        return false;
+    }
+
+    outInfo = info;
+    return true;
+}
+
+std::vector<ModelInfo> scanDirectories(const std::vector<fs::path>& inDirectories)
+{
+    std::vector<ModelInfo> models;
+
+    for (const auto& directory: inDirectories) {
+        std::error_code error;
+        if (!fs::is_directory(directory, error)) {
+            continue;
+        }
+
+        for (const auto& entry: fs::directory_iterator(directory, error)) {
+            const auto filename = entry.path().filename().string();
+
+            if (!entry.is_regular_file(error) || filename.rfind("ggml-", 0) != 0
+                || entry.path().extension() != ".bin") {
+                continue;
+            }
+
+            ModelInfo info;
+            if (readModelInfo(entry.path(), info)) {
+                models.push_back(info);
+            }
+        }
+    }
+
+    return models;
+}
+
+double estimateRealTimeFactor(const ModelInfo& inModel, const Budget& inBudget)
+{
+    const double encoder_flops = 2.0 * inModel.getNumEncoderParameters() * inModel.nAudioCtx;
+
+    // Self-attention, cross-attention and MLP weights per layer, plus the output projection
+    const double decoder_params = 16.0 * inModel.nTextLayer * static_cast<double>(inModel.nTextState)
+                                      * inModel.nTextState
+                                  + static_cast<double>(inModel.nVocab) * inModel.nTextState;
+    const double decoder_flops = 2.0 * decoder_params * TOKENS_PER_WINDOW;
+
+    const double flops_per_second = std::max(1, inBudget.numCores) * inBudget.gigaFlopsPerCore * 1e9;
+
+    return (encoder_flops + decoder_flops) / flops_per_second / WINDOW_DURATION_SECONDS;
+}
+
+bool fitsBudget(const ModelInfo& inModel, const Budget& inBudget)
+{
+    return inModel.getEstimatedMemoryBytes() <= inBudget.maxMemoryBytes
+           && estimateRealTimeFactor(inModel, inBudget) <= inBudget.maxRealTimeFactor;
+}
+
+int selectBestModel(const std::vector<ModelInfo>& inModels, const Budget& inBudget)
+{
+    int best_idx = -1;
+
+    auto is_better = [](const ModelInfo& a, const ModelInfo& b) {
+        if (a.getNumEncoderParameters() != b.getNumEncoderParameters())
+            return a.getNumEncoderParameters() > b.getNumEncoderParameters();
+        if (precisionRank(a) != precisionRank(b))
+            return precisionRank(a) < precisionRank(b);
+        return a.isEnglishOnly() && !b.isEnglishOnly();
+    };
+
+    for (size_t i = 0; i < inModels.size(); i++) {
+        if (!fitsBudget(inModels[i], inBudget))
+            continue;
+
+        if (best_idx < 0 || is_better(inModels[i], inModels[static_cast<size_t>(best_idx)]))
+            best_idx = static_cast<int>(i);
+    }
+
+    if (best_idx >= 0 || inModels.empty())
+        return best_idx;
+
+    // Nothing fits: fall back to the lightest model rather than having no transcription at all
+    auto lightest = std::min_element(inModels.begin(), inModels.end(), [](const ModelInfo& a, const ModelInfo& b) {
+        return a.getEstimatedMemoryBytes() < b.getEstimatedMemoryBytes();
+    });
+
+    return static_cast<int>(std::distance(inModels.begin(), lightest));
+}
+
+Budget applyEnvironmentOverrides(Budget inBudget)
+{
+    if (auto max_memory_mb = envDouble("NEURALNOTE_WHISPER_MAX_MEMORY_MB"); max_memory_mb > 0.0) {
+        inBudget.maxMemoryBytes = static_cast<uint64_t>(max_memory_mb * 1024.0 * 1024.0);
+    }
+
+    if (auto max_rtf = envDouble("NEURALNOTE_WHISPER_MAX_RTF"); max_rtf > 0.0) {
+        inBudget.maxRealTimeFactor = max_rtf;
+    }
+
+    return inBudget;
+}
+
+} // namespace WhisperModelSelector
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+ * Model selection policy for whisper.cpp (ggml) models.
+ *
+ * Scans model directories for every ggml-*.bin file (including quantized variants such as q5_0 or q8_0),
+ * reads only the file header to get the model hyperparameters, and picks the largest model whose estimated
+ * memory footprint and transcription latency fit a resource budget.
+ */
+namespace WhisperModelSelector {
+
+/** Hyperparameters read from the header of a ggml Whisper model file */
+struct ModelInfo {
+    std::filesystem::path path;
+    uint64_t fileSize = 0;
+
+    int32_t nVocab = 0;
+    int32_t nAudioCtx = 0;
+    int32_t nAudioState = 0;
+    int32_t nAudioHead = 0;
+    int32_t nAudioLayer = 0;
+    int32_t nTextCtx = 0;
+    int32_t nTextState = 0;
+    int32_t nTextHead = 0;
+    int32_t nTextLayer = 0;
+    int32_t nMels = 0;
+    int32_t fType = 0; // ggml_ftype, without the quantization version
+
+    /** @return True for English-only models (.en), which use a smaller vocabulary. */
+    bool isEnglishOnly() const;
+
+    /** @return Architecture name: tiny, base, small, medium, large or large-turbo. */
+    std::string getSizeName() const;
+
+    /** @return Weight type: f32, f16, q4_0, q5_0, q8_0, ... */
+    std::string getWeightTypeName() const;
+
+    /** @return Rough number of encoder parameters, used to rank models by quality and cost. */
+    double getNumEncoderParameters() const;
+
+    /** @return Estimated resident memory when loaded: weights, KV caches and compute buffers. */
+    uint64_t getEstimatedMemoryBytes() const;
+
+    /** @return Human readable description, e.g. "base.en q5_0 (57 MB)". */
+    std::string describe() const;
+};
+
+/** Resources available for Whisper transcription */
+struct Budget {
+    uint64_t maxMemoryBytes = 1024ull * 1024ull * 1024ull;
+    // Maximum transcription time relative to audio duration (0.5: 30 s of audio in 15 s)
+    double maxRealTimeFactor = 0.5;
+    int numCores = 4;
+    // Conservative effective throughput of one core running whisper.cpp
+    double gigaFlopsPerCore = 20.0;
+};
+
+/**
+ * Read the model header without loading the weights.
+ * @param inPath Path to a ggml model file.
+ * @param outInfo Filled on success.
+ * @return False if the file cannot be read or is not a ggml Whisper model.
+ */
+bool readModelInfo(const std::filesystem::path& inPath, ModelInfo& outInfo);
+
+/**
+ * Find all valid ggml-*.bin models in the given directories. Missing directories are ignored.
+ */
+std::vector<ModelInfo> scanDirectories(const std::vector<std::filesystem::path>& inDirectories);
+
+/**
+ * Estimated transcription time relative to audio duration, for a 30 s window with the budget's core count.
+ */
+double estimateRealTimeFactor(const ModelInfo& inModel, const Budget& inBudget);
+
+/**
+ * @return True if the model fits the memory and latency budgets.
+ */
+bool fitsBudget(const ModelInfo& inModel, const Budget& inBudget);
+
+/**
+ * Pick the best model fitting the budget: largest architecture first, then highest precision weights, then
+ * English-only models. If no model fits, the one with the smallest memory footprint is returned.
+ * @return Index of the selected model in inModels, or -1 if inModels is empty.
+ */
+int selectBestModel(const std::vector<ModelInfo>& inModels, const Budget& inBudget);
+
+/**
+ * Override budget fields from the NEURALNOTE_WHISPER_MAX_MEMORY_MB and NEURALNOTE_WHISPER_MAX_RTF environment
+ * variables, if set.
+ */
+Budget applyEnvironmentOverrides(Budget inBudget);
+
+} // namespace WhisperModelSelector
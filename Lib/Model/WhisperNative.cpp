@@ -1,27 +1,79 @@
 #include "WhisperNative.h"
+#include "WhisperModelSelector.h"
+#include "AsyncLogger.h"
 #include "whisper.h"
 #include <JuceHeader.h>
+#include <cstring>
+
+namespace
+{
+/** whisper.cpp model loader reading from a memory mapped model file */
+struct MappedModelReader {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    size_t position = 0;
+};
+
+size_t readMappedModel(void* inContext, void* outData, size_t inNumBytes)
+{
+    auto* reader = static_cast<MappedModelReader*>(inContext);
+    auto num_bytes = std::min(inNumBytes, reader->size - reader->position);
+    std::memcpy(outData, reader->data + reader->position, num_bytes);
+    reader->position += num_bytes;
+    return num_bytes;
+}
+
+bool isMappedModelAtEnd(void* inContext)
+{
+    auto* reader = static_cast<MappedModelReader*>(inContext);
+    return reader->position >= reader->size;
+}
+
+void closeMappedModel(void*)
+{
+}
+} // namespace
 
 WhisperNative::WhisperNative()
 {
-    // Try to auto-load a model from standard locations
-    std::vector<std::string> modelNames = {
-        "ggml-tiny.en.bin",
-        "ggml-base.en.bin",
-        "ggml-small.en.bin",
-        "ggml-tiny.bin",
-        "ggml-base.bin"
-    };
-
-    for (const auto& name : modelNames) {
-        std::string path = findModel(name);
-        if (!path.empty() && loadModel(path)) {
-            DBG("WhisperNative: Auto-loaded model: " + juce::String(path));
-            return;
-        }
+    std::vector<std::filesystem::path> search_dirs;
+    for (const auto& path: getModelSearchPaths()) {
+        search_dirs.emplace_back(path);
     }
 
-    mErrorMessage = "No Whisper model found. Place a .bin model in Lib/ModelData/ or ~/Library/Application Support/NeuralNote/Models/";
+    // Read the headers of all ggml models found, and pick the best one for this machine
+    auto models = WhisperModelSelector::scanDirectories(search_dirs);
+
+    if (models.empty()) {
+        mErrorMessage = "No Whisper model found. Place a ggml .bin model in Lib/ModelData/ or "
+                        "~/Library/Application Support/NeuralNote/Models/";
+        return;
+    }
+
+    WhisperModelSelector::Budget budget;
+    budget.numCores = std::max(1, juce::SystemStats::getNumPhysicalCpus());
+    // Leave most of the memory to the host and the other plugins
+    budget.maxMemoryBytes = static_cast<uint64_t>(juce::SystemStats::getMemorySizeInMegabytes()) * 1024 * 1024 / 8;
+    budget = WhisperModelSelector::applyEnvironmentOverrides(budget);
+
+    mNumThreads = budget.numCores;
+
+    const auto& model = models[static_cast<size_t>(WhisperModelSelector::selectBestModel(models, budget))];
+
+    NN_LOG_INFO(Whisper,
+                "Found {} model(s), selected {}, estimated memory {} MB, real-time factor {}",
+                models.size(),
+                model.describe(),
+                model.getEstimatedMemoryBytes() / (1024 * 1024),
+                WhisperModelSelector::estimateRealTimeFactor(model, budget));
+
+    if (loadModel(model.path.string())) {
+        mModelDescription = model.describe();
+
+        if (!WhisperModelSelector::fitsBudget(model, budget)) {
+            mModelDescription += ", over budget";
+        }
+    }
 }
 
 WhisperNative::~WhisperNative()
@@ -73,17 +125,6 @@ std::vector<std::string> WhisperNative::getModelSearchPaths() const
     return paths;
 }
 
-std::string WhisperNative::findModel(const std::string& modelName) const
-{
-    for (const auto& searchPath : getModelSearchPaths()) {
-        juce::File modelFile = juce::File(searchPath).getChildFile(modelName);
-        if (modelFile.existsAsFile()) {
-            return modelFile.getFullPathName().toStdString();
-        }
-    }
-    return "";
-}
-
 bool WhisperNative::loadModel(const std::string& modelPath)
 {
     if (mContext) {
@@ -91,8 +132,28 @@ bool WhisperNative::loadModel(const std::string& modelPath)
         mContext = nullptr;
     }
 
+    mModelDescription.clear();
+    mEstimatedMemoryBytes = 0;
+
     whisper_context_params context_params = whisper_context_default_params();
-    mContext = whisper_init_from_file_with_params(modelPath.c_str(), context_params);
+
+    // Read the weights through a memory mapping rather than buffered file reads. whisper.cpp copies them into its
+    // own buffers, so the mapping is released once the model is loaded.
+    juce::MemoryMappedFile mapped_file(juce::File(modelPath), juce::MemoryMappedFile::readOnly);
+
+    if (mapped_file.getData() != nullptr) {
+        MappedModelReader reader {static_cast<const uint8_t*>(mapped_file.getData()), mapped_file.getSize(), 0};
+
+        whisper_model_loader loader {};
+        loader.context = &reader;
+        loader.read = readMappedModel;
+        loader.eof = isMappedModelAtEnd;
+        loader.close = closeMappedModel;
+
+        mContext = whisper_init_with_params(&loader, context_params);
+    } else {
+        mContext = whisper_init_from_file_with_params(modelPath.c_str(), context_params);
+    }
 
     if (!mContext) {
         mErrorMessage = "Failed to load model from: " + modelPath;
@@ -100,7 +161,15 @@ bool WhisperNative::loadModel(const std::string& modelPath)
     }
 
     mErrorMessage.clear();
-    DBG("WhisperNative: Loaded model from " + juce::String(modelPath));
+
+    // whisper.cpp does not report its allocations, estimate them from the model hyperparameters
+    WhisperModelSelector::ModelInfo model_info;
+
+    if (WhisperModelSelector::readModelInfo(modelPath, model_info)) {
+        mEstimatedMemoryBytes = model_info.getEstimatedMemoryBytes();
+    }
+
+    NN_LOG_INFO(Whisper, "Loaded model from {}", modelPath);
     return true;
 }
 
@@ -130,6 +199,14 @@ bool WhisperNative::transcribe(const float* audioData,
     params.token_timestamps = true;
     params.max_tokens = 0;  // No limit
     params.translate = false;
+    params.n_threads = mNumThreads;
+
+    if (mShouldAbort != nullptr) {
+        params.abort_callback = [](void* inShouldAbort) {
+            return static_cast<const std::atomic<bool>*>(inShouldAbort)->load();
+        };
+        params.abort_callback_user_data = const_cast<std::atomic<bool>*>(mShouldAbort);
+    }
 
     // Set language if specified
     if (!language.empty() && language != "auto") {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "WhisperConstants.h"
+#include <atomic>
 #include <vector>
 #include <string>
 #include <memory>
@@ -13,6 +14,9 @@ struct whisper_full_params;
 /**
  * Native C++ Whisper implementation using whisper.cpp
  * Fully self-contained, no external services required
+ *
+ * On construction, all ggml models in the search paths are considered and the best one fitting the machine's
+ * memory and core count is loaded (see WhisperModelSelector).
  */
 class WhisperNative
 {
@@ -27,6 +31,16 @@ public:
      */
     bool loadModel(const std::string& modelPath);
 
+    /**
+     * Description of the loaded model (size, weight type and file size), empty if none is loaded
+     */
+    const std::string& getModelDescription() const { return mModelDescription; }
+
+    /**
+     * Estimated memory held by the loaded model (weights, KV caches and compute buffers), 0 if none is loaded
+     */
+    uint64_t getEstimatedMemoryBytes() const { return mEstimatedMemoryBytes; }
+
     /**
      * Check if model is loaded and ready
      */
@@ -50,6 +64,12 @@ public:
                    const std::string& language,
                    std::vector<TimedWord>& outWords);
 
+    /**
+     * Set a flag checked during transcription, whisper.cpp aborts the running transcription when it is set
+     * @param shouldAbort Flag owned by the caller, must outlive this object (nullptr to remove)
+     */
+    void setAbortFlag(const std::atomic<bool>* shouldAbort) { mShouldAbort = shouldAbort; }
+
     /**
      * Get full transcription text
      */
@@ -65,8 +85,11 @@ private:
     std::vector<TimedWord> mTimedWords;
     std::string mErrorMessage;
     std::string mFullText;
+    std::string mModelDescription;
+    uint64_t mEstimatedMemoryBytes = 0;
+    int mNumThreads = 4;
+    const std::atomic<bool>* mShouldAbort = nullptr;
 
     // Model search paths
     std::vector<std::string> getModelSearchPaths() const;
-    std::string findModel(const std::string& modelName) const;
 };
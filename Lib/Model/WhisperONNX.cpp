@@ -6,6 +6,10 @@
 
 #include "WhisperModelLoader.h"
 
+#if NN_EMBED_MODEL_DATA
+#include "ModelBinaryData.h"
+#endif
+
 namespace
 {
 constexpr const char* kWhisperPlaceholderMagic = "NEURALNOTE_WHISPER_PLACEHOLDER";
@@ -41,11 +45,19 @@ WhisperONNX::WhisperONNX()
         mDecoderSessionOptions.SetInterOpNumThreads(1);
         mDecoderSessionOptions.SetIntraOpNumThreads(1);
 
-        const char* embeddedEncoder = BinaryData::whisper_encoder_ort;
-        const char* embeddedDecoder = BinaryData::whisper_decoder_ort;
+#if NN_EMBED_MODEL_DATA
+        const char* embeddedEncoder = ModelBinaryData::whisper_encoder_ort;
+        const char* embeddedDecoder = ModelBinaryData::whisper_decoder_ort;
+
+        size_t encoderSize = static_cast<size_t>(ModelBinaryData::whisper_encoder_ortSize);
+        size_t decoderSize = static_cast<size_t>(ModelBinaryData::whisper_decoder_ortSize);
+#else
+        const char* embeddedEncoder = nullptr;
+        const char* embeddedDecoder = nullptr;
 
-        size_t encoderSize = static_cast<size_t>(BinaryData::whisper_encoder_ortSize);
-        size_t decoderSize = static_cast<size_t>(BinaryData::whisper_decoder_ortSize);
+        size_t encoderSize = 0;
+        size_t decoderSize = 0;
+#endif
 
         bool hasValidEncoder = !isPlaceholderModelData(embeddedEncoder, encoderSize);
         bool hasValidDecoder = !isPlaceholderModelData(embeddedDecoder, decoderSize);
@@ -56,10 +68,10 @@ WhisperONNX::WhisperONNX()
         if (!hasValidEncoder || !hasValidDecoder) {
             auto loadResult = WhisperModelLoader::loadFromDefaultLocations(mExternalEncoderData, mExternalDecoderData);
             if (loadResult.success) {
-                encoderData = reinterpret_cast<const char*>(mExternalEncoderData.data());
-                decoderData = reinterpret_cast<const char*>(mExternalDecoderData.data());
-                encoderSize = mExternalEncoderData.size();
-                decoderSize = mExternalDecoderData.size();
+                encoderData = mExternalEncoderData->getData();
+                decoderData = mExternalDecoderData->getData();
+                encoderSize = mExternalEncoderData->getSize();
+                decoderSize = mExternalDecoderData->getSize();
                 hasValidEncoder = hasValidDecoder = true;
                 mErrorMessage.clear();
             } else {
@@ -69,6 +81,12 @@ WhisperONNX::WhisperONNX()
         }
 
         if (hasValidEncoder && hasValidDecoder) {
+            // Model bytes are embedded or mapped for the lifetime of this object: use them in place
+            mEncoderSessionOptions.AddConfigEntry("session.use_ort_model_bytes_directly", "1");
+            mEncoderSessionOptions.AddConfigEntry("session.use_ort_model_bytes_for_initializers", "1");
+            mDecoderSessionOptions.AddConfigEntry("session.use_ort_model_bytes_directly", "1");
+            mDecoderSessionOptions.AddConfigEntry("session.use_ort_model_bytes_for_initializers", "1");
+
             mEncoderSession = Ort::Session(mEnv, encoderData, encoderSize, mEncoderSessionOptions);
             mDecoderSession = Ort::Session(mEnv, decoderData, decoderSize, mDecoderSessionOptions);
             mIsInitialized = true;
@@ -5,8 +5,10 @@
 #include <string>
 #include <array>
 #include <cstdint>
+#include <memory>
 
-#include "BinaryData.h"
+#include "ModelBundle.h"
+#include "ReadOnlyFileMapping.h"
 #include "WhisperConstants.h"
 
 /**
@@ -69,6 +71,10 @@ private:
     void initializeMelFilters();
     void computeFFT(const float* audio, size_t numSamples, std::vector<float>& fftOutput);
 
+    // Memory-mapped model files when models are loaded from disk. Declared first so they outlive the sessions.
+    std::unique_ptr<ReadOnlyFileMapping> mExternalEncoderData;
+    std::unique_ptr<ReadOnlyFileMapping> mExternalDecoderData;
+
     // ONNX Runtime for Encoder
     Ort::MemoryInfo mMemoryInfo;
     Ort::SessionOptions mEncoderSessionOptions;
@@ -99,8 +105,4 @@ private:
 
     // Encoder output cache
     std::vector<float> mEncoderOutputBuffer;
-
-    // External model buffers when models are loaded from disk
-    std::vector<uint8_t> mExternalEncoderData;
-    std::vector<uint8_t> mExternalDecoderData;
 };
@@ -1,73 +1,123 @@
 #include "WhisperTranscriber.h"
+#include "AsyncLogger.h"
 #include <sstream>
 
 WhisperTranscriber::WhisperTranscriber(Backend backend, const juce::String& serviceUrl)
     : mRequestedBackend(backend)
     , mActiveBackend(Backend::ONNX)  // Default until selectBackend runs
+    , mServiceUrl(serviceUrl)
 {
-    selectBackend(backend);
+    if (backend == Backend::HTTPService || backend == Backend::Auto) {
+        mHTTPClient = std::make_unique<WhisperHTTPClient>(mServiceUrl);
+    }
+}
 
-    // Create HTTP client if needed
-    if (mActiveBackend == Backend::HTTPService || mRequestedBackend == Backend::Auto) {
-        mHTTPClient = std::make_unique<WhisperHTTPClient>(serviceUrl);
+void WhisperTranscriber::initialize()
+{
+    if (mIsInitializeCalled) {
+        return;
     }
+
+    mIsInitializeCalled = true;
+    selectBackend(mRequestedBackend);
 }
 
 void WhisperTranscriber::selectBackend(Backend preferredBackend)
 {
     mErrorMessage.clear();
 
-    // Handle explicit backend requests
+    // Handle explicit backend requests, only loading the requested one
     if (preferredBackend == Backend::Native) {
+        mWhisperNative = std::make_unique<WhisperNative>();
+        mWhisperNative->setAbortFlag(&mShouldAbort);
         mActiveBackend = Backend::Native;
         return;
     }
     if (preferredBackend == Backend::HTTPService) {
+        _isHTTPServiceAvailable();
         mActiveBackend = Backend::HTTPService;
         return;
     }
     if (preferredBackend == Backend::ONNX) {
+        mWhisperONNX = std::make_unique<WhisperONNX>();
         mActiveBackend = Backend::ONNX;
         return;
     }
 
-    // Auto mode: Try Native → HTTP → ONNX
-    if (mWhisperNative.isInitialized()) {
+    // Auto mode: Try Native → HTTP → ONNX, a backend is only created if the previous ones are not available
+    mWhisperNative = std::make_unique<WhisperNative>();
+    mWhisperNative->setAbortFlag(&mShouldAbort);
+
+    if (mWhisperNative->isInitialized()) {
         mActiveBackend = Backend::Native;
-        DBG("WhisperTranscriber: Using Native (whisper.cpp) backend");
+        NN_LOG_INFO(Whisper, "Using Native (whisper.cpp) backend");
         return;
     }
 
-    mHTTPClient = std::make_unique<WhisperHTTPClient>();
-    if (mHTTPClient->isServiceAvailable()) {
+    if (_isHTTPServiceAvailable()) {
         mActiveBackend = Backend::HTTPService;
-        DBG("WhisperTranscriber: Using HTTP service backend");
+        NN_LOG_INFO(Whisper, "Using HTTP service backend");
         return;
     }
 
-    if (mWhisperONNX.isInitialized()) {
+    mWhisperONNX = std::make_unique<WhisperONNX>();
+
+    if (mWhisperONNX->isInitialized()) {
         mActiveBackend = Backend::ONNX;
-        DBG("WhisperTranscriber: Using ONNX Runtime backend");
+        NN_LOG_INFO(Whisper, "Using ONNX Runtime backend");
         return;
     }
 
     // No backend available
     mActiveBackend = Backend::Native;  // Set to Native but will fail isInitialized() check
-    mErrorMessage = "No Whisper backend available. Native: " + mWhisperNative.getErrorMessage() +
+    mErrorMessage = "No Whisper backend available. Native: " + mWhisperNative->getErrorMessage() +
                    ", HTTP: " + mHTTPClient->getLastError().toStdString() +
-                   ", ONNX: " + mWhisperONNX.getErrorMessage();
-    DBG("WhisperTranscriber: " + juce::String(mErrorMessage));
+                   ", ONNX: " + mWhisperONNX->getErrorMessage();
+    NN_LOG_ERROR(Whisper, "{}", mErrorMessage);
+}
+
+bool WhisperTranscriber::_isHTTPServiceAvailable()
+{
+    mIsHTTPServiceAvailable = mHTTPClient != nullptr && mHTTPClient->isServiceAvailable();
+    return mIsHTTPServiceAvailable;
+}
+
+bool WhisperTranscriber::retryHTTPService()
+{
+    // Only the backends which may use the service create a client
+    if (!mIsInitializeCalled || isInitialized() || mHTTPClient == nullptr) {
+        return isInitialized();
+    }
+
+    if (!_isHTTPServiceAvailable()) {
+        return false;
+    }
+
+    mActiveBackend = Backend::HTTPService;
+    mErrorMessage.clear();
+    NN_LOG_INFO(Whisper, "Using HTTP service backend");
+
+    return true;
+}
+
+void WhisperTranscriber::abort()
+{
+    mShouldAbort = true;
+
+    if (mHTTPClient != nullptr) {
+        mHTTPClient->abort();
+    }
 }
 
 bool WhisperTranscriber::isInitialized() const
 {
     switch (mActiveBackend) {
         case Backend::Native:
-            return mWhisperNative.isInitialized();
+            return mWhisperNative != nullptr && mWhisperNative->isInitialized();
         case Backend::HTTPService:
-            return mHTTPClient != nullptr && mHTTPClient->isServiceAvailable();
+            return mHTTPClient != nullptr && mIsHTTPServiceAvailable;
         case Backend::ONNX:
-            return mWhisperONNX.isInitialized();
+            return mWhisperONNX != nullptr && mWhisperONNX->isInitialized();
         case Backend::Auto:
         default:
             return false;
@@ -80,9 +130,17 @@ const std::string& WhisperTranscriber::getErrorMessage() const
         return mErrorMessage;
     }
 
+    if (!mIsInitializeCalled) {
+        static const std::string notInitializedError = "Whisper backend not initialized yet";
+        return notInitializedError;
+    }
+
     switch (mActiveBackend) {
         case Backend::Native:
-            return mWhisperNative.getErrorMessage();
+            if (mWhisperNative) {
+                return mWhisperNative->getErrorMessage();
+            }
+            break;
         case Backend::HTTPService:
             if (mHTTPClient) {
                 static std::string httpError;
@@ -91,7 +149,10 @@ const std::string& WhisperTranscriber::getErrorMessage() const
             }
             break;
         case Backend::ONNX:
-            return mWhisperONNX.getErrorMessage();
+            if (mWhisperONNX) {
+                return mWhisperONNX->getErrorMessage();
+            }
+            break;
         default:
             break;
     }
@@ -112,10 +173,15 @@ std::vector<TimedWord> WhisperTranscriber::transcribeToText(float* inAudio, int
         return mTimedWords;
     }
 
+    if (mShouldAbort) {
+        mErrorMessage = "Transcription aborted";
+        return mTimedWords;
+    }
+
     // Route to appropriate backend
     switch (mActiveBackend) {
         case Backend::Native:
-            if (!mWhisperNative.isInitialized()) {
+            if (mWhisperNative == nullptr || !mWhisperNative->isInitialized()) {
                 mErrorMessage = "Native backend not initialized";
                 return mTimedWords;
             }
@@ -126,9 +192,9 @@ std::vector<TimedWord> WhisperTranscriber::transcribeToText(float* inAudio, int
                     languageCode = WhisperConstants::languageToString(mLanguage);
                 }
 
-                bool success = mWhisperNative.transcribe(inAudio, inNumSamples, languageCode, mTimedWords);
+                bool success = mWhisperNative->transcribe(inAudio, inNumSamples, languageCode, mTimedWords);
                 if (!success) {
-                    mErrorMessage = mWhisperNative.getErrorMessage();
+                    mErrorMessage = mWhisperNative->getErrorMessage();
                 }
                 return mTimedWords;
             }
@@ -150,7 +216,7 @@ std::vector<TimedWord> WhisperTranscriber::transcribeToText(float* inAudio, int
             break;
 
         case Backend::ONNX:
-            if (!mWhisperONNX.isInitialized()) {
+            if (mWhisperONNX == nullptr || !mWhisperONNX->isInitialized()) {
                 mErrorMessage = "ONNX backend not initialized";
                 return mTimedWords;
             }
@@ -158,7 +224,7 @@ std::vector<TimedWord> WhisperTranscriber::transcribeToText(float* inAudio, int
             try {
                 // Step 1: Compute mel-spectrogram features
                 size_t numFrames = 0;
-                const float* melFeatures = mWhisperONNX.computeMelSpectrogram(inAudio, inNumSamples, numFrames);
+                const float* melFeatures = mWhisperONNX->computeMelSpectrogram(inAudio, inNumSamples, numFrames);
 
                 if (melFeatures == nullptr || numFrames == 0) {
                     mErrorMessage = "Failed to compute mel-spectrogram";
@@ -166,7 +232,7 @@ std::vector<TimedWord> WhisperTranscriber::transcribeToText(float* inAudio, int
                 }
 
                 // Step 2: Run encoder to get audio features
-                const float* encoderOutput = mWhisperONNX.runEncoder(melFeatures, numFrames);
+                const float* encoderOutput = mWhisperONNX->runEncoder(melFeatures, numFrames);
 
                 if (encoderOutput == nullptr) {
                     mErrorMessage = "Encoder failed";
@@ -175,7 +241,7 @@ std::vector<TimedWord> WhisperTranscriber::transcribeToText(float* inAudio, int
 
                 // Step 3: Run decoder to generate text tokens
                 std::vector<int> tokens;
-                bool success = mWhisperONNX.runDecoder(encoderOutput, mLanguage, tokens);
+                bool success = mWhisperONNX->runDecoder(encoderOutput, mLanguage, tokens);
 
                 if (!success || tokens.empty()) {
                     mErrorMessage = "Decoder failed";
@@ -183,7 +249,7 @@ std::vector<TimedWord> WhisperTranscriber::transcribeToText(float* inAudio, int
                 }
 
                 // Step 4: Convert tokens to timed words
-                mTimedWords = mWhisperONNX.tokensToTimedWords(tokens);
+                mTimedWords = mWhisperONNX->tokensToTimedWords(tokens);
                 return mTimedWords;
 
             } catch (const std::exception& e) {
@@ -201,6 +267,36 @@ std::vector<TimedWord> WhisperTranscriber::transcribeToText(float* inAudio, int
     return mTimedWords;
 }
 
+std::string WhisperTranscriber::getBackendDescription() const
+{
+    switch (mActiveBackend) {
+        case Backend::Native:
+            return isInitialized() ? "whisper.cpp: " + mWhisperNative->getModelDescription() : "";
+        case Backend::HTTPService:
+            return mHTTPClient != nullptr ? "Whisper service" : "";
+        case Backend::ONNX:
+            return mWhisperONNX != nullptr ? "ONNX Runtime" : "";
+        case Backend::Auto:
+        default:
+            return "";
+    }
+}
+
+uint64_t WhisperTranscriber::getEstimatedMemoryBytes() const
+{
+    uint64_t num_bytes = mTimedWords.capacity() * sizeof(TimedWord);
+
+    for (const auto& word: mTimedWords) {
+        num_bytes += word.text.capacity();
+    }
+
+    if (mWhisperNative != nullptr) {
+        num_bytes += mWhisperNative->getEstimatedMemoryBytes();
+    }
+
+    return num_bytes;
+}
+
 std::string WhisperTranscriber::getFullText() const
 {
     if (mTimedWords.empty()) {
@@ -222,3 +318,18 @@ void WhisperTranscriber::reset()
 {
     mTimedWords.clear();
 }
+
+void WhisperTranscriber::warmUp(const std::atomic<bool>& shouldStop)
+{
+    if (mActiveBackend != Backend::Native || !isInitialized() || shouldStop.load()) {
+        return;
+    }
+
+    std::vector<float> silence(static_cast<size_t>(WhisperConstants::WHISPER_SAMPLE_RATE), 0.0f);
+    std::vector<TimedWord> words;
+
+    mWhisperNative->setAbortFlag(&shouldStop);
+    mWhisperNative->transcribe(silence.data(), static_cast<int>(silence.size()), "en", words);
+    mWhisperNative->setAbortFlag(&mShouldAbort);
+    mWhisperNative->reset();
+}
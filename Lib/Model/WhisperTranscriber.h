@@ -7,6 +7,7 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <atomic>
 
 /**
  * Main API class for speech-to-text transcription using Whisper model
@@ -26,13 +27,35 @@ public:
         Auto           // Auto-select: Native → HTTP → ONNX
     };
 
+    /**
+     * Only stores the configuration: nothing is loaded and no request is sent until initialize is called.
+     */
     WhisperTranscriber(Backend backend = Backend::Auto,
-                       const juce::String& serviceUrl = "http://127.0.0.1:8765");
+                       const juce::String& serviceUrl = WhisperHTTPClient::getDefaultServiceUrl());
     ~WhisperTranscriber() = default;
 
+    /**
+     * Discover the backends and load the model of the selected one. Can take seconds (model loading, ORT sessions,
+     * health check of the HTTP service), so call it on a background thread. Only the first call does something.
+     */
+    void initialize();
+
+    /**
+     * If no backend is ready, check again whether the HTTP service is available, e.g. started after initialize, and
+     * use it if so. Blocks for the health check: call it on a background thread, like initialize.
+     * @return true if a backend is ready to use
+     */
+    bool retryHTTPService();
+
+    /**
+     * Abort the running transcription or warm-up and make the next ones return no words, e.g. before destruction.
+     * Can be called from any thread. The ONNX backend cannot be interrupted.
+     */
+    void abort();
+
     /**
      * Check if the Whisper backend is ready
-     * @return true if backend is ready to use, false if initialization failed
+     * @return true if backend is ready to use, false if initialization failed or initialize was not called yet
      */
     bool isInitialized() const;
 
@@ -48,6 +71,17 @@ public:
      */
     Backend getActiveBackend() const { return mActiveBackend; }
 
+    /**
+     * Describe the active backend and its model, for display in the UI
+     * @return e.g. "whisper.cpp: base.en q5_0 (57 MB)"
+     */
+    std::string getBackendDescription() const;
+
+    /**
+     * @return Estimated memory held by the active backend and the last transcription result, in bytes
+     */
+    uint64_t getEstimatedMemoryBytes() const;
+
     /**
      * Set language for transcription
      * @param language Target language (use Language::Auto for automatic detection)
@@ -85,17 +119,34 @@ public:
      */
     void reset();
 
+    /**
+     * Transcribe a short silence and discard the result, so that the first real transcription does not pay for
+     * the lazy initialization of the backend. Only runs for the Native backend, the others are remote or placeholders.
+     * @param shouldStop Aborts the warm-up when set.
+     */
+    void warmUp(const std::atomic<bool>& shouldStop);
+
 private:
     void selectBackend(Backend preferredBackend);
 
+    bool _isHTTPServiceAvailable();
+
     Backend mRequestedBackend;
     Backend mActiveBackend;
+    const juce::String mServiceUrl;
+    bool mIsInitializeCalled = false;
 
-    WhisperNative mWhisperNative;
-    WhisperONNX mWhisperONNX;
+    // Created by initialize, only for the backends considered
+    std::unique_ptr<WhisperNative> mWhisperNative;
+    std::unique_ptr<WhisperONNX> mWhisperONNX;
+    // Created by the constructor if the backend may be used (cheap, no request), so that abort can reach it any time
     std::unique_ptr<WhisperHTTPClient> mHTTPClient;
+    // Result of the health check done by initialize, so that isInitialized does not send a request
+    bool mIsHTTPServiceAvailable = false;
 
     WhisperConstants::Language mLanguage = WhisperConstants::Language::Auto;
     std::vector<TimedWord> mTimedWords;
     mutable std::string mErrorMessage;
+
+    std::atomic<bool> mShouldAbort = false;
 };
@@ -0,0 +1,346 @@
+#include "AsyncLogger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+
+namespace Log
+{
+
+namespace
+{
+static_assert((AsyncLogger::CAPACITY & (AsyncLogger::CAPACITY - 1)) == 0, "Capacity must be a power of 2");
+
+const char* toString(Level inLevel)
+{
+    switch (inLevel) {
+        case Level::Debug:
+            return "DEBUG";
+        case Level::Info:
+            return "INFO";
+        case Level::Warning:
+            return "WARNING";
+        case Level::Error:
+            return "ERROR";
+    }
+
+    return "";
+}
+
+const char* toString(Category inCategory)
+{
+    switch (inCategory) {
+        case Category::Recording:
+            return "Recording";
+        case Category::Transcription:
+            return "Transcription";
+        case Category::Whisper:
+            return "Whisper";
+        case Category::UI:
+            return "UI";
+        case Category::NumCategories:
+            break;
+    }
+
+    return "";
+}
+} // namespace
+
+AsyncLogger& AsyncLogger::getInstance()
+{
+    static AsyncLogger logger;
+    return logger;
+}
+
+AsyncLogger::AsyncLogger()
+    : mCells(new Cell[CAPACITY])
+{
+    for (size_t i = 0; i < CAPACITY; i++) {
+        mCells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    // Process exit without the matching stop calls
+    if (mThread.joinable()) {
+        mStartCount = 1;
+        stop();
+    }
+}
+
+bool AsyncLogger::start(const std::string& inFilePath, bool inMirrorToStdErr)
+{
+    std::lock_guard<std::mutex> start_lock(mStartMutex);
+
+    if (mStartCount > 0) {
+        mStartCount++;
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> write_lock(mWriteMutex);
+
+        std::error_code error;
+        const std::filesystem::path path(inFilePath);
+
+        if (path.has_parent_path()) {
+            std::filesystem::create_directories(path.parent_path(), error);
+        }
+
+        if (std::filesystem::exists(path, error) && std::filesystem::file_size(path, error) > MAX_FILE_SIZE) {
+            std::filesystem::rename(path, std::filesystem::path(inFilePath + ".old"), error);
+        }
+
+        mFile.open(path, std::ios::app);
+
+        if (!mFile.is_open()) {
+            return false;
+        }
+
+        mMirrorToStdErr = inMirrorToStdErr;
+    }
+
+    {
+        std::lock_guard<std::mutex> wake_up_lock(mWakeUpMutex);
+        mShouldStop = false;
+    }
+
+    mStartCount = 1;
+    mThread = std::thread([this] { _run(); });
+    mIsRunning.store(true);
+
+    return true;
+}
+
+void AsyncLogger::stop()
+{
+    std::lock_guard<std::mutex> start_lock(mStartMutex);
+
+    if (mStartCount == 0 || --mStartCount > 0) {
+        return;
+    }
+
+    mIsRunning.store(false);
+
+    {
+        std::lock_guard<std::mutex> wake_up_lock(mWakeUpMutex);
+        mShouldStop = true;
+    }
+
+    mWakeUp.notify_one();
+
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+
+    flush();
+
+    std::lock_guard<std::mutex> write_lock(mWriteMutex);
+    mFile.close();
+}
+
+void AsyncLogger::setMinLevel(Level inLevel)
+{
+    mMinLevel.store(static_cast<int>(inLevel));
+}
+
+void AsyncLogger::setCategoryEnabled(Category inCategory, bool inEnabled)
+{
+    const auto bit = 1u << static_cast<unsigned>(inCategory);
+
+    if (inEnabled) {
+        mCategoryMask.fetch_or(bit);
+    } else {
+        mCategoryMask.fetch_and(~bit);
+    }
+}
+
+void AsyncLogger::flush()
+{
+    std::lock_guard<std::mutex> write_lock(mWriteMutex);
+
+    Record record;
+    bool has_written = false;
+
+    while (_pop(record)) {
+        _write(record);
+        has_written = true;
+    }
+
+    const auto num_dropped = mNumDropped.load(std::memory_order_relaxed);
+
+    if (num_dropped != mNumDroppedReported) {
+        Record dropped_record;
+        dropped_record.timestampMs = _getTimestampMs();
+        dropped_record.level = Level::Warning;
+        dropped_record.category = Category::NumCategories;
+        dropped_record.format = "{} log messages dropped (buffer full)";
+        _addArg(dropped_record, num_dropped - mNumDroppedReported);
+        _write(dropped_record);
+
+        mNumDroppedReported = num_dropped;
+        has_written = true;
+    }
+
+    if (has_written && mFile.is_open()) {
+        mFile.flush();
+    }
+}
+
+void AsyncLogger::_addText(Record& ioRecord, Arg& outArg, const char* inText, size_t inSize)
+{
+    outArg.type = Arg::Type::Text;
+    outArg.textOffset = ioRecord.textSize;
+
+    // Keep room for the terminating zero
+    const size_t size = std::min(inSize, TEXT_SIZE - 1 - ioRecord.textSize);
+    std::memcpy(ioRecord.text + ioRecord.textSize, inText, size);
+    ioRecord.textSize = static_cast<uint16_t>(ioRecord.textSize + size);
+    ioRecord.text[ioRecord.textSize] = '\0';
+
+    if (ioRecord.textSize < TEXT_SIZE - 1) {
+        ioRecord.textSize++;
+    }
+}
+
+int64_t AsyncLogger::_getTimestampMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+bool AsyncLogger::_push(const Record& inRecord)
+{
+    // Bounded multi-producer queue (D. Vyukov): the sequence of a cell tells whether it is free for the position
+    size_t position = mEnqueuePosition.load(std::memory_order_relaxed);
+    Cell* cell;
+
+    while (true) {
+        cell = &mCells[position & (CAPACITY - 1)];
+        const auto sequence = cell->sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+        if (difference == 0) {
+            if (mEnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // Full
+            return false;
+        } else {
+            position = mEnqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->record = inRecord;
+    cell->sequence.store(position + 1, std::memory_order_release);
+
+    return true;
+}
+
+bool AsyncLogger::_pop(Record& outRecord)
+{
+    auto& cell = mCells[mDequeuePosition & (CAPACITY - 1)];
+    const auto sequence = cell.sequence.load(std::memory_order_acquire);
+
+    if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(mDequeuePosition + 1) < 0) {
+        // Empty, or the producer has not finished writing this cell yet
+        return false;
+    }
+
+    outRecord = cell.record;
+    cell.sequence.store(mDequeuePosition + CAPACITY, std::memory_order_release);
+    mDequeuePosition++;
+
+    return true;
+}
+
+void AsyncLogger::_run()
+{
+    std::unique_lock<std::mutex> wake_up_lock(mWakeUpMutex);
+
+    while (!mShouldStop) {
+        // Producers never notify (no system call on the audio thread): poll
+        mWakeUp.wait_for(wake_up_lock, std::chrono::milliseconds(FLUSH_INTERVAL_MS));
+
+        wake_up_lock.unlock();
+        flush();
+        wake_up_lock.lock();
+    }
+}
+
+void AsyncLogger::_write(const Record& inRecord)
+{
+    const auto line = _format(inRecord);
+
+    if (mFile.is_open()) {
+        mFile << line << '\n';
+    }
+
+    if (mMirrorToStdErr) {
+        std::cerr << line << std::endl;
+    }
+}
+
+std::string AsyncLogger::_format(const Record& inRecord)
+{
+    const auto seconds = static_cast<std::time_t>(inRecord.timestampMs / 1000);
+    std::tm local_time {};
+#if defined(_WIN32)
+    localtime_s(&local_time, &seconds);
+#else
+    localtime_r(&seconds, &local_time);
+#endif
+
+    char prefix[64];
+    const auto prefix_size = std::strftime(prefix, sizeof(prefix), "%Y-%m-%d %H:%M:%S", &local_time);
+    std::snprintf(
+        prefix + prefix_size, sizeof(prefix) - prefix_size, ".%03d ", static_cast<int>(inRecord.timestampMs % 1000));
+
+    std::string line = prefix;
+    line += "[";
+    line += toString(inRecord.level);
+    line += "] ";
+
+    if (inRecord.category != Category::NumCategories) {
+        line += "[";
+        line += toString(inRecord.category);
+        line += "] ";
+    }
+
+    size_t arg_index = 0;
+
+    for (const char* c = inRecord.format; *c != '\0'; c++) {
+        if (c[0] == '{' && c[1] == '}' && arg_index < inRecord.numArgs) {
+            const auto& arg = inRecord.args[arg_index++];
+
+            switch (arg.type) {
+                case Arg::Type::Int:
+                    line += std::to_string(arg.intValue);
+                    break;
+                case Arg::Type::Double: {
+                    char number[32];
+                    std::snprintf(number, sizeof(number), "%g", arg.doubleValue);
+                    line += number;
+                    break;
+                }
+                case Arg::Type::Text:
+                    line += inRecord.text + arg.textOffset;
+                    break;
+            }
+
+            c++;
+        } else {
+            line += *c;
+        }
+    }
+
+    return line;
+}
+
+} // namespace Log
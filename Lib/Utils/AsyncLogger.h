@@ -0,0 +1,204 @@
+#ifndef AsyncLogger_h
+#define AsyncLogger_h
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+namespace Log
+{
+enum class Level { Debug = 0, Info, Warning, Error };
+
+enum class Category { Recording = 0, Transcription, Whisper, UI, NumCategories };
+
+/**
+ * Process wide logger that can be called from any thread, including the audio thread.
+ *
+ * Logging a message copies its format string pointer, its arguments and a timestamp into a preallocated lock-free
+ * ring buffer, without allocating or locking. A background thread formats the messages and writes them to the log
+ * file. Messages are dropped (and counted) when the ring buffer is full, instead of blocking the caller.
+ * Use it through the NN_LOG_* macros so that arguments are not evaluated when the level or category is disabled.
+ *
+ * The format string must be a string literal: it is read later by the background thread. Each {} is replaced by the
+ * next argument. Arguments can be integers, floating point numbers, bools, const char* and std::string. String
+ * arguments are copied, truncated to the space left in the message.
+ */
+class AsyncLogger
+{
+public:
+    static constexpr size_t CAPACITY = 1024; // Number of messages, power of 2
+    static constexpr size_t MAX_NUM_ARGS = 4;
+    static constexpr size_t TEXT_SIZE = 96; // Storage for the string arguments of a message
+
+    static AsyncLogger& getInstance();
+
+    ~AsyncLogger();
+
+    /**
+     * Start writing to a log file (appended). Calls are reference counted so that several plugin instances can share
+     * the logger: the first call opens the file and starts the background thread, later ones only increment the count.
+     * @param inFilePath Log file. Renamed with a .old extension first if larger than MAX_FILE_SIZE.
+     * @param inMirrorToStdErr Also write the messages to stderr (e.g. in debug builds)
+     * @return Whether the file could be opened (or the logger was already started)
+     */
+    bool start(const std::string& inFilePath, bool inMirrorToStdErr);
+
+    /**
+     * Decrement the start count. The last call writes the pending messages, stops the thread and closes the file.
+     */
+    void stop();
+
+    void setMinLevel(Level inLevel);
+
+    void setCategoryEnabled(Category inCategory, bool inEnabled);
+
+    bool isEnabled(Level inLevel, Category inCategory) const
+    {
+        return mIsRunning.load(std::memory_order_relaxed)
+               && static_cast<int>(inLevel) >= mMinLevel.load(std::memory_order_relaxed)
+               && (mCategoryMask.load(std::memory_order_relaxed) & (1u << static_cast<unsigned>(inCategory))) != 0;
+    }
+
+    template <typename... Args>
+    void log(Level inLevel, Category inCategory, const char* inFormat, const Args&... inArgs)
+    {
+        static_assert(sizeof...(Args) <= MAX_NUM_ARGS, "Too many log arguments");
+
+        Record record;
+        record.timestampMs = _getTimestampMs();
+        record.level = inLevel;
+        record.category = inCategory;
+        record.format = inFormat;
+        (_addArg(record, inArgs), ...);
+
+        if (!_push(record)) {
+            mNumDropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Format and write the pending messages now, from the calling thread. Used by stop and the tests.
+     */
+    void flush();
+
+    /**
+     * @return Number of messages dropped because the ring buffer was full, since the logger was created.
+     */
+    uint64_t getNumDropped() const { return mNumDropped.load(std::memory_order_relaxed); }
+
+    static constexpr uint64_t MAX_FILE_SIZE = 4 * 1024 * 1024;
+
+private:
+    AsyncLogger();
+
+    struct Arg {
+        enum class Type : uint8_t { Int, Double, Text };
+
+        Type type = Type::Int;
+        union {
+            int64_t intValue;
+            double doubleValue;
+            uint16_t textOffset;
+        };
+    };
+
+    struct Record {
+        int64_t timestampMs = 0;
+        Level level = Level::Info;
+        Category category = Category::Transcription;
+        const char* format = nullptr;
+        std::array<Arg, MAX_NUM_ARGS> args;
+        uint8_t numArgs = 0;
+        uint16_t textSize = 0;
+        char text[TEXT_SIZE];
+    };
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        Record record;
+    };
+
+    template <typename T>
+    static void _addArg(Record& ioRecord, const T& inValue)
+    {
+        auto& arg = ioRecord.args[ioRecord.numArgs++];
+
+        if constexpr (std::is_same_v<T, std::string>) {
+            _addText(ioRecord, arg, inValue.c_str(), inValue.size());
+        } else if constexpr (std::is_convertible_v<T, const char*>) {
+            const char* text = inValue;
+            _addText(ioRecord, arg, text != nullptr ? text : "", text != nullptr ? std::strlen(text) : 0);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            arg.type = Arg::Type::Double;
+            arg.doubleValue = static_cast<double>(inValue);
+        } else {
+            static_assert(std::is_integral_v<T> || std::is_enum_v<T>, "Unsupported log argument type");
+            arg.type = Arg::Type::Int;
+            arg.intValue = static_cast<int64_t>(inValue);
+        }
+    }
+
+    static void _addText(Record& ioRecord, Arg& outArg, const char* inText, size_t inSize);
+
+    static int64_t _getTimestampMs();
+
+    bool _push(const Record& inRecord);
+
+    bool _pop(Record& outRecord);
+
+    void _run();
+
+    void _write(const Record& inRecord);
+
+    static std::string _format(const Record& inRecord);
+
+    std::unique_ptr<Cell[]> mCells;
+    alignas(64) std::atomic<size_t> mEnqueuePosition {0};
+    // Only accessed by the thread writing the messages (under mWriteMutex)
+    alignas(64) size_t mDequeuePosition = 0;
+
+    std::atomic<bool> mIsRunning {false};
+    std::atomic<int> mMinLevel {static_cast<int>(Level::Info)};
+    std::atomic<unsigned> mCategoryMask {(1u << static_cast<unsigned>(Category::NumCategories)) - 1};
+    std::atomic<uint64_t> mNumDropped {0};
+    uint64_t mNumDroppedReported = 0;
+
+    std::mutex mStartMutex;
+    int mStartCount = 0;
+
+    std::mutex mWriteMutex;
+    std::ofstream mFile;
+    bool mMirrorToStdErr = false;
+
+    std::mutex mWakeUpMutex;
+    std::condition_variable mWakeUp;
+    bool mShouldStop = false;
+    std::thread mThread;
+
+    static constexpr int FLUSH_INTERVAL_MS = 100;
+};
+
+} // namespace Log
+
+#define NN_LOG(level, category, format, ...)                                                                          \
+    do {                                                                                                               \
+        auto& nn_logger = Log::AsyncLogger::getInstance();                                                             \
+        if (nn_logger.isEnabled(level, category))                                                                      \
+            nn_logger.log(level, category, "" format, ##__VA_ARGS__);                                                  \
+    } while (false)
+
+#define NN_LOG_DEBUG(category, format, ...) NN_LOG(Log::Level::Debug, Log::Category::category, format, ##__VA_ARGS__)
+#define NN_LOG_INFO(category, format, ...) NN_LOG(Log::Level::Info, Log::Category::category, format, ##__VA_ARGS__)
+#define NN_LOG_WARNING(category, format, ...)                                                                         \
+    NN_LOG(Log::Level::Warning, Log::Category::category, format, ##__VA_ARGS__)
+#define NN_LOG_ERROR(category, format, ...) NN_LOG(Log::Level::Error, Log::Category::category, format, ##__VA_ARGS__)
+
+#endif // AsyncLogger_h
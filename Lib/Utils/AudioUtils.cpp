@@ -92,6 +92,24 @@ void resampleBuffer(const AudioBuffer<float>& inBuffer,
     }
 }
 
+void downmixToMono(const AudioBuffer<float>& inBuffer, AudioBuffer<float>& outBuffer)
+{
+    outBuffer.setSize(1, inBuffer.getNumSamples());
+
+    if (inBuffer.getNumChannels() == 0) {
+        outBuffer.clear();
+        return;
+    }
+
+    outBuffer.copyFrom(0, 0, inBuffer, 0, 0, inBuffer.getNumSamples());
+
+    for (int ch = 1; ch < inBuffer.getNumChannels(); ch++) {
+        outBuffer.addFrom(0, 0, inBuffer, ch, 0, inBuffer.getNumSamples());
+    }
+
+    outBuffer.applyGain(1.0f / static_cast<float>(inBuffer.getNumChannels()));
+}
+
 bool _loadMP3File(const std::string& filename, juce::AudioBuffer<float>& outBuffer, double& outSampleRate)
 {
     mp3dec_t mp3d;
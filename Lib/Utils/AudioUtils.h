@@ -53,6 +53,13 @@ void resampleBuffer(const AudioBuffer<float>& inBuffer,
                     double inSourceSampleRate,
                     double inTargetSampleRate);
 
+/**
+ * Average all channels of an audio buffer into a single channel.
+ * @param inBuffer Audio buffer to downmix
+ * @param outBuffer Mono buffer. Will be resized to one channel and the number of samples of inBuffer.
+ */
+void downmixToMono(const AudioBuffer<float>& inBuffer, AudioBuffer<float>& outBuffer);
+
 /**
  * Load an mp3 file
  * @param filename path to mp3 file to read
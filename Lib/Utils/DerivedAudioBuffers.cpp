@@ -0,0 +1,113 @@
+#include "DerivedAudioBuffers.h"
+
+DerivedAudioBuffers::DerivedAudioBuffers(uint64_t inMemoryBudget)
+    : mMemoryBudget(inMemoryBudget)
+{
+}
+
+void DerivedAudioBuffers::setComputeFunction(Type inType, ComputeFunction inCompute)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    auto& entry = mEntries[static_cast<size_t>(inType)];
+    entry.compute = std::move(inCompute);
+    entry.buffer.reset();
+}
+
+void DerivedAudioBuffers::setBuffer(Type inType, Buffer inBuffer)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    auto& entry = mEntries[static_cast<size_t>(inType)];
+    entry.buffer = std::move(inBuffer);
+    entry.lastAcquired = ++mNumAcquired;
+}
+
+DerivedAudioBuffers::Buffer DerivedAudioBuffers::acquire(Type inType)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    auto& entry = mEntries[static_cast<size_t>(inType)];
+
+    if (entry.buffer == nullptr) {
+        if (!entry.compute) {
+            return nullptr;
+        }
+
+        entry.buffer = entry.compute();
+
+        if (entry.buffer == nullptr) {
+            return nullptr;
+        }
+    }
+
+    entry.lastAcquired = ++mNumAcquired;
+
+    return entry.buffer;
+}
+
+bool DerivedAudioBuffers::isResident(Type inType) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mEntries[static_cast<size_t>(inType)].buffer != nullptr;
+}
+
+void DerivedAudioBuffers::trim()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    // Only the registry holds a buffer when its use count is 1. Evicting a buffer also held elsewhere, e.g. by another
+    // instance sharing it, would not free it.
+    auto is_unused = [](const Entry& inEntry) { return inEntry.buffer != nullptr && inEntry.buffer.use_count() == 1; };
+
+    uint64_t unused_bytes = 0;
+
+    for (const auto& entry: mEntries) {
+        if (is_unused(entry)) {
+            unused_bytes += getNumBytes(*entry.buffer);
+        }
+    }
+
+    while (unused_bytes > mMemoryBudget) {
+        Entry* least_recent = nullptr;
+
+        for (auto& entry: mEntries) {
+            if (is_unused(entry) && (least_recent == nullptr || entry.lastAcquired < least_recent->lastAcquired)) {
+                least_recent = &entry;
+            }
+        }
+
+        unused_bytes -= getNumBytes(*least_recent->buffer);
+        least_recent->buffer.reset();
+    }
+}
+
+void DerivedAudioBuffers::clear()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    for (auto& entry: mEntries) {
+        entry.buffer.reset();
+    }
+}
+
+uint64_t DerivedAudioBuffers::getResidentBytes() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    uint64_t num_bytes = 0;
+
+    for (const auto& entry: mEntries) {
+        if (entry.buffer != nullptr) {
+            num_bytes += getNumBytes(*entry.buffer);
+        }
+    }
+
+    return num_bytes;
+}
+
+uint64_t DerivedAudioBuffers::getNumBytes(const AudioBuffer<float>& inBuffer)
+{
+    return static_cast<uint64_t>(inBuffer.getNumChannels()) * static_cast<uint64_t>(inBuffer.getNumSamples())
+           * sizeof(float);
+}
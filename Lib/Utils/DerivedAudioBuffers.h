@@ -0,0 +1,88 @@
+#ifndef DerivedAudioBuffers_h
+#define DerivedAudioBuffers_h
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include <JuceHeader.h>
+
+/**
+ * Audio buffers derived from the source audio, e.g. resampled for the transcription or for Whisper. A buffer is
+ * computed on the first request and shared by all the consumers holding it. Once no consumer holds it anymore, trim()
+ * can evict it to fit in the memory budget, and it is computed again on the next request.
+ * Buffers can be requested from any thread except the audio thread.
+ */
+class DerivedAudioBuffers
+{
+public:
+    enum class Type { Transcription = 0, Whisper, NumTypes };
+
+    static constexpr size_t NUM_TYPES = static_cast<size_t>(Type::NumTypes);
+
+    using Buffer = std::shared_ptr<AudioBuffer<float>>;
+
+    /**
+     * Computes a buffer, or gets it from elsewhere, e.g. a cache shared with other instances. Called with the registry
+     * locked: must not call back into the registry. Can return nullptr if the buffer cannot be computed.
+     */
+    using ComputeFunction = std::function<Buffer()>;
+
+    /**
+     * @param inMemoryBudget Number of bytes the buffers no consumer holds may keep resident.
+     */
+    explicit DerivedAudioBuffers(uint64_t inMemoryBudget);
+
+    /**
+     * Set how a type is computed. Drops the buffer computed with the previous function, if any.
+     */
+    void setComputeFunction(Type inType, ComputeFunction inCompute);
+
+    /**
+     * Provide a buffer computed elsewhere, e.g. recorded directly at the right sample rate. If evicted, it will be
+     * computed again with the compute function.
+     */
+    void setBuffer(Type inType, Buffer inBuffer);
+
+    /**
+     * Get a buffer, computing it first if not resident. The buffer is shared and must not be modified. It stays in
+     * memory as long as the returned pointer is held.
+     * @return The buffer, or nullptr if not resident and it cannot be computed.
+     */
+    Buffer acquire(Type inType);
+
+    bool isResident(Type inType) const;
+
+    /**
+     * Evict buffers no consumer holds, least recently acquired first, until they fit in the memory budget.
+     */
+    void trim();
+
+    /**
+     * Drop all buffers. Consumers still holding one keep it until they release it. Compute functions are kept.
+     */
+    void clear();
+
+    /**
+     * @return Number of bytes of the buffers held by the registry, whether consumers hold them or not.
+     */
+    uint64_t getResidentBytes() const;
+
+    static uint64_t getNumBytes(const AudioBuffer<float>& inBuffer);
+
+private:
+    struct Entry {
+        ComputeFunction compute;
+        Buffer buffer;
+        uint64_t lastAcquired = 0;
+    };
+
+    mutable std::mutex mMutex;
+    std::array<Entry, NUM_TYPES> mEntries;
+    const uint64_t mMemoryBudget;
+    uint64_t mNumAcquired = 0;
+};
+
+#endif // DerivedAudioBuffers_h
@@ -0,0 +1,163 @@
+#include "NoteEvaluation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace NoteEvaluation
+{
+
+namespace
+{
+// Same rounding guard as mir_eval to avoid floating point errors at the tolerance boundaries
+constexpr double toleranceEpsilon = 1e-9;
+
+bool isCandidate(const Note& inRef, const Note& inEst, const MatchingParams& inParams)
+{
+    if (inRef.pitch != inEst.pitch) {
+        return false;
+    }
+
+    if (std::abs(inRef.onset - inEst.onset) > inParams.onsetTolerance + toleranceEpsilon) {
+        return false;
+    }
+
+    if (inParams.matchOffsets) {
+        const double offset_tolerance =
+            std::max(inParams.offsetRatio * (inRef.offset - inRef.onset), inParams.offsetMinTolerance);
+
+        if (std::abs(inRef.offset - inEst.offset) > offset_tolerance + toleranceEpsilon) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool findAugmentingPath(size_t inRef,
+                        const std::vector<std::vector<size_t>>& inCandidates,
+                        std::vector<bool>& ioVisited,
+                        std::vector<size_t>& ioEstToRef,
+                        std::vector<size_t>& ioRefToEst)
+{
+    constexpr size_t unmatched = static_cast<size_t>(-1);
+
+    for (auto est: inCandidates[inRef]) {
+        if (ioVisited[est]) {
+            continue;
+        }
+
+        ioVisited[est] = true;
+
+        if (ioEstToRef[est] == unmatched
+            || findAugmentingPath(ioEstToRef[est], inCandidates, ioVisited, ioEstToRef, ioRefToEst)) {
+            ioEstToRef[est] = inRef;
+            ioRefToEst[inRef] = est;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+Scores makeScores(size_t inNumReference, size_t inNumEstimated, size_t inNumMatched)
+{
+    Scores scores;
+    scores.numReference = inNumReference;
+    scores.numEstimated = inNumEstimated;
+    scores.numMatched = inNumMatched;
+
+    scores.precision = inNumEstimated > 0 ? static_cast<double>(inNumMatched) / inNumEstimated : 0.0;
+    scores.recall = inNumReference > 0 ? static_cast<double>(inNumMatched) / inNumReference : 0.0;
+
+    if (scores.precision + scores.recall > 0.0) {
+        scores.f1 = 2.0 * scores.precision * scores.recall / (scores.precision + scores.recall);
+    }
+
+    return scores;
+}
+} // namespace
+
+std::vector<std::pair<size_t, size_t>> matchNotes(const std::vector<Note>& inReference,
+                                                  const std::vector<Note>& inEstimated,
+                                                  const MatchingParams& inParams)
+{
+    constexpr size_t unmatched = static_cast<size_t>(-1);
+
+    // Estimated notes sorted by onset so candidates of a reference note are found in its onset window only
+    std::vector<size_t> est_by_onset(inEstimated.size());
+    std::iota(est_by_onset.begin(), est_by_onset.end(), 0);
+    std::sort(est_by_onset.begin(), est_by_onset.end(), [&inEstimated](size_t a, size_t b) {
+        return inEstimated[a].onset < inEstimated[b].onset;
+    });
+
+    std::vector<std::vector<size_t>> candidates(inReference.size());
+
+    for (size_t ref = 0; ref < inReference.size(); ref++) {
+        const double window_start = inReference[ref].onset - inParams.onsetTolerance - toleranceEpsilon;
+
+        auto it = std::lower_bound(
+            est_by_onset.begin(), est_by_onset.end(), window_start, [&inEstimated](size_t est, double time) {
+                return inEstimated[est].onset < time;
+            });
+
+        for (; it != est_by_onset.end(); ++it) {
+            if (inEstimated[*it].onset > inReference[ref].onset + inParams.onsetTolerance + toleranceEpsilon) {
+                break;
+            }
+
+            if (isCandidate(inReference[ref], inEstimated[*it], inParams)) {
+                candidates[ref].push_back(*it);
+            }
+        }
+    }
+
+    // Maximum bipartite matching (augmenting paths)
+    std::vector<size_t> est_to_ref(inEstimated.size(), unmatched);
+    std::vector<size_t> ref_to_est(inReference.size(), unmatched);
+    std::vector<bool> visited(inEstimated.size());
+
+    for (size_t ref = 0; ref < inReference.size(); ref++) {
+        if (candidates[ref].empty()) {
+            continue;
+        }
+
+        std::fill(visited.begin(), visited.end(), false);
+        findAugmentingPath(ref, candidates, visited, est_to_ref, ref_to_est);
+    }
+
+    std::vector<std::pair<size_t, size_t>> matches;
+
+    for (size_t ref = 0; ref < inReference.size(); ref++) {
+        if (ref_to_est[ref] != unmatched) {
+            matches.emplace_back(ref, ref_to_est[ref]);
+        }
+    }
+
+    return matches;
+}
+
+Scores computeScores(const std::vector<Note>& inReference,
+                     const std::vector<Note>& inEstimated,
+                     const MatchingParams& inParams)
+{
+    auto matches = matchNotes(inReference, inEstimated, inParams);
+    return makeScores(inReference.size(), inEstimated.size(), matches.size());
+}
+
+Scores accumulateScores(const std::vector<Scores>& inScores)
+{
+    size_t num_reference = 0;
+    size_t num_estimated = 0;
+    size_t num_matched = 0;
+
+    for (const auto& scores: inScores) {
+        num_reference += scores.numReference;
+        num_estimated += scores.numEstimated;
+        num_matched += scores.numMatched;
+    }
+
+    return makeScores(num_reference, num_estimated, num_matched);
+}
+
+} // namespace NoteEvaluation
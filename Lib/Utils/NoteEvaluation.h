@@ -0,0 +1,63 @@
+#ifndef NoteEvaluation_h
+#define NoteEvaluation_h
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * Note-level transcription metrics, following mir_eval.transcription: an estimated note matches a reference note if
+ * they have the same pitch, their onsets are within a tolerance and, optionally, their offsets are within a tolerance
+ * proportional to the reference note duration. Notes are matched one-to-one with a maximum bipartite matching.
+ */
+namespace NoteEvaluation
+{
+
+struct Note {
+    double onset; // Seconds
+    double offset; // Seconds
+    int pitch; // MIDI note number
+};
+
+struct MatchingParams {
+    double onsetTolerance = 0.05; // Seconds
+    bool matchOffsets = true;
+    double offsetRatio = 0.2; // Fraction of the reference note duration
+    double offsetMinTolerance = 0.05; // Seconds
+};
+
+struct Scores {
+    double precision = 0.0;
+    double recall = 0.0;
+    double f1 = 0.0;
+    size_t numReference = 0;
+    size_t numEstimated = 0;
+    size_t numMatched = 0;
+};
+
+/**
+ * Match estimated notes to reference notes.
+ * @param inReference Ground truth notes
+ * @param inEstimated Transcribed notes
+ * @param inParams Matching tolerances
+ * @return Pairs (reference index, estimated index) of matched notes
+ */
+std::vector<std::pair<size_t, size_t>> matchNotes(const std::vector<Note>& inReference,
+                                                  const std::vector<Note>& inEstimated,
+                                                  const MatchingParams& inParams);
+
+/**
+ * Precision, recall and F-measure of the estimated notes.
+ */
+Scores computeScores(const std::vector<Note>& inReference,
+                     const std::vector<Note>& inEstimated,
+                     const MatchingParams& inParams);
+
+/**
+ * Sum the counts of several files and recompute precision, recall and F-measure over the whole set.
+ */
+Scores accumulateScores(const std::vector<Scores>& inScores);
+
+} // namespace NoteEvaluation
+
+#endif // NoteEvaluation_h
@@ -0,0 +1,56 @@
+#ifndef NN_NOTEUTILSCORE_H
+#define NN_NOTEUTILSCORE_H
+
+#include <cmath>
+
+/**
+ * Part of NoteUtils without JUCE dependency, used by the note creation and post-processing of the core library.
+ * NoteUtils.h adds the display names.
+ */
+namespace NoteUtils
+{
+enum RootNote { A = 0, A_sharp, B, C, C_sharp, D, D_sharp, E, F_sharp, F, G_sharp, G, TotalNumRootNotes };
+
+enum ScaleType {
+    Chromatic = 0,
+    Major,
+    Minor,
+    Dorian,
+    Mixolydian,
+    Lydian,
+    Phrygian,
+    Locrian,
+    MinorBlues,
+    MinorPentatonic,
+    MajorPentatonic,
+    MelodicMinor,
+    HarmonicMinor,
+    HarmonicMajor,
+    TotalNumScaleTypes
+};
+
+enum SnapMode { Adjust = 0, Remove };
+
+/**
+ * Return closest midi note number to frequency
+ * @param hz Input frequency
+ * @return Closest midi note number
+ */
+static inline int hzToMidi(float hz)
+{
+    return (int) std::round(12.0f * std::log2(hz / 440.0f) + 69.0f);
+}
+
+/**
+ * Compute frequency in Hz corresponding to given midi note
+ * @param inMidiNote Midi note number
+ * @return Frequency in Hz
+ */
+static inline float midiToHz(float inMidiNote)
+{
+    return 440.0f * std::pow(2.0f, (inMidiNote - 69.0f) / 12.0f);
+}
+
+} // namespace NoteUtils
+
+#endif // NN_NOTEUTILSCORE_H
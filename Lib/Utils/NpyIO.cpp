@@ -0,0 +1,217 @@
+#include "NpyIO.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+namespace NpyIO
+{
+
+namespace
+{
+constexpr char magic[] = "\x93NUMPY";
+constexpr size_t magicSize = 6;
+// Total header size (magic, version, length and dictionary) is padded to a multiple of this for aligned memory maps
+constexpr size_t headerAlignment = 64;
+
+std::string getDictionaryValue(const std::string& inHeader, const std::string& inKey)
+{
+    auto key_pos = inHeader.find("'" + inKey + "'");
+
+    if (key_pos == std::string::npos) {
+        return {};
+    }
+
+    auto value_start = inHeader.find(':', key_pos);
+
+    if (value_start == std::string::npos) {
+        return {};
+    }
+
+    value_start = inHeader.find_first_not_of(' ', value_start + 1);
+
+    if (value_start == std::string::npos) {
+        return {};
+    }
+
+    // Shape is a tuple, other values do not contain commas
+    auto value_end = inHeader[value_start] == '(' ? inHeader.find(')', value_start) + 1
+                                                   : inHeader.find_first_of(",}", value_start);
+
+    if (value_end == std::string::npos || value_end <= value_start) {
+        return {};
+    }
+
+    return inHeader.substr(value_start, value_end - value_start);
+}
+
+bool parseShape(const std::string& inShape, std::vector<size_t>& outShape)
+{
+    outShape.clear();
+
+    if (inShape.size() < 2 || inShape.front() != '(' || inShape.back() != ')') {
+        return false;
+    }
+
+    size_t pos = 1;
+
+    while (pos < inShape.size() - 1) {
+        pos = inShape.find_first_of("0123456789", pos);
+
+        if (pos == std::string::npos || pos >= inShape.size() - 1) {
+            break;
+        }
+
+        size_t num_chars = 0;
+        outShape.push_back(std::stoull(inShape.substr(pos), &num_chars));
+        pos += num_chars;
+    }
+
+    return true;
+}
+} // namespace
+
+bool writeMatrix(const std::string& inPath,
+                 const std::vector<std::vector<float>>& inMatrix,
+                 size_t inNumColumns,
+                 std::string& outError)
+{
+    for (const auto& row: inMatrix) {
+        if (row.size() != inNumColumns) {
+            outError = "All rows must have " + std::to_string(inNumColumns) + " values";
+            return false;
+        }
+    }
+
+    std::string header = "{'descr': '<f4', 'fortran_order': False, 'shape': (" + std::to_string(inMatrix.size()) + ", "
+                         + std::to_string(inNumColumns) + "), }";
+
+    // Magic, version (2 bytes), header length (2 bytes), header terminated by a newline
+    const size_t preamble_size = magicSize + 4;
+    const size_t padded_size = (preamble_size + header.size() + 1 + headerAlignment - 1) / headerAlignment
+                               * headerAlignment;
+    header.append(padded_size - preamble_size - header.size() - 1, ' ');
+    header.push_back('\n');
+
+    std::ofstream stream(inPath, std::ios::binary | std::ios::trunc);
+
+    if (!stream) {
+        outError = "Could not open " + inPath + " for writing";
+        return false;
+    }
+
+    const auto header_size = static_cast<uint16_t>(header.size());
+    const char version_and_size[4] = {
+        1, 0, static_cast<char>(header_size & 0xFF), static_cast<char>((header_size >> 8) & 0xFF)};
+
+    stream.write(magic, magicSize);
+    stream.write(version_and_size, 4);
+    stream.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    // Supported platforms are little endian, write the rows as they are in memory
+    for (const auto& row: inMatrix) {
+        stream.write(reinterpret_cast<const char*>(row.data()),
+                     static_cast<std::streamsize>(row.size() * sizeof(float)));
+    }
+
+    if (!stream) {
+        outError = "Could not write " + inPath;
+        return false;
+    }
+
+    return true;
+}
+
+bool readMatrix(const std::string& inPath,
+                std::vector<std::vector<float>>& outMatrix,
+                size_t& outNumColumns,
+                std::string& outError)
+{
+    std::ifstream stream(inPath, std::ios::binary);
+
+    if (!stream) {
+        outError = "Could not open " + inPath;
+        return false;
+    }
+
+    char preamble[magicSize + 2];
+    stream.read(preamble, sizeof(preamble));
+
+    if (!stream || std::memcmp(preamble, magic, magicSize) != 0) {
+        outError = inPath + " is not a .npy file";
+        return false;
+    }
+
+    const auto major_version = static_cast<uint8_t>(preamble[magicSize]);
+    size_t header_size = 0;
+
+    if (major_version == 1) {
+        unsigned char size_bytes[2];
+        stream.read(reinterpret_cast<char*>(size_bytes), 2);
+        header_size = size_bytes[0] | (size_bytes[1] << 8);
+    } else if (major_version == 2 || major_version == 3) {
+        unsigned char size_bytes[4];
+        stream.read(reinterpret_cast<char*>(size_bytes), 4);
+        header_size = size_bytes[0] | (size_bytes[1] << 8) | (size_bytes[2] << 16)
+                      | (static_cast<size_t>(size_bytes[3]) << 24);
+    } else {
+        outError = "Unsupported .npy version in " + inPath;
+        return false;
+    }
+
+    std::string header(header_size, '\0');
+    stream.read(header.data(), static_cast<std::streamsize>(header_size));
+
+    if (!stream) {
+        outError = "Truncated header in " + inPath;
+        return false;
+    }
+
+    const auto descr = getDictionaryValue(header, "descr");
+    const bool is_double = descr == "'<f8'";
+
+    if (descr != "'<f4'" && !is_double) {
+        outError = "Unsupported data type " + descr + " in " + inPath + " (expected little endian float32 or float64)";
+        return false;
+    }
+
+    if (getDictionaryValue(header, "fortran_order") != "False") {
+        outError = "Fortran order is not supported in " + inPath;
+        return false;
+    }
+
+    std::vector<size_t> shape;
+
+    if (!parseShape(getDictionaryValue(header, "shape"), shape) || shape.size() != 2) {
+        outError = "Expected a 2D matrix in " + inPath;
+        return false;
+    }
+
+    const size_t num_rows = shape[0];
+    outNumColumns = shape[1];
+
+    outMatrix.assign(num_rows, std::vector<float>(outNumColumns));
+
+    std::vector<double> double_row(is_double ? outNumColumns : 0);
+
+    for (auto& row: outMatrix) {
+        if (is_double) {
+            stream.read(reinterpret_cast<char*>(double_row.data()),
+                        static_cast<std::streamsize>(outNumColumns * sizeof(double)));
+            std::copy(double_row.begin(), double_row.end(), row.begin());
+        } else {
+            stream.read(reinterpret_cast<char*>(row.data()),
+                        static_cast<std::streamsize>(outNumColumns * sizeof(float)));
+        }
+
+        if (!stream) {
+            outError = "Truncated data in " + inPath;
+            outMatrix.clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace NpyIO
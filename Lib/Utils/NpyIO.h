@@ -0,0 +1,42 @@
+#ifndef NpyIO_h
+#define NpyIO_h
+
+#include <string>
+#include <vector>
+
+/**
+ * Read and write 2D float matrices in the NumPy .npy format (little endian, C order), so that they can be loaded with
+ * numpy.load, including with mmap_mode, and written back from Python.
+ */
+namespace NpyIO
+{
+
+/**
+ * Write a matrix as float32 to a .npy file.
+ * @param inPath Path of the file to write
+ * @param inMatrix One vector per row. All rows must have inNumColumns values.
+ * @param inNumColumns Number of columns, used as well when the matrix has no rows
+ * @param outError Set to the reason of the failure if false is returned
+ * @return Whether the file was written
+ */
+bool writeMatrix(const std::string& inPath,
+                 const std::vector<std::vector<float>>& inMatrix,
+                 size_t inNumColumns,
+                 std::string& outError);
+
+/**
+ * Read a 2D float32 or float64 matrix from a .npy file (format version 1, 2 or 3). Values are converted to float.
+ * @param inPath Path of the file to read
+ * @param outMatrix One vector per row
+ * @param outNumColumns Number of columns of the matrix
+ * @param outError Set to the reason of the failure if false is returned
+ * @return Whether the file was read
+ */
+bool readMatrix(const std::string& inPath,
+                std::vector<std::vector<float>>& outMatrix,
+                size_t& outNumColumns,
+                std::string& outError);
+
+} // namespace NpyIO
+
+#endif // NpyIO_h
@@ -0,0 +1,107 @@
+#include "ReadOnlyFileMapping.h"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+
+ReadOnlyFileMapping::ReadOnlyFileMapping(const std::filesystem::path& inPath)
+{
+    HANDLE file = CreateFileW(inPath.c_str(),
+                              GENERIC_READ,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS,
+                              nullptr);
+
+    if (file == INVALID_HANDLE_VALUE) {
+        mErrorMessage = "Failed to open file: " + inPath.string();
+        return;
+    }
+
+    mFileHandle = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        mErrorMessage = "Failed to get size of file or file is empty: " + inPath.string();
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        mErrorMessage = "Failed to create file mapping: " + inPath.string();
+        return;
+    }
+
+    mMappingHandle = mapping;
+    mData = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (mData == nullptr) {
+        mErrorMessage = "Failed to map file: " + inPath.string();
+        return;
+    }
+
+    mSize = static_cast<size_t>(size.QuadPart);
+}
+
+ReadOnlyFileMapping::~ReadOnlyFileMapping()
+{
+    if (mData != nullptr)
+        UnmapViewOfFile(mData);
+
+    if (mMappingHandle != nullptr)
+        CloseHandle(mMappingHandle);
+
+    if (mFileHandle != nullptr)
+        CloseHandle(mFileHandle);
+}
+
+#else
+
+ReadOnlyFileMapping::ReadOnlyFileMapping(const std::filesystem::path& inPath)
+{
+    int fd = ::open(inPath.c_str(), O_RDONLY);
+
+    if (fd < 0) {
+        mErrorMessage = "Failed to open file: " + inPath.string();
+        return;
+    }
+
+    struct stat file_stat {};
+    if (::fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0) {
+        mErrorMessage = "Failed to get size of file or file is empty: " + inPath.string();
+        ::close(fd);
+        return;
+    }
+
+    void* data = ::mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_SHARED, fd, 0);
+
+    // The mapping stays valid after the file descriptor is closed
+    ::close(fd);
+
+    if (data == MAP_FAILED) {
+        mErrorMessage = "Failed to map file: " + inPath.string();
+        return;
+    }
+
+    mData = data;
+    mSize = static_cast<size_t>(file_stat.st_size);
+}
+
+ReadOnlyFileMapping::~ReadOnlyFileMapping()
+{
+    if (mData != nullptr)
+        ::munmap(mData, mSize);
+}
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef ReadOnlyFileMapping_h
+#define ReadOnlyFileMapping_h
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+
+/**
+ * Read-only memory mapping of a whole file. Pages are loaded on first access and shared through the OS page cache
+ * between all processes mapping the same file. Does not depend on JUCE so it can be used by the model code.
+ */
+class ReadOnlyFileMapping
+{
+public:
+    /**
+     * Map the file. Check isValid() afterwards.
+     * @param inPath File to map.
+     */
+    explicit ReadOnlyFileMapping(const std::filesystem::path& inPath);
+
+    ~ReadOnlyFileMapping();
+
+    ReadOnlyFileMapping(const ReadOnlyFileMapping&) = delete;
+    ReadOnlyFileMapping& operator=(const ReadOnlyFileMapping&) = delete;
+
+    /**
+     * @return True if the file was mapped successfully.
+     */
+    bool isValid() const { return mData != nullptr; }
+
+    /**
+     * @return Pointer to the first byte of the file, or nullptr if the mapping failed.
+     */
+    const char* getData() const { return static_cast<const char*>(mData); }
+
+    /**
+     * @return Size of the file in bytes.
+     */
+    size_t getSize() const { return mSize; }
+
+    /**
+     * @return Why the mapping failed, empty if it succeeded.
+     */
+    const std::string& getErrorMessage() const { return mErrorMessage; }
+
+private:
+    void* mData = nullptr;
+    size_t mSize = 0;
+    std::string mErrorMessage;
+
+#if defined(_WIN32)
+    void* mFileHandle = nullptr;
+    void* mMappingHandle = nullptr;
+#endif
+};
+
+#endif // ReadOnlyFileMapping_h
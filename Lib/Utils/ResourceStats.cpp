@@ -0,0 +1,238 @@
+#include "ResourceStats.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace ResourceStats
+{
+
+namespace
+{
+void appendSnapshot(std::ostringstream& ioStream, const Snapshot& inSnapshot, const std::string& inIndent)
+{
+    ioStream << "{\n" << inIndent << "  \"name\": \"" << inSnapshot.name << "\",\n";
+    ioStream << inIndent << "  \"total_bytes\": " << inSnapshot.getTotalBytes() << ",\n";
+    ioStream << inIndent << "  \"bytes\": {";
+
+    for (size_t i = 0; i < NUM_MEMORY_TYPES; i++) {
+        ioStream << (i == 0 ? "" : ", ") << "\"" << getName(static_cast<Memory>(i)) << "\": " << inSnapshot.bytes[i];
+    }
+
+    ioStream << "},\n" << inIndent << "  \"jobs\": {";
+
+    for (size_t i = 0; i < NUM_JOB_TYPES; i++) {
+        const auto& job = inSnapshot.jobs[i];
+        ioStream << (i == 0 ? "" : ",") << "\n"
+                 << inIndent << "    \"" << getName(static_cast<Job>(i)) << "\": {\"count\": " << job.count
+                 << ", \"total_ms\": " << job.totalMs << ", \"last_ms\": " << job.lastMs
+                 << ", \"max_ms\": " << job.maxMs << "}";
+    }
+
+    ioStream << "\n" << inIndent << "  }\n" << inIndent << "}";
+}
+} // namespace
+
+const char* getName(Memory inMemory)
+{
+    switch (inMemory) {
+        case Memory::SourceAudio:
+            return "source_audio";
+        case Memory::Posteriorgrams:
+            return "posteriorgrams";
+        case Memory::NotesScratch:
+            return "notes_scratch";
+        case Memory::Whisper:
+            return "whisper";
+        case Memory::Caches:
+            return "caches";
+        case Memory::NumTypes:
+            break;
+    }
+
+    return "";
+}
+
+const char* getName(Job inJob)
+{
+    switch (inJob) {
+        case Job::Transcription:
+            return "transcription";
+        case Job::TextTranscription:
+            return "text_transcription";
+        case Job::BatchTranscription:
+            return "batch_transcription";
+        case Job::NumTypes:
+            break;
+    }
+
+    return "";
+}
+
+uint64_t Snapshot::getTotalBytes() const
+{
+    uint64_t total = 0;
+
+    for (auto num_bytes: bytes) {
+        total += num_bytes;
+    }
+
+    return total;
+}
+
+InstanceStats::InstanceStats()
+{
+    mName = Registry::getInstance()._add(this);
+}
+
+InstanceStats::~InstanceStats()
+{
+    Registry::getInstance()._remove(this);
+}
+
+void InstanceStats::setBytes(Memory inMemory, uint64_t inNumBytes)
+{
+    mBytes[static_cast<size_t>(inMemory)].store(inNumBytes, std::memory_order_relaxed);
+}
+
+void InstanceStats::addJob(Job inJob, double inDurationMs)
+{
+    std::lock_guard<std::mutex> lock(mJobsMutex);
+
+    auto& job = mJobs[static_cast<size_t>(inJob)];
+    job.count++;
+    job.totalMs += inDurationMs;
+    job.lastMs = inDurationMs;
+    job.maxMs = std::max(job.maxMs, inDurationMs);
+}
+
+Snapshot InstanceStats::getSnapshot() const
+{
+    Snapshot snapshot;
+    snapshot.name = mName;
+
+    for (size_t i = 0; i < NUM_MEMORY_TYPES; i++) {
+        snapshot.bytes[i] = mBytes[i].load(std::memory_order_relaxed);
+    }
+
+    std::lock_guard<std::mutex> lock(mJobsMutex);
+    snapshot.jobs = mJobs;
+
+    return snapshot;
+}
+
+Registry& Registry::getInstance()
+{
+    static Registry registry;
+    return registry;
+}
+
+std::vector<Snapshot> Registry::getSnapshots() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    std::vector<Snapshot> snapshots;
+    snapshots.reserve(mInstances.size());
+
+    for (const auto* instance: mInstances) {
+        snapshots.push_back(instance->getSnapshot());
+    }
+
+    return snapshots;
+}
+
+Snapshot Registry::getTotal(const std::vector<Snapshot>& inSnapshots)
+{
+    Snapshot total;
+    total.name = "total";
+
+    for (const auto& snapshot: inSnapshots) {
+        for (size_t i = 0; i < NUM_MEMORY_TYPES; i++) {
+            total.bytes[i] += snapshot.bytes[i];
+        }
+
+        for (size_t i = 0; i < NUM_JOB_TYPES; i++) {
+            total.jobs[i].count += snapshot.jobs[i].count;
+            total.jobs[i].totalMs += snapshot.jobs[i].totalMs;
+            total.jobs[i].maxMs = std::max(total.jobs[i].maxMs, snapshot.jobs[i].maxMs);
+        }
+    }
+
+    return total;
+}
+
+std::string Registry::toJson() const
+{
+    const auto snapshots = getSnapshots();
+    const auto timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                  std::chrono::system_clock::now().time_since_epoch())
+                                  .count();
+
+    std::ostringstream stream;
+    stream << "{\n  \"timestamp_ms\": " << timestamp_ms << ",\n";
+    stream << "  \"num_instances\": " << snapshots.size() << ",\n";
+    stream << "  \"total\": ";
+    appendSnapshot(stream, getTotal(snapshots), "  ");
+    stream << ",\n  \"instances\": [";
+
+    for (size_t i = 0; i < snapshots.size(); i++) {
+        stream << (i == 0 ? "\n    " : ",\n    ");
+        appendSnapshot(stream, snapshots[i], "    ");
+    }
+
+    stream << (snapshots.empty() ? "]\n}\n" : "\n  ]\n}\n");
+
+    return stream.str();
+}
+
+bool Registry::writeJsonFile(const std::string& inPath, std::string& outError) const
+{
+    const auto tmp_path = inPath + ".tmp";
+
+    {
+        std::ofstream stream(tmp_path, std::ios::trunc);
+
+        if (!stream) {
+            outError = "Could not open " + tmp_path + " for writing";
+            return false;
+        }
+
+        stream << toJson();
+
+        if (!stream) {
+            outError = "Could not write " + tmp_path;
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tmp_path, inPath, error);
+
+    if (error) {
+        outError = "Could not rename " + tmp_path + " to " + inPath + ": " + error.message();
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+std::string Registry::_add(InstanceStats* inStats)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    mInstances.push_back(inStats);
+
+    return "Instance " + std::to_string(mNextInstanceId++);
+}
+
+void Registry::_remove(InstanceStats* inStats)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    mInstances.erase(std::remove(mInstances.begin(), mInstances.end(), inStats), mInstances.end());
+}
+
+} // namespace ResourceStats
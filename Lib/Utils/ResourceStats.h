@@ -0,0 +1,168 @@
+#ifndef ResourceStats_h
+#define ResourceStats_h
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Memory and job accounting per plugin instance, aggregated by a process wide registry so that the instance holding
+ * the memory can be identified when many are loaded.
+ */
+namespace ResourceStats
+{
+enum class Memory { SourceAudio = 0, Posteriorgrams, NotesScratch, Whisper, Caches, NumTypes };
+
+enum class Job { Transcription = 0, TextTranscription, BatchTranscription, NumTypes };
+
+constexpr size_t NUM_MEMORY_TYPES = static_cast<size_t>(Memory::NumTypes);
+constexpr size_t NUM_JOB_TYPES = static_cast<size_t>(Job::NumTypes);
+
+const char* getName(Memory inMemory);
+
+const char* getName(Job inJob);
+
+struct JobTotals {
+    uint64_t count = 0;
+    double totalMs = 0.0;
+    double lastMs = 0.0;
+    double maxMs = 0.0;
+};
+
+struct Snapshot {
+    std::string name;
+    std::array<uint64_t, NUM_MEMORY_TYPES> bytes {};
+    std::array<JobTotals, NUM_JOB_TYPES> jobs {};
+
+    uint64_t getTotalBytes() const;
+};
+
+/**
+ * Statistics of one plugin instance. Registers itself in the Registry for its whole lifetime.
+ * Memory sizes can be set from any thread without locking; jobs are added from the worker threads.
+ */
+class InstanceStats
+{
+public:
+    InstanceStats();
+
+    ~InstanceStats();
+
+    InstanceStats(const InstanceStats&) = delete;
+    InstanceStats& operator=(const InstanceStats&) = delete;
+
+    /**
+     * Set the number of bytes currently held for a memory type, replacing the previous value.
+     */
+    void setBytes(Memory inMemory, uint64_t inNumBytes);
+
+    void addJob(Job inJob, double inDurationMs);
+
+    Snapshot getSnapshot() const;
+
+    /**
+     * @return Name of the instance in the registry, e.g. "Instance 2".
+     */
+    const std::string& getName() const { return mName; }
+
+    /**
+     * Adds a job with the lifetime of the object as duration.
+     */
+    class ScopedJob
+    {
+    public:
+        ScopedJob(InstanceStats& inStats, Job inJob)
+            : mStats(inStats)
+            , mJob(inJob)
+            , mStart(std::chrono::steady_clock::now())
+        {
+        }
+
+        ~ScopedJob()
+        {
+            mStats.addJob(mJob,
+                          std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - mStart).count());
+        }
+
+    private:
+        InstanceStats& mStats;
+        const Job mJob;
+        const std::chrono::steady_clock::time_point mStart;
+    };
+
+private:
+    std::string mName;
+    std::array<std::atomic<uint64_t>, NUM_MEMORY_TYPES> mBytes {};
+
+    mutable std::mutex mJobsMutex;
+    std::array<JobTotals, NUM_JOB_TYPES> mJobs {};
+};
+
+/**
+ * Process wide list of the live instances.
+ */
+class Registry
+{
+public:
+    static Registry& getInstance();
+
+    std::vector<Snapshot> getSnapshots() const;
+
+    /**
+     * @return Sum over all instances. Job maxMs is the maximum over all instances, lastMs is not set.
+     */
+    static Snapshot getTotal(const std::vector<Snapshot>& inSnapshots);
+
+    /**
+     * @return JSON object with the timestamp, the total and one entry per instance.
+     */
+    std::string toJson() const;
+
+    /**
+     * Write toJson to a file. A temporary file is renamed over the destination so that readers never see a partially
+     * written file.
+     */
+    bool writeJsonFile(const std::string& inPath, std::string& outError) const;
+
+private:
+    friend class InstanceStats;
+
+    Registry() = default;
+
+    std::string _add(InstanceStats* inStats);
+
+    void _remove(InstanceStats* inStats);
+
+    mutable std::mutex mMutex;
+    std::vector<InstanceStats*> mInstances;
+    int mNextInstanceId = 1;
+};
+
+/**
+ * @return Bytes allocated by a vector of vectors, counting capacities rather than sizes.
+ */
+template <typename T>
+uint64_t getAllocatedBytes(const std::vector<std::vector<T>>& inVector)
+{
+    uint64_t num_bytes = inVector.capacity() * sizeof(std::vector<T>);
+
+    for (const auto& v: inVector) {
+        num_bytes += v.capacity() * sizeof(T);
+    }
+
+    return num_bytes;
+}
+
+template <typename T>
+uint64_t getAllocatedBytes(const std::vector<T>& inVector)
+{
+    return inVector.capacity() * sizeof(T);
+}
+
+} // namespace ResourceStats
+
+#endif // ResourceStats_h
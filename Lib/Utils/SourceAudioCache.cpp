@@ -0,0 +1,68 @@
+#include "SourceAudioCache.h"
+
+SourceAudioCache::FileKey SourceAudioCache::FileKey::fromPath(const std::filesystem::path& inPath)
+{
+    std::error_code error;
+
+    const auto canonical_path = std::filesystem::canonical(inPath, error);
+    if (error) {
+        return {};
+    }
+
+    const auto modification_time = std::filesystem::last_write_time(canonical_path, error);
+    if (error) {
+        return {};
+    }
+
+    const auto size = std::filesystem::file_size(canonical_path, error);
+    if (error) {
+        return {};
+    }
+
+    return {canonical_path.string(),
+            static_cast<int64_t>(modification_time.time_since_epoch().count()),
+            static_cast<uint64_t>(size)};
+}
+
+SourceAudioCache& SourceAudioCache::getInstance()
+{
+    static SourceAudioCache instance;
+    return instance;
+}
+
+size_t SourceAudioCache::getNumEntries() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    size_t num_entries = 0;
+
+    for (const auto& [key, slot]: mSlots) {
+        if (!slot->entry.expired() || slot.use_count() > 1) {
+            num_entries++;
+        }
+    }
+
+    return num_entries;
+}
+
+std::shared_ptr<SourceAudioCache::Slot> SourceAudioCache::_getSlot(const Key& inKey)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    // A slot only referenced by the map is not being computed, and its entry is gone once released by all instances
+    for (auto it = mSlots.begin(); it != mSlots.end();) {
+        if (it->second.use_count() == 1 && it->second->entry.expired()) {
+            it = mSlots.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    auto& slot = mSlots[inKey];
+
+    if (slot == nullptr) {
+        slot = std::make_shared<Slot>();
+    }
+
+    return slot;
+}
@@ -0,0 +1,108 @@
+#ifndef SourceAudioCache_h
+#define SourceAudioCache_h
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+/**
+ * Process wide cache of the audio decoded and resampled from source files, shared read-only between the plugin
+ * instances loading the same file. Entries are keyed by the file path, modification time and size, so that a file
+ * changed on disk is decoded again. The cache does not own the entries: they live as long as an instance holds them.
+ * Does not depend on JUCE so that the entry types are up to the caller.
+ */
+class SourceAudioCache
+{
+public:
+    enum class Representation { Playback = 0, Transcription, Whisper };
+
+    /**
+     * Identifies one version of a file on disk.
+     */
+    struct FileKey {
+        std::string path;
+        int64_t modificationTime = 0;
+        uint64_t size = 0;
+
+        /**
+         * @return Key of the file as it is now on disk, invalid if the file cannot be read.
+         */
+        static FileKey fromPath(const std::filesystem::path& inPath);
+
+        bool isValid() const { return !path.empty(); }
+
+        bool operator==(const FileKey& inOther) const
+        {
+            return path == inOther.path && modificationTime == inOther.modificationTime && size == inOther.size;
+        }
+    };
+
+    static SourceAudioCache& getInstance();
+
+    SourceAudioCache(const SourceAudioCache&) = delete;
+    SourceAudioCache& operator=(const SourceAudioCache&) = delete;
+
+    /**
+     * Get a representation of a file, computing it if no instance holds it. Callers requesting an entry while it is
+     * computed wait for it rather than computing it again. The entry must not be modified.
+     * @param inFileKey File the entry is computed from. If invalid, the entry is computed and not cached.
+     * @param inRepresentation Representation of the file.
+     * @param inSampleRate Sample rate of the representation, to tell apart the ones available at several rates.
+     * @param inCompute Computes the entry. Can return nullptr on failure, in which case nothing is cached.
+     * @return The entry, or nullptr if its computation failed.
+     */
+    template <typename T>
+    std::shared_ptr<T> getOrCompute(const FileKey& inFileKey,
+                                    Representation inRepresentation,
+                                    double inSampleRate,
+                                    const std::function<std::shared_ptr<T>()>& inCompute)
+    {
+        if (!inFileKey.isValid()) {
+            return inCompute();
+        }
+
+        auto slot =
+            _getSlot({inFileKey.path, inFileKey.modificationTime, inFileKey.size, inRepresentation, inSampleRate});
+
+        std::lock_guard<std::mutex> lock(slot->mutex);
+
+        if (auto entry = slot->entry.lock()) {
+            return std::static_pointer_cast<T>(entry);
+        }
+
+        auto entry = inCompute();
+        slot->entry = entry;
+
+        return entry;
+    }
+
+    /**
+     * @return Number of entries held by at least one instance or being computed.
+     */
+    size_t getNumEntries() const;
+
+private:
+    SourceAudioCache() = default;
+
+    using Key = std::tuple<std::string, int64_t, uint64_t, Representation, double>;
+
+    struct Slot {
+        std::mutex mutex;
+        std::weak_ptr<void> entry;
+    };
+
+    /**
+     * @return The slot of an entry, created if needed. Slots of the released entries are removed.
+     */
+    std::shared_ptr<Slot> _getSlot(const Key& inKey);
+
+    mutable std::mutex mMutex;
+    std::map<Key, std::shared_ptr<Slot>> mSlots;
+};
+
+#endif // SourceAudioCache_h
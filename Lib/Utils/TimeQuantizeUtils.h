@@ -7,40 +7,13 @@
 
 #include <JuceHeader.h>
 
+#include "TimeQuantizeUtilsCore.h"
+
 namespace TimeQuantizeUtils
 {
 static const StringArray TimeDivisionsStr {
     "1/1", "1/2", "1/3", "1/4", "1/6", "1/8", "1/12", "1/16", "1/24", "1/32", "1/48", "1/64"};
 
-enum TimeDivisions {
-    _1_1 = 0,
-    _1_2,
-    _1_3,
-    _1_4,
-    _1_6,
-    _1_8,
-    _1_12,
-    _1_16,
-    _1_24,
-    _1_32,
-    _1_48,
-    _1_64,
-    TotalNumTimeDivision
-};
-
-static constexpr std::array<double, TotalNumTimeDivision> TimeDivisionsDouble = {1.0 / 1.0,
-                                                                                 1.0 / 2.0,
-                                                                                 1.0 / 3.0,
-                                                                                 1.0 / 4.0,
-                                                                                 1.0 / 6.0,
-                                                                                 1.0 / 8.0,
-                                                                                 1.0 / 12.0,
-                                                                                 1.0 / 16.0,
-                                                                                 1.0 / 24.0,
-                                                                                 1.0 / 32.0,
-                                                                                 1.0 / 48.0,
-                                                                                 1.0 / 64.0};
-
 } // namespace TimeQuantizeUtils
 
 #endif //NN_TIMEQUANTIZEUTILS_H
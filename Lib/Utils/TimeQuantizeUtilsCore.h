@@ -0,0 +1,100 @@
+#ifndef NN_TIMEQUANTIZEUTILSCORE_H
+#define NN_TIMEQUANTIZEUTILSCORE_H
+
+#include <array>
+#include <cmath>
+
+/**
+ * Part of TimeQuantizeUtils without JUCE dependency, used by the core library. TimeQuantizeUtils.h adds the display
+ * names.
+ */
+namespace TimeQuantizeUtils
+{
+enum TimeDivisions {
+    _1_1 = 0,
+    _1_2,
+    _1_3,
+    _1_4,
+    _1_6,
+    _1_8,
+    _1_12,
+    _1_16,
+    _1_24,
+    _1_32,
+    _1_48,
+    _1_64,
+    TotalNumTimeDivision
+};
+
+static constexpr std::array<double, TotalNumTimeDivision> TimeDivisionsDouble = {1.0 / 1.0,
+                                                                                 1.0 / 2.0,
+                                                                                 1.0 / 3.0,
+                                                                                 1.0 / 4.0,
+                                                                                 1.0 / 6.0,
+                                                                                 1.0 / 8.0,
+                                                                                 1.0 / 12.0,
+                                                                                 1.0 / 16.0,
+                                                                                 1.0 / 24.0,
+                                                                                 1.0 / 32.0,
+                                                                                 1.0 / 48.0,
+                                                                                 1.0 / 64.0};
+
+/**
+ * Tempo, time signature and position of the recording start in the host timeline, to place the notes on the grid.
+ */
+struct TimeQuantizeInfo {
+    double bpm = 120.0;
+    int timeSignatureNum = 4;
+    int timeSignatureDenom = 4;
+
+    // Reference bar + position with corresponding time in seconds
+    double refLastBarQn = 0.0;
+    double refPositionQn = 0.0;
+    double refPositionSeconds = 0.0;
+
+    /**
+     * Convert a duration in quarter notes to seconds
+     */
+    static double qnToSec(double inDurationQn, double inBPM) { return inDurationQn * 60.0 / inBPM; }
+
+    /**
+     * Convert a duration in seconds to quarter notes
+     */
+    static double secToQn(double inDurationSeconds, double inBPM) { return inDurationSeconds * inBPM / 60.0; }
+
+    /**
+     * @return The start position in quarter notes
+     */
+    double getStartQn() const { return refPositionQn - secToQn(refPositionSeconds, bpm); }
+
+    /**
+     * @return Last bar position (before recording started) in quarter notes
+     */
+    double getStartLastBarQn() const
+    {
+        const double bar_duration_qn = timeSignatureNum * 4.0 / timeSignatureDenom;
+        const auto start_qn = getStartQn();
+
+        double num_bars = std::ceil((refLastBarQn - start_qn) / bar_duration_qn);
+
+        return refLastBarQn - num_bars * bar_duration_qn;
+    }
+
+    /**
+     * @return Get the time in seconds for the last bar start before recording started. Will be <= 0.
+     */
+    double getStartLastBarSec() const
+    {
+        const double bar_duration_qn = timeSignatureNum * 4.0 / timeSignatureDenom;
+        const double bar_duration_sec = qnToSec(bar_duration_qn, bpm);
+        const double ref_last_bar_seconds = refPositionSeconds - qnToSec(refPositionQn - refLastBarQn, bpm);
+
+        const auto num_bars = static_cast<int>(std::ceil(ref_last_bar_seconds / bar_duration_sec));
+
+        return ref_last_bar_seconds - num_bars * bar_duration_sec;
+    }
+};
+
+} // namespace TimeQuantizeUtils
+
+#endif // NN_TIMEQUANTIZEUTILSCORE_H
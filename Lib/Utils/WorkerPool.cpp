@@ -0,0 +1,133 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+WorkerPool::WorkerPool()
+    : mNumWorkers(std::max(std::thread::hardware_concurrency(), 1u) - 1)
+{
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mShouldExit = true;
+    }
+
+    mBatchAdded.notify_all();
+
+    for (auto& worker: mWorkers) {
+        worker.join();
+    }
+}
+
+std::shared_ptr<WorkerPool> WorkerPool::getInstance()
+{
+    // Not owning: destroying these while unloading does not touch the workers
+    static std::mutex instance_mutex;
+    static std::weak_ptr<WorkerPool> instance;
+
+    std::lock_guard<std::mutex> lock(instance_mutex);
+
+    auto pool = instance.lock();
+
+    if (pool == nullptr) {
+        pool = std::shared_ptr<WorkerPool>(new WorkerPool());
+        instance = pool;
+    }
+
+    return pool;
+}
+
+void WorkerPool::runInParallel(size_t inNumTasks,
+                               size_t inMaxNumThreads,
+                               const std::function<void(size_t)>& inTask)
+{
+    const auto num_helpers = std::min({inMaxNumThreads, inNumTasks, mNumWorkers + 1}) - 1;
+
+    if (inNumTasks == 0 || inMaxNumThreads == 0 || num_helpers == 0) {
+        for (size_t task = 0; task < inNumTasks; task++) {
+            inTask(task);
+        }
+
+        return;
+    }
+
+    auto batch = std::make_shared<Batch>();
+    batch->task = &inTask;
+    batch->numTasks = inNumTasks;
+    batch->numHelpersWanted = num_helpers;
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        while (mWorkers.size() < mNumWorkers) {
+            mWorkers.emplace_back(&WorkerPool::_workerLoop, this);
+        }
+
+        mBatches.push_back(batch);
+    }
+
+    mBatchAdded.notify_all();
+
+    _runTasks(*batch);
+
+    // No task left to pick up: workers not started on it yet have nothing to do
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mBatches.erase(std::remove(mBatches.begin(), mBatches.end(), batch), mBatches.end());
+    }
+
+    // Workers may still be running the last tasks. Those left afterwards never call inTask again.
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->done.wait(lock, [&batch] { return batch->numTasksDone == batch->numTasks; });
+}
+
+void WorkerPool::_runTasks(Batch& ioBatch)
+{
+    while (true) {
+        size_t task = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(ioBatch.mutex);
+
+            if (ioBatch.nextTask == ioBatch.numTasks) {
+                return;
+            }
+
+            task = ioBatch.nextTask++;
+        }
+
+        (*ioBatch.task)(task);
+
+        std::lock_guard<std::mutex> lock(ioBatch.mutex);
+
+        if (++ioBatch.numTasksDone == ioBatch.numTasks) {
+            ioBatch.done.notify_all();
+        }
+    }
+}
+
+void WorkerPool::_workerLoop()
+{
+    while (true) {
+        std::shared_ptr<Batch> batch;
+
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mBatchAdded.wait(lock, [this] { return mShouldExit || !mBatches.empty(); });
+
+            if (mShouldExit) {
+                return;
+            }
+
+            batch = mBatches.front();
+
+            if (++batch->numHelpers == batch->numHelpersWanted) {
+                mBatches.pop_front();
+            }
+        }
+
+        _runTasks(*batch);
+    }
+}
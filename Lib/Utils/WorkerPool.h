@@ -0,0 +1,79 @@
+#ifndef WorkerPool_h
+#define WorkerPool_h
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Process wide pool of worker threads splitting short computations over the cores, so that they do not start threads
+ * on every call. The threads are started by the first call needing them. The calling thread always takes part and runs
+ * the tasks no worker picks up, so a call completes even if all the workers are busy with other calls.
+ * The pool lives as long as a user holds it: the workers are stopped when the last one releases it, rather than in a
+ * static destructor run while the binary unloads (under the loader lock for a Windows plugin).
+ * Does not depend on JUCE so that the transcription engine can use it.
+ */
+class WorkerPool
+{
+public:
+    /**
+     * @return The pool, created if no user holds it. Keep it while calling runInParallel.
+     */
+    static std::shared_ptr<WorkerPool> getInstance();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    ~WorkerPool();
+
+    /**
+     * Run inTask(0) to inTask(inNumTasks - 1) over the calling thread and idle workers, and wait for all of them.
+     * @param inNumTasks Number of tasks
+     * @param inMaxNumThreads Maximum number of threads running the tasks, including the calling one
+     * @param inTask Task, called concurrently with different indices
+     */
+    void runInParallel(size_t inNumTasks, size_t inMaxNumThreads, const std::function<void(size_t)>& inTask);
+
+    /**
+     * @return Number of worker threads: one per hardware thread, except the calling one.
+     */
+    size_t getNumWorkers() const { return mNumWorkers; }
+
+private:
+    WorkerPool();
+
+    struct Batch {
+        const std::function<void(size_t)>* task = nullptr;
+        size_t numTasks = 0;
+        size_t numHelpersWanted = 0;
+        size_t numHelpers = 0;
+
+        std::mutex mutex;
+        std::condition_variable done;
+        size_t nextTask = 0;
+        size_t numTasksDone = 0;
+    };
+
+    /**
+     * Run the tasks of a batch until none is left.
+     */
+    static void _runTasks(Batch& ioBatch);
+
+    void _workerLoop();
+
+    const size_t mNumWorkers;
+
+    std::mutex mMutex;
+    std::condition_variable mBatchAdded;
+    // Batches still wanting helpers
+    std::deque<std::shared_ptr<Batch>> mBatches;
+    std::vector<std::thread> mWorkers;
+    bool mShouldExit = false;
+};
+
+#endif // WorkerPool_h
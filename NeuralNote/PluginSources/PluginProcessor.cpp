@@ -1,14 +1,20 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "AsyncLogger.h"
 
 NeuralNoteAudioProcessor::NeuralNoteAudioProcessor()
     : mAPVTS(*this, nullptr, NnId::ParametersId, ParameterHelpers::createParameterLayout())
 {
-    // Enable logging or not
-#if 0
-    mLogger.reset(FileLogger::createDefaultAppLogger("/tmp/NeuralNote", "log.txt", "YO! \n"));
-    Logger::setCurrentLogger(mLogger.get());
+    auto log_file = File::getSpecialLocation(File::userApplicationDataDirectory)
+                        .getChildFile("NeuralNote")
+                        .getChildFile("Logs")
+                        .getChildFile("NeuralNote.log");
+#if JUCE_DEBUG
+    constexpr bool mirror_log_to_std_err = true;
+#else
+    constexpr bool mirror_log_to_std_err = false;
 #endif
+    Log::AsyncLogger::getInstance().start(log_file.getFullPathName().toStdString(), mirror_log_to_std_err);
 
     for (size_t i = 0; i < mParams.size(); i++) {
         auto pid = static_cast<ParameterHelpers::ParamIdEnum>(i);
@@ -19,11 +25,12 @@ NeuralNoteAudioProcessor::NeuralNoteAudioProcessor()
     mPlayer = std::make_unique<Player>(this);
     mTranscriptionManager = std::make_unique<TranscriptionManager>(this);
     mTextTranscriptionManager = std::make_unique<TextTranscriptionManager>(this);
+    mBatchTranscriptionQueue = std::make_unique<BatchTranscriptionQueue>(this);
 }
 
 NeuralNoteAudioProcessor::~NeuralNoteAudioProcessor()
 {
-    Logger::setCurrentLogger(nullptr);
+    Log::AsyncLogger::getInstance().stop();
 }
 
 void NeuralNoteAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
@@ -112,7 +119,28 @@ void NeuralNoteAudioProcessor::clear()
     mTranscriptionManager->clear();
     mTextTranscriptionManager->clear();
 
-    mState.store(EmptyAudioAndMidiRegions);
+    _setState(EmptyAudioAndMidiRegions);
+}
+
+void NeuralNoteAudioProcessor::addStateChangeListener(ChangeListener* inListener)
+{
+    mStateBroadcaster.addChangeListener(inListener);
+}
+
+void NeuralNoteAudioProcessor::removeStateChangeListener(ChangeListener* inListener)
+{
+    mStateBroadcaster.removeChangeListener(inListener);
+}
+
+void NeuralNoteAudioProcessor::sendStateChangeMessage()
+{
+    mStateBroadcaster.sendChangeMessage();
+}
+
+void NeuralNoteAudioProcessor::_setState(State inState)
+{
+    mState.store(inState);
+    sendStateChangeMessage();
 }
 
 SourceAudioManager* NeuralNoteAudioProcessor::getSourceAudioManager() const
@@ -135,6 +163,16 @@ TextTranscriptionManager* NeuralNoteAudioProcessor::getTextTranscriptionManager(
     return mTextTranscriptionManager.get();
 }
 
+BatchTranscriptionQueue* NeuralNoteAudioProcessor::getBatchTranscriptionQueue() const
+{
+    return mBatchTranscriptionQueue.get();
+}
+
+ResourceStats::InstanceStats& NeuralNoteAudioProcessor::getResourceStats()
+{
+    return mResourceStats;
+}
+
 std::array<RangedAudioParameter*, ParameterHelpers::TotalNumParams>& NeuralNoteAudioProcessor::getParams()
 {
     return mParams;
@@ -11,9 +11,12 @@
 #include "TimeQuantizeOptions.h"
 #include "Player.h"
 #include "SourceAudioManager.h"
+#include "ResourceStats.h"
+#include "ResourceStatsExporter.h"
 #include "ParameterHelpers.h"
 #include "TranscriptionManager.h"
 #include "TextTranscriptionManager.h"
+#include "BatchTranscriptionQueue.h"
 #include "NnId.h"
 
 class NeuralNoteMainView;
@@ -40,11 +43,24 @@ public:
 
     State getState() const { return mState.load(); }
 
-    void setStateToRecording() { mState.store(Recording); }
+    void setStateToRecording() { _setState(Recording); }
 
-    void setStateToProcessing() { mState.store(Processing); }
+    void setStateToProcessing() { _setState(Processing); }
 
-    void setStateToPopulatedAudioAndMidiRegions() { mState.store(PopulatedAudioAndMidiRegions); }
+    void setStateToPopulatedAudioAndMidiRegions() { _setState(PopulatedAudioAndMidiRegions); }
+
+    /**
+     * Listeners are called on the message thread after the state, the playing state or the playhead position changed.
+     * Several changes made in a row result in a single call.
+     */
+    void addStateChangeListener(ChangeListener* inListener);
+
+    void removeStateChangeListener(ChangeListener* inListener);
+
+    /**
+     * Notify the state change listeners. Can be called from any thread but the audio thread, as it posts a message.
+     */
+    void sendStateChangeMessage();
 
     void clear();
 
@@ -56,6 +72,13 @@ public:
 
     TextTranscriptionManager* getTextTranscriptionManager() const;
 
+    BatchTranscriptionQueue* getBatchTranscriptionQueue() const;
+
+    /**
+     * @return Memory and job statistics of this instance, updated by the managers.
+     */
+    ResourceStats::InstanceStats& getResourceStats();
+
     std::array<RangedAudioParameter*, ParameterHelpers::TotalNumParams>& getParams();
 
     float getParameterValue(ParameterHelpers::ParamIdEnum inParamId) const;
@@ -79,6 +102,8 @@ private:
 
     void _updateValueTree(const ValueTree& inNewState);
 
+    void _setState(State inState);
+
     // ValueTree for general plugin state
     ValueTree mValueTree = _createDefaultValueTree();
 
@@ -88,10 +113,16 @@ private:
     std::array<RangedAudioParameter*, ParameterHelpers::TotalNumParams> mParams {};
 
     std::atomic<State> mState = EmptyAudioAndMidiRegions;
+    ChangeBroadcaster mStateBroadcaster;
+
+    // Before the managers so it outlives them: they report to it until destroyed
+    ResourceStats::InstanceStats mResourceStats;
+    SharedResourcePointer<ResourceStatsExporter> mResourceStatsExporter;
 
     std::unique_ptr<SourceAudioManager> mSourceAudioManager;
     std::unique_ptr<Player> mPlayer;
     std::unique_ptr<TranscriptionManager> mTranscriptionManager;
     std::unique_ptr<TextTranscriptionManager> mTextTranscriptionManager;
-    std::unique_ptr<FileLogger> mLogger;
+    // After the managers so it is destroyed first: it loads its results through them
+    std::unique_ptr<BatchTranscriptionQueue> mBatchTranscriptionQueue;
 };
@@ -0,0 +1,406 @@
+#include "BatchTranscriptionQueue.h"
+#include "PluginProcessor.h"
+#include "AsyncLogger.h"
+#include "ResourceStats.h"
+
+BatchTranscriptionQueue::BatchTranscriptionQueue(NeuralNoteAudioProcessor* inProcessor)
+    : mProcessor(inProcessor)
+{
+}
+
+BatchTranscriptionQueue::~BatchTranscriptionQueue()
+{
+    cancelPendingUpdate();
+
+    // Queued jobs are removed, running ones stop at their next check and are waited for, as they use the queue
+    mShouldStop->store(true);
+    mThreadPool->removeJobs(this);
+}
+
+int BatchTranscriptionQueue::addFiles(const StringArray& inFiles)
+{
+    jassert(MessageManager::getInstance()->isThisTheMessageThread());
+
+    const auto supported_extensions = AudioUtils::getSupportedAudioFileExtensions();
+    std::vector<int> new_item_ids;
+
+    {
+        const ScopedLock sl(mItemsLock);
+
+        for (const auto& path: inFiles) {
+            File file(path);
+
+            if (!file.existsAsFile() || !supported_extensions.contains(file.getFileExtension(), true)) {
+                continue;
+            }
+
+            bool already_queued = std::any_of(
+                mItems.begin(), mItems.end(), [&file](const Item& item) { return item.file == file; });
+
+            if (already_queued) {
+                continue;
+            }
+
+            Item item;
+            item.id = mNextItemId++;
+            item.file = file;
+            mItems.push_back(item);
+            new_item_ids.push_back(item.id);
+        }
+    }
+
+    if (new_item_ids.empty()) {
+        return 0;
+    }
+
+    mShouldLoadFirstTranscribedItem = mProcessor->getState() == EmptyAudioAndMidiRegions;
+
+    for (auto item_id: new_item_ids) {
+        mThreadPool->addJob(this,
+                            [this, item_id, should_stop = mShouldStop] { _transcribeItem(item_id, *should_stop); });
+    }
+
+    sendChangeMessage();
+
+    return static_cast<int>(new_item_ids.size());
+}
+
+std::vector<BatchTranscriptionQueue::Item> BatchTranscriptionQueue::getItems() const
+{
+    const ScopedLock sl(mItemsLock);
+    return mItems;
+}
+
+int BatchTranscriptionQueue::getNumItems() const
+{
+    const ScopedLock sl(mItemsLock);
+    return static_cast<int>(mItems.size());
+}
+
+int BatchTranscriptionQueue::getLoadedItemId() const
+{
+    jassert(MessageManager::getInstance()->isThisTheMessageThread());
+
+    if (mProcessor->getState() == EmptyAudioAndMidiRegions) {
+        return 0;
+    }
+
+    const auto loaded_path = mProcessor->getValueTree().getProperty(NnId::SourceAudioNativeSrPathId).toString();
+
+    const ScopedLock sl(mItemsLock);
+
+    for (const auto& item: mItems) {
+        if (item.file.getFullPathName() == loaded_path) {
+            return item.id;
+        }
+    }
+
+    return 0;
+}
+
+bool BatchTranscriptionQueue::loadItem(int inItemId)
+{
+    jassert(MessageManager::getInstance()->isThisTheMessageThread());
+
+    auto state = mProcessor->getState();
+
+    if (state != EmptyAudioAndMidiRegions && state != PopulatedAudioAndMidiRegions) {
+        return false;
+    }
+
+    File file;
+    std::shared_ptr<const BasicPitch::Posteriorgrams> posteriorgrams;
+
+    {
+        const ScopedLock sl(mItemsLock);
+
+        auto it = std::find_if(
+            mItems.begin(), mItems.end(), [inItemId](const Item& item) { return item.id == inItemId; });
+
+        if (it == mItems.end() || it->status != Status::Done) {
+            return false;
+        }
+
+        file = it->file;
+        posteriorgrams = it->posteriorgrams;
+    }
+
+    mShouldLoadFirstTranscribedItem = false;
+
+    bool success = mProcessor->getSourceAudioManager()->onFileDrop(file, std::move(posteriorgrams));
+
+    sendChangeMessage();
+
+    return success;
+}
+
+void BatchTranscriptionQueue::exportAllMidi(const File& inDirectory, std::function<void(int)> inOnDone)
+{
+    jassert(MessageManager::getInstance()->isThisTheMessageThread());
+
+    // Everything the job needs is copied now: the transcription manager and the parameters keep changing meanwhile
+    auto* transcription_manager = mProcessor->getTranscriptionManager();
+
+    const auto convert_params =
+        BasicPitch::createConvertParams(mProcessor->getParameterValue(ParameterHelpers::NoteSensitivityId),
+                                        mProcessor->getParameterValue(ParameterHelpers::SplitSensitivityId),
+                                        mProcessor->getParameterValue(ParameterHelpers::MinimumNoteDurationId));
+    auto post_processing = transcription_manager->createPostProcessing();
+    const auto time_quantize_info = transcription_manager->getTimeQuantizeOptions().getTimeQuantizeInfo();
+    const double export_bpm = mProcessor->getValueTree().getProperty(NnId::ExportTempoId, 120.0);
+    const auto pitch_bend_mode =
+        static_cast<PitchBendModes>(mProcessor->getParameterValue(ParameterHelpers::PitchBendModeId));
+    const auto items = getItems();
+
+    auto export_job = [should_stop = mShouldStop,
+                       inDirectory,
+                       convert_params,
+                       post_processing,
+                       time_quantize_info,
+                       export_bpm,
+                       pitch_bend_mode,
+                       items,
+                       on_done = std::move(inOnDone)]() mutable {
+        MidiFileWriter midi_file_writer;
+        int num_files_written = 0;
+
+        if (!inDirectory.isDirectory() && !inDirectory.createDirectory().wasOk()) {
+            NN_LOG_WARNING(Transcription, "Could not create directory {}", inDirectory.getFullPathName().toRawUTF8());
+        } else {
+            for (const auto& item: items) {
+                if (*should_stop) {
+                    break;
+                }
+
+                if (item.status != Status::Done || item.posteriorgrams == nullptr) {
+                    continue;
+                }
+
+                Notes notes_creator;
+                auto note_events = notes_creator.convert(item.posteriorgrams->notes,
+                                                         item.posteriorgrams->onsets,
+                                                         item.posteriorgrams->contours,
+                                                         convert_params,
+                                                         true);
+
+                auto post_processed_notes = post_processing.process(note_events);
+
+                auto out_file =
+                    inDirectory.getChildFile(item.file.getFileNameWithoutExtension() + "_basic_pitch.mid")
+                        .getNonexistentSibling();
+
+                if (midi_file_writer.writeMidiFile(
+                        post_processed_notes, out_file, time_quantize_info, export_bpm, pitch_bend_mode)) {
+                    num_files_written++;
+                } else {
+                    NN_LOG_WARNING(
+                        Transcription, "Could not write MIDI file {}", out_file.getFullPathName().toRawUTF8());
+                }
+            }
+        }
+
+        // Does not use the queue: fine if it is destroyed meanwhile
+        MessageManager::callAsync([on_done, num_files_written] { on_done(num_files_written); });
+    };
+
+    mThreadPool->addJob(this, std::move(export_job));
+}
+
+void BatchTranscriptionQueue::clear()
+{
+    // A running job cannot be interrupted while it loads or resamples a file, or writes a MIDI file: rather than
+    // waiting for it on the message thread, stop it and let it finish on its own. Its item is gone, so its result is
+    // dropped. Jobs added from now on use a new flag.
+    mShouldStop->store(true);
+    mShouldStop = std::make_shared<std::atomic<bool>>(false);
+    mThreadPool->removeJobs(this, 0);
+
+    {
+        const ScopedLock sl(mItemsLock);
+        mItems.clear();
+    }
+
+    {
+        const ScopedLock sl(mIdleBasicPitchLock);
+        mIdleBasicPitch.clear();
+    }
+
+    _updateResourceStats();
+
+    mShouldLoadFirstTranscribedItem = false;
+
+    sendChangeMessage();
+}
+
+void BatchTranscriptionQueue::handleAsyncUpdate()
+{
+    if (mShouldLoadFirstTranscribedItem && mProcessor->getState() == EmptyAudioAndMidiRegions) {
+        for (const auto& item: getItems()) {
+            if (item.status == Status::Done) {
+                // loadItem notifies the listeners
+                loadItem(item.id);
+                return;
+            }
+        }
+    }
+
+    sendChangeMessage();
+}
+
+void BatchTranscriptionQueue::_transcribeItem(int inItemId, const std::atomic<bool>& inShouldStop)
+{
+    if (inShouldStop) {
+        return;
+    }
+
+    File file;
+
+    {
+        const ScopedLock sl(mItemsLock);
+
+        auto it = std::find_if(
+            mItems.begin(), mItems.end(), [inItemId](const Item& item) { return item.id == inItemId; });
+
+        if (it == mItems.end()) {
+            return;
+        }
+
+        file = it->file;
+    }
+
+    _setItemStatus(inItemId, Status::Transcribing);
+
+    AudioBuffer<float> source_audio;
+    double source_sample_rate = 44100.0;
+
+    if (!AudioUtils::loadAudioFile(file, source_audio, source_sample_rate)) {
+        _setItemStatus(inItemId, Status::Failed, "Could not load the audio file.");
+        return;
+    }
+
+    if (inShouldStop) {
+        _setItemStatus(inItemId, Status::Queued);
+        return;
+    }
+
+    // Same input as the main transcription when not transcribing channels separately: mono at basic pitch rate
+    AudioBuffer<float> downsampled_audio;
+    AudioUtils::resampleBuffer(source_audio, downsampled_audio, source_sample_rate, BASIC_PITCH_SAMPLE_RATE);
+    source_audio = {};
+
+    if (downsampled_audio.getNumChannels() > 1) {
+        AudioBuffer<float> mono_audio;
+        AudioUtils::downmixToMono(downsampled_audio, mono_audio);
+        downsampled_audio = std::move(mono_audio);
+    }
+
+    if (downsampled_audio.getNumSamples() < 1 * AUDIO_SAMPLE_RATE) {
+        _setItemStatus(inItemId, Status::Failed, "Audio file is shorter than one second.");
+        return;
+    }
+
+    if (inShouldStop) {
+        _setItemStatus(inItemId, Status::Queued);
+        return;
+    }
+
+    auto basic_pitch = _acquireBasicPitch();
+
+    if (!basic_pitch->isInitialized()) {
+        _setItemStatus(inItemId, Status::Failed, String(basic_pitch->getErrorMessage()));
+        return;
+    }
+
+    bool is_transcribed = false;
+
+    {
+        ResourceStats::InstanceStats::ScopedJob stats_job(mProcessor->getResourceStats(),
+                                                          ResourceStats::Job::BatchTranscription);
+        is_transcribed = basic_pitch->transcribeToMIDI(
+            downsampled_audio.getWritePointer(0), downsampled_audio.getNumSamples(), &inShouldStop);
+    }
+
+    if (!is_transcribed) {
+        basic_pitch->reset();
+        _releaseBasicPitch(std::move(basic_pitch), inShouldStop);
+        _setItemStatus(inItemId, Status::Queued);
+        return;
+    }
+
+    auto posteriorgrams = std::make_shared<const BasicPitch::Posteriorgrams>(basic_pitch->getPosteriorgrams());
+    basic_pitch->reset();
+    _releaseBasicPitch(std::move(basic_pitch), inShouldStop);
+
+    _setItemStatus(inItemId, Status::Done, {}, std::move(posteriorgrams));
+}
+
+std::unique_ptr<BasicPitch> BatchTranscriptionQueue::_acquireBasicPitch()
+{
+    {
+        const ScopedLock sl(mIdleBasicPitchLock);
+
+        if (!mIdleBasicPitch.empty()) {
+            auto basic_pitch = std::move(mIdleBasicPitch.back());
+            mIdleBasicPitch.pop_back();
+            return basic_pitch;
+        }
+    }
+
+    return std::make_unique<BasicPitch>();
+}
+
+void BatchTranscriptionQueue::_releaseBasicPitch(std::unique_ptr<BasicPitch> inBasicPitch,
+                                                 const std::atomic<bool>& inShouldStop)
+{
+    // Checked under the lock, as clear sets the flag before freeing the idle instances
+    const ScopedLock sl(mIdleBasicPitchLock);
+
+    if (!inShouldStop) {
+        mIdleBasicPitch.push_back(std::move(inBasicPitch));
+    }
+}
+
+void BatchTranscriptionQueue::_setItemStatus(int inItemId,
+                                             Status inStatus,
+                                             const String& inErrorMessage,
+                                             std::shared_ptr<const BasicPitch::Posteriorgrams> inPosteriorgrams)
+{
+    {
+        const ScopedLock sl(mItemsLock);
+
+        auto it = std::find_if(
+            mItems.begin(), mItems.end(), [inItemId](const Item& item) { return item.id == inItemId; });
+
+        if (it == mItems.end()) {
+            return;
+        }
+
+        it->status = inStatus;
+        it->errorMessage = inErrorMessage;
+        it->posteriorgrams = std::move(inPosteriorgrams);
+    }
+
+    _updateResourceStats();
+
+    triggerAsyncUpdate();
+}
+
+void BatchTranscriptionQueue::_updateResourceStats()
+{
+    // Posteriorgrams of the items, also referenced by the transcription manager for the loaded item
+    uint64_t num_bytes = 0;
+
+    {
+        const ScopedLock sl(mItemsLock);
+
+        for (const auto& item: mItems) {
+            if (item.posteriorgrams != nullptr) {
+                num_bytes += ResourceStats::getAllocatedBytes(item.posteriorgrams->contours)
+                             + ResourceStats::getAllocatedBytes(item.posteriorgrams->notes)
+                             + ResourceStats::getAllocatedBytes(item.posteriorgrams->onsets);
+            }
+        }
+    }
+
+    mProcessor->getResourceStats().setBytes(ResourceStats::Memory::Caches, num_bytes);
+}
@@ -0,0 +1,123 @@
+#ifndef BatchTranscriptionQueue_h
+#define BatchTranscriptionQueue_h
+
+#include <JuceHeader.h>
+
+#include "BasicPitch.h"
+#include "SharedThreadPool.h"
+
+class NeuralNoteAudioProcessor;
+
+/**
+ * Queue of audio files transcribed concurrently in the background, on the thread pool shared by the instances. The
+ * posteriorgrams of each file are cached so switching the displayed file, changing the parameters or exporting all the
+ * files does not run the CNN again. Change listeners are notified on the message thread whenever an item changes.
+ */
+class BatchTranscriptionQueue
+    : public ChangeBroadcaster
+    , private AsyncUpdater
+{
+public:
+    enum class Status { Queued = 0, Transcribing, Done, Failed };
+
+    struct Item {
+        int id = 0;
+        File file;
+        Status status = Status::Queued;
+        String errorMessage;
+        // Set once status is Done
+        std::shared_ptr<const BasicPitch::Posteriorgrams> posteriorgrams;
+    };
+
+    explicit BatchTranscriptionQueue(NeuralNoteAudioProcessor* inProcessor);
+
+    ~BatchTranscriptionQueue() override;
+
+    /**
+     * Add audio files to the queue. Unsupported files and files already in the queue are ignored.
+     * @param inFiles Full paths of the files to transcribe
+     * @return Number of files added
+     */
+    int addFiles(const StringArray& inFiles);
+
+    /**
+     * @return Copy of the items in the order they were added.
+     */
+    std::vector<Item> getItems() const;
+
+    int getNumItems() const;
+
+    /**
+     * @return Id of the item whose audio is currently loaded in the main view, or 0 if none. To call on the message
+     * thread.
+     */
+    int getLoadedItemId() const;
+
+    /**
+     * Load a transcribed item in the main view, reusing its cached posteriorgrams. To call on the message thread.
+     * @param inItemId Id of the item to load
+     * @return Whether the item was loaded. False if it is not transcribed yet or the processor is busy.
+     */
+    bool loadItem(int inItemId);
+
+    /**
+     * Write one MIDI file per transcribed item in a directory, in the background, with the transcription, note and
+     * time quantization parameters at the time of the call. To call on the message thread.
+     * @param inDirectory Directory where to write the MIDI files
+     * @param inOnDone Called on the message thread with the number of MIDI files written once done
+     */
+    void exportAllMidi(const File& inDirectory, std::function<void(int)> inOnDone);
+
+    /**
+     * Cancel the queued jobs, remove all items and free the idle models. Running jobs are stopped but not waited for:
+     * they return at their next check, e.g. the next CNN frame, and their results are dropped. The audio loaded in the
+     * main view is left untouched.
+     */
+    void clear();
+
+private:
+    void handleAsyncUpdate() override;
+
+    using StopFlag = std::shared_ptr<std::atomic<bool>>;
+
+    void _transcribeItem(int inItemId, const std::atomic<bool>& inShouldStop);
+
+    std::unique_ptr<BasicPitch> _acquireBasicPitch();
+
+    /**
+     * Make a model instance available to the next jobs. Destroyed instead if the job was stopped, so that the models
+     * freed by clear are not kept by the jobs still running then.
+     */
+    void _releaseBasicPitch(std::unique_ptr<BasicPitch> inBasicPitch, const std::atomic<bool>& inShouldStop);
+
+    void _setItemStatus(int inItemId,
+                        Status inStatus,
+                        const String& inErrorMessage = {},
+                        std::shared_ptr<const BasicPitch::Posteriorgrams> inPosteriorgrams = nullptr);
+
+    /**
+     * Report the memory held by the cached posteriorgrams to the instance statistics.
+     */
+    void _updateResourceStats();
+
+    NeuralNoteAudioProcessor* mProcessor;
+
+    CriticalSection mItemsLock;
+    std::vector<Item> mItems;
+    int mNextItemId = 1;
+
+    // Message thread only: load the first item transcribed after files were added if nothing is loaded yet
+    bool mShouldLoadFirstTranscribedItem = false;
+
+    // Idle model instances, reused by the next jobs so models are only loaded once per worker
+    CriticalSection mIdleBasicPitchLock;
+    std::vector<std::unique_ptr<BasicPitch>> mIdleBasicPitch;
+
+    // Stop flag of the jobs added since the last clear, which sets it and replaces it with a new one. Message thread
+    // only, jobs hold their own copy.
+    StopFlag mShouldStop = std::make_shared<std::atomic<bool>>(false);
+
+    SharedResourcePointer<SharedThreadPool> mThreadPool;
+};
+
+#endif // BatchTranscriptionQueue_h
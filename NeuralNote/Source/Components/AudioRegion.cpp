@@ -28,17 +28,26 @@ void AudioRegion::paint(Graphics& g)
         g.setColour(WAVEFORM_BG_COLOR);
         g.fillRoundedRectangle(getLocalBounds().toFloat(), 4.0f);
 
-        auto thumbnail_area = getLocalBounds();
-        thumbnail_area.setWidth(mThumbnailWidth);
-
-        g.setColour(WAVEFORM_COLOR);
-
-        thumbnail->drawChannel(g,
-                               thumbnail_area,
-                               0.0,
-                               num_samples_available / BASIC_PITCH_SAMPLE_RATE,
-                               0,
-                               0.95f / std::max(thumbnail->getApproximatePeak(), 0.1f));
+        // Only the visible time range is drawn
+        const double num_pixels_per_second = mBaseNumPixelsPerSecond * mZoomLevel;
+        const double duration_available = num_samples_available / BASIC_PITCH_SAMPLE_RATE;
+        const double view_end_time =
+            std::min(duration_available, mViewStartTime + static_cast<double>(getWidth()) / num_pixels_per_second);
+
+        if (view_end_time > mViewStartTime) {
+            auto thumbnail_area = getLocalBounds();
+            thumbnail_area.setWidth(
+                static_cast<int>(std::round((view_end_time - mViewStartTime) * num_pixels_per_second)));
+
+            g.setColour(WAVEFORM_COLOR);
+
+            thumbnail->drawChannel(g,
+                                   thumbnail_area,
+                                   mViewStartTime,
+                                   view_end_time,
+                                   0,
+                                   0.95f / std::max(thumbnail->getApproximatePeak(), 0.1f));
+        }
     } else if (mProcessor->getState() == Processing) {
         g.setColour(WAVEFORM_BG_COLOR);
         g.fillRoundedRectangle(getLocalBounds().toFloat(), 4.0f);
@@ -65,24 +74,30 @@ void AudioRegion::setIsFileOver(bool inIsFileOver)
     mIsFileOver = inIsFileOver;
 }
 
-void AudioRegion::setThumbnailWidth(int inThumbnailWidth)
+void AudioRegion::setViewStartTime(double inTimeSeconds)
 {
-    mThumbnailWidth = inThumbnailWidth;
+    mViewStartTime = inTimeSeconds;
+    mPlayhead.setViewStartTime(inTimeSeconds);
+    repaint();
 }
 
 void AudioRegion::mouseDown(const juce::MouseEvent& e)
 {
     if (mProcessor->getState() == EmptyAudioAndMidiRegions) {
         mFileChooser = std::make_shared<juce::FileChooser>(
-            "Select Audio File", juce::File {}, "*.wav;*.aiff;*.flac;*.mp3;*.ogg", true, false, this);
+            "Select Audio Files", juce::File {}, "*.wav;*.aiff;*.flac;*.mp3;*.ogg", true, false, this);
 
-        mFileChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+        mFileChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles
+                                      | juce::FileBrowserComponent::canSelectMultipleItems,
                                   [this](const juce::FileChooser& fc) {
                                       if (fc.getResults().isEmpty())
                                           return;
+                                      StringArray paths;
+                                      for (const auto& file: fc.getResults())
+                                          paths.add(file.getFullPathName());
                                       auto* parent = dynamic_cast<CombinedAudioMidiRegion*>(getParentComponent());
                                       if (parent) {
-                                          parent->filesDropped(StringArray(fc.getResult().getFullPathName()), 1, 1);
+                                          parent->filesDropped(paths, 1, 1);
                                       }
                                   });
     } else if (mProcessor->getState() == PopulatedAudioAndMidiRegions) {
@@ -99,5 +114,5 @@ void AudioRegion::setZoomLevel(double inZoomLevel)
 
 float AudioRegion::_pixelToTime(float inPixel) const
 {
-    return inPixel / static_cast<float>(mBaseNumPixelsPerSecond * mZoomLevel);
+    return static_cast<float>(mViewStartTime + inPixel / (mBaseNumPixelsPerSecond * mZoomLevel));
 }
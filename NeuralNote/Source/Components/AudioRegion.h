@@ -25,7 +25,11 @@ public:
 
     void setIsFileOver(bool inIsFileOver);
 
-    void setThumbnailWidth(int inThumbnailWidth);
+    /**
+     * Set the time shown at the left edge of the region.
+     * @param inTimeSeconds Time in seconds.
+     */
+    void setViewStartTime(double inTimeSeconds);
 
     void mouseDown(const juce::MouseEvent& e) override;
 
@@ -42,8 +46,8 @@ private:
 
     const double mBaseNumPixelsPerSecond;
     double mZoomLevel = 1.0;
+    double mViewStartTime = 0.0;
 
-    int mThumbnailWidth = 0;
     bool mIsFileOver = false;
 };
 
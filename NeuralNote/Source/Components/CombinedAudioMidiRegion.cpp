@@ -6,7 +6,7 @@
 
 CombinedAudioMidiRegion::CombinedAudioMidiRegion(NeuralNoteAudioProcessor* processor, Keyboard& keyboard)
     : mProcessor(processor)
-    , mVBlankAttachment(this, [this]() { _onVBlankCallback(); })
+    , mPlaybackVBlank(this, processor->getPlayer(), [this]() { _onVBlankCallback(); })
     , mSupportedAudioFileExtensions(AudioUtils::getSupportedAudioFileExtensions())
     , mAudioRegion(processor, mBaseNumPixelsPerSecond)
     , mPianoRoll(processor, keyboard, mBaseNumPixelsPerSecond)
@@ -18,14 +18,23 @@ CombinedAudioMidiRegion::CombinedAudioMidiRegion(NeuralNoteAudioProcessor* proce
     addAndMakeVisible(mTextRegion);
     mTextRegion.setInterceptsMouseClicks(false, false);
     mTextRegion.toFront(false);
+
+    mScrollBar.setAutoHide(true);
+    mScrollBar.addListener(this);
+    addAndMakeVisible(mScrollBar);
+
     mProcessor->getSourceAudioManager()->getAudioThumbnail()->addChangeListener(this);
+    mProcessor->addStateChangeListener(this);
+    mPlaybackVBlank.update();
     _setZoomLevel(mProcessor->getValueTree().getProperty(NnId::ZoomLevelId, 1.0));
 }
 
 CombinedAudioMidiRegion::~CombinedAudioMidiRegion()
 {
+    mScrollBar.removeListener(this);
     mProcessor->removeListenerFromStateValueTree(this);
     mProcessor->getSourceAudioManager()->getAudioThumbnail()->removeChangeListener(this);
+    mProcessor->removeStateChangeListener(this);
 }
 
 void CombinedAudioMidiRegion::resized()
@@ -33,6 +42,11 @@ void CombinedAudioMidiRegion::resized()
     mAudioRegion.setBounds(0, 0, getWidth(), mAudioRegionHeight);
     mTextRegion.setBounds(mAudioRegion.getBounds());
     mPianoRoll.setBounds(0, mPianoRollY, getWidth(), getHeight() - mPianoRollY);
+
+    auto scroll_bar_thickness = getLookAndFeel().getDefaultScrollbarWidth();
+    mScrollBar.setBounds(0, getHeight() - scroll_bar_thickness, getWidth(), scroll_bar_thickness);
+
+    updateTimeRange();
 }
 
 void CombinedAudioMidiRegion::paint(Graphics& g)
@@ -47,23 +61,20 @@ bool CombinedAudioMidiRegion::isInterestedInFileDrag(const StringArray& files)
 void CombinedAudioMidiRegion::mouseWheelMove(const MouseEvent& event, const MouseWheelDetails& wheel)
 {
     if (event.mods.isCommandDown()) {
-        auto time_start_view = mViewportPtr->getViewPositionX() / (mBaseNumPixelsPerSecond * mZoomLevel);
         _setZoomLevel(mZoomLevel + wheel.deltaY);
-        mViewportPtr->setViewPosition(roundToInt(time_start_view * mBaseNumPixelsPerSecond * mZoomLevel), 0);
-        repaint();
     } else {
         if (!(mShouldCenterView && mProcessor->getState() == PopulatedAudioAndMidiRegions
               && mProcessor->getPlayer()->isPlaying())) {
-            Component::mouseWheelMove(event, wheel);
+            // Vertical wheel scrolls horizontally as there is nothing to scroll vertically
+            // Deltas already follow the system scroll direction, as in juce::Viewport
+            const auto delta = wheel.deltaX != 0.0f ? wheel.deltaX : wheel.deltaY;
+            setViewStartTime(mViewStartTime - delta * mWheelScrollPixels / _getNumPixelsPerSecond());
         }
     }
 }
 void CombinedAudioMidiRegion::mouseMagnify(const MouseEvent& event, float scaleFactor)
 {
-    auto time_start_view = mViewportPtr->getViewPositionX() / (mBaseNumPixelsPerSecond * mZoomLevel);
     _setZoomLevel(mZoomLevel * scaleFactor);
-    mViewportPtr->setViewPosition(roundToInt(time_start_view * mBaseNumPixelsPerSecond * mZoomLevel), 0);
-    repaint();
 }
 
 void CombinedAudioMidiRegion::filesDropped(const StringArray& files, int x, int y)
@@ -72,11 +83,27 @@ void CombinedAudioMidiRegion::filesDropped(const StringArray& files, int x, int
     ignoreUnused(y);
     mAudioRegion.setIsFileOver(false);
 
+    if (files.size() > 1) {
+        // Several files: transcribe them all in the background, the first one transcribed is shown if nothing is
+        int num_files_added = mProcessor->getBatchTranscriptionQueue()->addFiles(files);
+
+        if (num_files_added == 0) {
+            juce::NativeMessageBox::showMessageBoxAsync(
+                juce::MessageBoxIconType::NoIcon,
+                "Could not load the files.",
+                "Check your file formats (Accepted formats: " + mSupportedAudioFileExtensions.joinIntoString(", ")
+                    + ").");
+        }
+
+        return;
+    }
+
     if (_isFileTypeSupported(files[0])) {
         bool success = mProcessor->getSourceAudioManager()->onFileDrop(files[0]);
 
         if (success) {
-            resizeAccordingToNumSamplesAvailable();
+            updateTimeRange();
+            setViewStartTime(0.0);
         }
 
         repaint();
@@ -105,49 +132,63 @@ void CombinedAudioMidiRegion::fileDragExit(const StringArray& files)
     mAudioRegion.repaint();
 }
 
-void CombinedAudioMidiRegion::setBaseWidth(int inWidth)
+void CombinedAudioMidiRegion::repaintPianoRoll()
 {
-    mBaseWidth = inWidth;
+    mPianoRoll.repaint();
 }
 
-void CombinedAudioMidiRegion::repaintPianoRoll()
+void CombinedAudioMidiRegion::repaintPianoRoll(const Notes::EventsDiff& inNoteEventsDiff)
 {
-    mPianoRoll.repaint();
+    mPianoRoll.repaintNoteChanges(inNoteEventsDiff);
 }
 
-void CombinedAudioMidiRegion::resizeAccordingToNumSamplesAvailable()
+void CombinedAudioMidiRegion::updateTimeRange()
 {
-    const double duration_available =
-        mProcessor->getSourceAudioManager()->getNumSamplesDownAcquired() / BASIC_PITCH_SAMPLE_RATE;
+    mDurationAvailable = mProcessor->getSourceAudioManager()->getNumSamplesDownAcquired() / BASIC_PITCH_SAMPLE_RATE;
 
-    int thumbnail_width = static_cast<int>(std::round(mZoomLevel * mBaseNumPixelsPerSecond * duration_available));
-    mAudioRegion.setThumbnailWidth(thumbnail_width);
+    // Clamps the view start to the new range and updates the scroll bar
+    setViewStartTime(mViewStartTime);
+}
 
-    int new_width = std::max(mBaseWidth, thumbnail_width);
+void CombinedAudioMidiRegion::setViewStartTime(double inTimeSeconds)
+{
+    auto view_start_time = std::clamp(inTimeSeconds, 0.0, _getMaxViewStartTime());
 
-    if (new_width != getWidth()) {
-        setSize(new_width, getHeight());
+    if (view_start_time != mViewStartTime) {
+        mViewStartTime = view_start_time;
+        mAudioRegion.setViewStartTime(mViewStartTime);
+        mPianoRoll.setViewStartTime(mViewStartTime);
+        mTextRegion.setViewStartTime(mViewStartTime);
     }
+
+    _updateScrollBar();
 }
 
-void CombinedAudioMidiRegion::setViewportPtr(juce::Viewport* inViewportPtr)
+double CombinedAudioMidiRegion::getViewStartTime() const
 {
-    mViewportPtr = inViewportPtr;
+    return mViewStartTime;
 }
 
 void CombinedAudioMidiRegion::changeListenerCallback(juce::ChangeBroadcaster* source)
 {
     if (source == mProcessor->getSourceAudioManager()->getAudioThumbnail()) {
-        resizeAccordingToNumSamplesAvailable();
+        updateTimeRange();
 
         if (mProcessor->getState() == Recording) {
-            if (mViewportPtr)
-                mViewportPtr->setViewPositionProportionately(1.0f, 0.0f);
-            else
-                jassertfalse;
+            setViewStartTime(_getMaxViewStartTime());
         }
 
         mAudioRegion.repaint();
+    } else {
+        // State change of the processor: follow the playhead at the display rate only while playing
+        mPlaybackVBlank.update();
+    }
+}
+
+void CombinedAudioMidiRegion::scrollBarMoved(ScrollBar* scrollBarThatHasMoved, double newRangeStart)
+{
+    if (scrollBarThatHasMoved == &mScrollBar) {
+        setViewStartTime(newRangeStart);
     }
 }
 
@@ -176,24 +217,8 @@ void CombinedAudioMidiRegion::_onVBlankCallback()
 void CombinedAudioMidiRegion::_centerViewOnPlayhead()
 {
     if (mProcessor->getState() == PopulatedAudioAndMidiRegions) {
-        double playhead_position =
-            Playhead::computePlayheadPositionPixel(mProcessor->getPlayer()->getPlayheadPositionSeconds(),
-                                                   mProcessor->getSourceAudioManager()->getAudioSampleDuration(),
-                                                   mBaseNumPixelsPerSecond,
-                                                   mZoomLevel,
-                                                   mAudioRegion.getWidth());
-
-        int full_width = mAudioRegion.getWidth();
-        int visible_width = mViewportPtr->getWidth();
-        int half_visible_width = visible_width / 2;
-
-        auto pixel_offset = static_cast<int>(std::round(std::max(
-            0.0,
-            std::min(playhead_position, static_cast<double>(full_width)) - static_cast<double>(half_visible_width))));
-        auto prev_pixel_offset = mViewportPtr->getViewPositionX();
-
-        if (pixel_offset != prev_pixel_offset)
-            mViewportPtr->setViewPosition(pixel_offset, 0);
+        auto playhead_time = std::min(mProcessor->getPlayer()->getPlayheadPositionSeconds(), mDurationAvailable);
+        setViewStartTime(playhead_time - _getVisibleDuration() / 2.0);
     }
 }
 
@@ -212,29 +237,38 @@ void CombinedAudioMidiRegion::_setZoomLevel(double inZoomLevel)
     mAudioRegion.setZoomLevel(mZoomLevel);
     mTextRegion.setZoomLevel(mZoomLevel);
     mProcessor->getValueTree().setPropertyExcludingListener(this, NnId::ZoomLevelId, mZoomLevel, nullptr);
-    resizeAccordingToNumSamplesAvailable();
+
+    // The view start time is kept, only the visible duration changes
+    updateTimeRange();
+}
+
+double CombinedAudioMidiRegion::_getNumPixelsPerSecond() const
+{
+    return mBaseNumPixelsPerSecond * mZoomLevel;
 }
 
-void CombinedAudioMidiRegion::moved()
+double CombinedAudioMidiRegion::_getVisibleDuration() const
 {
-    Component::moved();
+    return getWidth() / _getNumPixelsPerSecond();
+}
 
-    const double pixelsPerSecond = mBaseNumPixelsPerSecond * mZoomLevel;
-    if (pixelsPerSecond <= 0.0) {
-        return;
-    }
+double CombinedAudioMidiRegion::_getMaxViewStartTime() const
+{
+    return std::max(0.0, mDurationAvailable - _getVisibleDuration());
+}
 
-    const double offsetSeconds = -static_cast<double>(getX()) / pixelsPerSecond;
-    mTextRegion.setViewportOffset(offsetSeconds);
+void CombinedAudioMidiRegion::_updateScrollBar()
+{
+    mScrollBar.setRangeLimits(0.0, std::max(mDurationAvailable, _getVisibleDuration()), dontSendNotification);
+    mScrollBar.setCurrentRange(mViewStartTime, _getVisibleDuration(), dontSendNotification);
+    mScrollBar.setSingleStepSize(mWheelScrollPixels / _getNumPixelsPerSecond());
 }
 
 void CombinedAudioMidiRegion::valueTreePropertyChanged(ValueTree& treeWhosePropertyHasChanged,
                                                        const Identifier& property)
 {
     if (property == NnId::ZoomLevelId) {
-        auto time_start_view = mViewportPtr->getViewPositionX() / (mBaseNumPixelsPerSecond * mZoomLevel);
         _setZoomLevel(treeWhosePropertyHasChanged.getProperty(property));
-        mViewportPtr->setViewPosition(roundToInt(time_start_view * mBaseNumPixelsPerSecond * mZoomLevel), 0);
     }
 }
 
@@ -10,22 +10,27 @@
 #include "AudioRegion.h"
 #include "Keyboard.h"
 #include "PianoRoll.h"
+#include "PlaybackVBlank.h"
 #include "PluginProcessor.h"
 #include "TextRegion.h"
 
+/**
+ * Timeline showing the audio region, the piano roll and the text region. The component has the size of the visible
+ * area only: horizontal scrolling changes the time offset given to the children instead of moving a full length
+ * component inside a Viewport, so that painting cost and memory do not depend on the file length or zoom level.
+ */
 class CombinedAudioMidiRegion
     : public Component
     , public FileDragAndDropTarget
     , public ChangeListener
     , public ValueTree::Listener
+    , public ScrollBar::Listener
 {
 public:
     CombinedAudioMidiRegion(NeuralNoteAudioProcessor* processor, Keyboard& keyboard);
 
     ~CombinedAudioMidiRegion() override;
 
-    void setViewportPtr(juce::Viewport* inViewportPtr);
-
     void resized() override;
 
     void paint(Graphics& g) override;
@@ -38,14 +43,27 @@ public:
 
     void fileDragExit(const StringArray& files) override;
 
-    void setBaseWidth(int inWidth);
-
     void repaintPianoRoll();
 
-    void resizeAccordingToNumSamplesAvailable();
+    void repaintPianoRoll(const Notes::EventsDiff& inNoteEventsDiff);
+
+    /**
+     * Update the scrollable time range after the amount of audio available changed.
+     */
+    void updateTimeRange();
+
+    /**
+     * Scroll horizontally so that the left edge of the view shows inTimeSeconds (clamped to the scrollable range).
+     * @param inTimeSeconds Time of the left edge of the view.
+     */
+    void setViewStartTime(double inTimeSeconds);
+
+    double getViewStartTime() const;
 
     void changeListenerCallback(juce::ChangeBroadcaster* source) override;
 
+    void scrollBarMoved(ScrollBar* scrollBarThatHasMoved, double newRangeStart) override;
+
     void setCenterView(bool inShouldCenterView);
 
     void mouseWheelMove(const MouseEvent& event, const MouseWheelDetails& wheel) override;
@@ -75,20 +93,29 @@ private:
 
     void _setZoomLevel(double inZoomLevel);
 
-    void moved() override;
+    double _getNumPixelsPerSecond() const;
+
+    double _getVisibleDuration() const;
+
+    double _getMaxViewStartTime() const;
+
+    void _updateScrollBar();
 
     void valueTreePropertyChanged(ValueTree& treeWhosePropertyHasChanged, const Identifier& property) override;
 
     NeuralNoteAudioProcessor* mProcessor;
 
-    juce::Viewport* mViewportPtr = nullptr;
-    juce::VBlankAttachment mVBlankAttachment;
+    PlaybackVBlank mPlaybackVBlank;
 
     const StringArray mSupportedAudioFileExtensions;
 
     bool mShouldCenterView = false;
 
-    int mBaseWidth = 0;
+    double mViewStartTime = 0.0;
+    double mDurationAvailable = 0.0;
+
+    // Scroll distance for one mouse wheel step, same as juce::Viewport default
+    static constexpr double mWheelScrollPixels = 14.0 * 16.0;
 
     const double mMaxZoomLevel = 5.0;
     const double mMinZoomLevel = 0.1;
@@ -97,6 +124,8 @@ private:
     AudioRegion mAudioRegion;
     PianoRoll mPianoRoll;
     TextRegion mTextRegion;
+
+    ScrollBar mScrollBar {false};
 };
 
 #endif // CombinedAudioMidiRegion_h
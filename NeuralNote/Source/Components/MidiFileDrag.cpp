@@ -51,12 +51,22 @@ void MidiFileDrag::mouseDown(const MouseEvent& event)
 
     double export_bpm = mProcessor->getValueTree().getProperty(NnId::ExportTempoId, 120.0);
 
-    auto success_midi_file_creation = mMidiFileWriter.writeMidiFile(
-        mProcessor->getTranscriptionManager()->getNoteEventVector(),
-        out_file,
-        mProcessor->getTranscriptionManager()->getTimeQuantizeOptions().getTimeQuantizeInfo(),
-        export_bpm,
-        static_cast<PitchBendModes>(mProcessor->getParameterValue(ParameterHelpers::PitchBendModeId)));
+    auto* transcription_manager = mProcessor->getTranscriptionManager();
+    const auto& notes_per_channel = transcription_manager->getNoteEventsPerChannel();
+    const auto time_quantize_info = transcription_manager->getTimeQuantizeOptions().getTimeQuantizeInfo();
+    const auto pitch_bend_mode =
+        static_cast<PitchBendModes>(mProcessor->getParameterValue(ParameterHelpers::PitchBendModeId));
+
+    bool success_midi_file_creation;
+
+    // One track per channel when the channels were transcribed separately
+    if (notes_per_channel.size() > 1) {
+        success_midi_file_creation = mMidiFileWriter.writeMidiFile(
+            notes_per_channel, out_file, time_quantize_info, export_bpm, pitch_bend_mode);
+    } else {
+        success_midi_file_creation = mMidiFileWriter.writeMidiFile(
+            transcription_manager->getNoteEventVector(), out_file, time_quantize_info, export_bpm, pitch_bend_mode);
+    }
 
     if (!success_midi_file_creation) {
         NativeMessageBox::showMessageBoxAsync(
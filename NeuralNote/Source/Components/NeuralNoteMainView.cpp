@@ -3,6 +3,8 @@
 //
 
 #include "NeuralNoteMainView.h"
+#include "PosteriorgramIO.h"
+#include "AsyncLogger.h"
 
 NeuralNoteMainView::NeuralNoteMainView(NeuralNoteAudioProcessor& processor)
     : mProcessor(processor)
@@ -10,6 +12,7 @@ NeuralNoteMainView::NeuralNoteMainView(NeuralNoteAudioProcessor& processor)
     , mTranscriptionOptions(processor)
     , mNoteOptions(processor)
     , mQuantizePanel(processor)
+    , mPlaybackVBlank(this, processor.getPlayer(), [this]() { _updatePlayPauseButton(); })
 {
     mProcessor.addListenerToStateValueTree(this);
     jassert(mProcessor.getValueTree().hasProperty(NnId::PlayheadCenteredId));
@@ -71,7 +74,7 @@ NeuralNoteMainView::NeuralNoteMainView(NeuralNoteAudioProcessor& processor)
     mBackButton->onClick = [this]() {
         mProcessor.getPlayer()->reset();
         mPlayPauseButton->setToggleState(false, sendNotification);
-        mVisualizationPanel.getAudioMidiViewport().setViewPositionProportionately(0, 0);
+        mVisualizationPanel.getCombinedAudioMidiRegion().setViewStartTime(0.0);
     };
     mBackButton->setTooltip(NeuralNoteTooltips::back);
     addAndMakeVisible(*mBackButton);
@@ -185,6 +188,65 @@ NeuralNoteMainView::NeuralNoteMainView(NeuralNoteAudioProcessor& processor)
     tooltip_visibility_item.setAction(tooltip_visibility_action);
     mSettingsMenu->addItem(tooltip_visibility_item);
 
+    // Transcribe each channel of the source audio separately
+    auto per_channel_item = PopupMenu::Item("Transcribe Channels Separately");
+    per_channel_item.setID(++item_id);
+    per_channel_item.setEnabled(true);
+    mSettingsMenuItemsShouldBeTicked.emplace_back(per_channel_item.itemID, [this] {
+        return static_cast<bool>(mProcessor.getValueTree().getProperty(NnId::TranscribePerChannelId));
+    });
+
+    per_channel_item.setTicked(mSettingsMenuItemsShouldBeTicked.back().second());
+    per_channel_item.setAction([this] {
+        bool per_channel = mProcessor.getValueTree().getProperty(NnId::TranscribePerChannelId);
+        mProcessor.getValueTree().setProperty(NnId::TranscribePerChannelId, !per_channel, nullptr);
+        _updateSettingsMenuTicks();
+
+        if (mProcessor.getState() == PopulatedAudioAndMidiRegions) {
+            mProcessor.getTranscriptionManager()->setLaunchNewTranscription();
+        }
+    });
+    mSettingsMenu->addItem(per_channel_item);
+
+    // Render the transcription with the internal synth to a wav file
+    auto bounce_item = PopupMenu::Item("Bounce Transcription To Audio...");
+    bounce_item.setID(++item_id);
+    bounce_item.setEnabled(true);
+    bounce_item.setTicked(false);
+    bounce_item.setAction([this] { _bounceTranscriptionToAudio(); });
+    mSettingsMenu->addItem(bounce_item);
+
+    // Posteriorgrams as .npy files, to create notes offline or from posteriorgrams computed elsewhere
+    auto export_posteriorgrams_item = PopupMenu::Item("Export Posteriorgrams...");
+    export_posteriorgrams_item.setID(++item_id);
+    export_posteriorgrams_item.setEnabled(true);
+    export_posteriorgrams_item.setTicked(false);
+    export_posteriorgrams_item.setAction([this] { _exportPosteriorgrams(); });
+    mSettingsMenu->addItem(export_posteriorgrams_item);
+
+    auto import_posteriorgrams_item = PopupMenu::Item("Import Posteriorgrams...");
+    import_posteriorgrams_item.setID(++item_id);
+    import_posteriorgrams_item.setEnabled(true);
+    import_posteriorgrams_item.setTicked(false);
+    import_posteriorgrams_item.setAction([this] { _importPosteriorgrams(); });
+    mSettingsMenu->addItem(import_posteriorgrams_item);
+
+    // Export the MIDI of all the files transcribed by the batch queue
+    auto export_all_midi_item = PopupMenu::Item("Export All MIDI...");
+    export_all_midi_item.setID(++item_id);
+    export_all_midi_item.setEnabled(true);
+    export_all_midi_item.setTicked(false);
+    export_all_midi_item.setAction([this] { _exportAllBatchMidi(); });
+    mSettingsMenu->addItem(export_all_midi_item);
+
+    // Memory held and jobs run by this instance and by all the instances of the process
+    auto resource_usage_item = PopupMenu::Item("Resource Usage...");
+    resource_usage_item.setID(++item_id);
+    resource_usage_item.setEnabled(true);
+    resource_usage_item.setTicked(false);
+    resource_usage_item.setAction([this] { _showResourceUsage(); });
+    mSettingsMenu->addItem(resource_usage_item);
+
     // Check for updates
     auto check_updates_item = PopupMenu::Item("Check for updates");
     check_updates_item.setID(++item_id);
@@ -224,6 +286,29 @@ NeuralNoteMainView::NeuralNoteMainView(NeuralNoteAudioProcessor& processor)
         mProcessor.getAPVTS(), ParameterHelpers::getIdStr(ParameterHelpers::MuteId), *mMuteButton);
     addAndMakeVisible(*mMuteButton);
 
+    mBatchItemSelector = std::make_unique<ComboBox>("BatchItemSelector");
+    mBatchItemSelector->setEditableText(false);
+    mBatchItemSelector->setJustificationType(Justification::centredLeft);
+    mBatchItemSelector->setTooltip(NeuralNoteTooltips::batch_item_selector);
+    mBatchItemSelector->setWantsKeyboardFocus(false);
+    mBatchItemSelector->onChange = [this] {
+        auto item_id = mBatchItemSelector->getSelectedId();
+
+        if (item_id != 0 && item_id != mProcessor.getBatchTranscriptionQueue()->getLoadedItemId()) {
+            mProcessor.getPlayer()->reset();
+
+            if (mProcessor.getBatchTranscriptionQueue()->loadItem(item_id)) {
+                mVisualizationPanel.getCombinedAudioMidiRegion().setViewStartTime(0.0);
+            }
+
+            updateEnablements();
+        }
+    };
+    addChildComponent(*mBatchItemSelector);
+
+    mProcessor.getBatchTranscriptionQueue()->addChangeListener(this);
+    _updateBatchItemSelector();
+
     addAndMakeVisible(mVisualizationPanel);
     addAndMakeVisible(mTranscriptionOptions);
     addAndMakeVisible(mNoteOptions);
@@ -247,11 +332,14 @@ NeuralNoteMainView::NeuralNoteMainView(NeuralNoteAudioProcessor& processor)
     addChildComponent(mUpdateCheck.get());
     mUpdateCheck->checkForUpdate(false);
 
-    startTimerHz(30);
+    mProcessor.addStateChangeListener(this);
+    _updateFromProcessorState();
 }
 
 NeuralNoteMainView::~NeuralNoteMainView()
 {
+    mProcessor.removeStateChangeListener(this);
+    mProcessor.getBatchTranscriptionQueue()->removeChangeListener(this);
     mProcessor.removeListenerFromStateValueTree(this);
     LookAndFeel::setDefaultLookAndFeel(nullptr);
 }
@@ -268,6 +356,8 @@ void NeuralNoteMainView::resized()
 
     mMuteButton->setBounds(931, 43, 35, 35);
 
+    mBatchItemSelector->setBounds(680, 88, 290, 22);
+
     mVisualizationPanel.setBounds(328, 120, 642, 491);
     mTranscriptionOptions.setBounds(29, 120, 274, 190);
     mNoteOptions.setBounds(29, 334, 274, 133);
@@ -281,7 +371,7 @@ void NeuralNoteMainView::paint(Graphics& g)
     g.drawImageAt(mBackgroundImage, 0, 0);
 }
 
-void NeuralNoteMainView::timerCallback()
+void NeuralNoteMainView::_updateFromProcessorState()
 {
     auto processor_state = mProcessor.getState();
     if (mRecordButton->getToggleState() && processor_state != Recording) {
@@ -289,13 +379,32 @@ void NeuralNoteMainView::timerCallback()
         updateEnablements();
     }
 
+    _updatePlayPauseButton();
+    mPlaybackVBlank.update();
+
+    if (mPrevState != processor_state) {
+        mPrevState = processor_state;
+        updateEnablements();
+        // The loaded file changes when the state changes (new file dropped, cleared...)
+        _updateBatchItemSelector();
+    }
+}
+
+void NeuralNoteMainView::_updatePlayPauseButton()
+{
     if (mPlayPauseButton->getToggleState() != mProcessor.getPlayer()->isPlaying()) {
         mPlayPauseButton->setToggleState(mProcessor.getPlayer()->isPlaying(), sendNotification);
     }
+}
 
-    if (mPrevState != processor_state) {
-        mPrevState = processor_state;
+void NeuralNoteMainView::changeListenerCallback(ChangeBroadcaster* source)
+{
+    if (source == mProcessor.getBatchTranscriptionQueue()) {
+        _updateBatchItemSelector();
         updateEnablements();
+    } else {
+        // State change of the processor
+        _updateFromProcessorState();
     }
 }
 
@@ -304,6 +413,11 @@ void NeuralNoteMainView::repaintPianoRoll()
     mVisualizationPanel.repaintPianoRoll();
 }
 
+void NeuralNoteMainView::repaintPianoRoll(const Notes::EventsDiff& inNoteEventsDiff)
+{
+    mVisualizationPanel.repaintPianoRoll(inNoteEventsDiff);
+}
+
 void NeuralNoteMainView::setTimedWords(const std::vector<TimedWord>& words)
 {
     mVisualizationPanel.setTimedWords(words);
@@ -433,6 +547,206 @@ void NeuralNoteMainView::_updateTooltipVisibility()
     }
 }
 
+void NeuralNoteMainView::_updateBatchItemSelector()
+{
+    auto* queue = mProcessor.getBatchTranscriptionQueue();
+    auto items = queue->getItems();
+
+    mBatchItemSelector->clear(dontSendNotification);
+
+    for (const auto& item: items) {
+        auto name = item.file.getFileName();
+
+        switch (item.status) {
+            case BatchTranscriptionQueue::Status::Queued:
+                name += " (queued)";
+                break;
+            case BatchTranscriptionQueue::Status::Transcribing:
+                name += " (transcribing...)";
+                break;
+            case BatchTranscriptionQueue::Status::Failed:
+                name += " (failed: " + item.errorMessage + ")";
+                break;
+            case BatchTranscriptionQueue::Status::Done:
+                break;
+        }
+
+        mBatchItemSelector->addItem(name, item.id);
+        mBatchItemSelector->setItemEnabled(item.id, item.status == BatchTranscriptionQueue::Status::Done);
+    }
+
+    mBatchItemSelector->setSelectedId(queue->getLoadedItemId(), dontSendNotification);
+    mBatchItemSelector->setTextWhenNothingSelected(String(items.size()) + " files");
+    mBatchItemSelector->setVisible(items.size() > 1);
+
+    auto state = mProcessor.getState();
+    mBatchItemSelector->setEnabled(state == EmptyAudioAndMidiRegions || state == PopulatedAudioAndMidiRegions);
+}
+
+void NeuralNoteMainView::_exportAllBatchMidi()
+{
+    if (mProcessor.getBatchTranscriptionQueue()->getNumItems() == 0) {
+        NativeMessageBox::showMessageBoxAsync(
+            MessageBoxIconType::NoIcon, "Export All MIDI", "Drop several audio files to transcribe them at once.");
+        return;
+    }
+
+    mExportDirectoryChooser = std::make_shared<FileChooser>(
+        "Select Export Directory", File::getSpecialLocation(File::userMusicDirectory), "", true, false, this);
+
+    mExportDirectoryChooser->launchAsync(
+        FileBrowserComponent::openMode | FileBrowserComponent::canSelectDirectories, [this](const FileChooser& fc) {
+            if (fc.getResults().isEmpty())
+                return;
+
+            auto* queue = mProcessor.getBatchTranscriptionQueue();
+            const auto directory = fc.getResult();
+            const auto num_items = queue->getNumItems();
+
+            queue->exportAllMidi(directory, [directory, num_items](int inNumFilesWritten) {
+                NativeMessageBox::showMessageBoxAsync(MessageBoxIconType::NoIcon,
+                                                       "Export All MIDI",
+                                                       String(inNumFilesWritten) + " of " + String(num_items)
+                                                           + " MIDI files written to " + directory.getFullPathName()
+                                                           + ".");
+            });
+        });
+}
+
+void NeuralNoteMainView::_bounceTranscriptionToAudio()
+{
+    if (mProcessor.getState() != PopulatedAudioAndMidiRegions) {
+        NativeMessageBox::showMessageBoxAsync(
+            MessageBoxIconType::NoIcon, "Bounce Transcription To Audio", "Nothing to bounce: transcribe audio first.");
+        return;
+    }
+
+    String filename = mProcessor.getSourceAudioManager()->getDroppedFilename();
+    filename = (filename.isEmpty() ? String("NNTranscription") : filename + "_NNTranscription") + ".wav";
+
+    mBounceFileChooser = std::make_shared<FileChooser>("Bounce Transcription To Audio",
+                                                       File::getSpecialLocation(File::userMusicDirectory)
+                                                           .getChildFile(filename),
+                                                       "*.wav",
+                                                       true,
+                                                       false,
+                                                       this);
+
+    mBounceFileChooser->launchAsync(
+        FileBrowserComponent::saveMode | FileBrowserComponent::canSelectFiles
+            | FileBrowserComponent::warnAboutOverwriting,
+        [this](const FileChooser& fc) {
+            if (fc.getResults().isEmpty())
+                return;
+
+            auto out_file = fc.getResult().withFileExtension(".wav");
+
+            mProcessor.getPlayer()->getOfflineSynthRenderer()->launchRenderToFile(
+                mProcessor.getTranscriptionManager()->getNoteEventVector(),
+                mProcessor.getSourceAudioManager()->getAudioSampleDuration(),
+                44100.0,
+                out_file,
+                [out_file](bool inSuccess) {
+                    NativeMessageBox::showMessageBoxAsync(MessageBoxIconType::NoIcon,
+                                                           "Bounce Transcription To Audio",
+                                                           inSuccess ? "Transcription rendered to "
+                                                                           + out_file.getFullPathName() + "."
+                                                                     : "Could not write the audio file.");
+                });
+        });
+}
+
+void NeuralNoteMainView::_exportPosteriorgrams()
+{
+    if (mProcessor.getState() != PopulatedAudioAndMidiRegions) {
+        NativeMessageBox::showMessageBoxAsync(
+            MessageBoxIconType::NoIcon, "Export Posteriorgrams", "Nothing to export: transcribe audio first.");
+        return;
+    }
+
+    mPosteriorgramDirectoryChooser = std::make_shared<FileChooser>(
+        "Select Export Directory", File::getSpecialLocation(File::userMusicDirectory), "", true, false, this);
+
+    mPosteriorgramDirectoryChooser->launchAsync(
+        FileBrowserComponent::openMode | FileBrowserComponent::canSelectDirectories, [this](const FileChooser& fc) {
+            if (fc.getResults().isEmpty() || mProcessor.getState() != PopulatedAudioAndMidiRegions)
+                return;
+
+            std::string error;
+            bool success = PosteriorgramIO::save(mProcessor.getTranscriptionManager()->getPosteriorgrams(),
+                                                 fc.getResult().getFullPathName().toStdString(),
+                                                 error);
+
+            NativeMessageBox::showMessageBoxAsync(MessageBoxIconType::NoIcon,
+                                                   "Export Posteriorgrams",
+                                                   success ? "Posteriorgrams written to "
+                                                                 + fc.getResult().getFullPathName() + "."
+                                                           : String(error));
+        });
+}
+
+void NeuralNoteMainView::_importPosteriorgrams()
+{
+    if (mProcessor.getState() != PopulatedAudioAndMidiRegions) {
+        NativeMessageBox::showMessageBoxAsync(MessageBoxIconType::NoIcon,
+                                               "Import Posteriorgrams",
+                                               "Load the audio the posteriorgrams were computed from first.");
+        return;
+    }
+
+    mPosteriorgramDirectoryChooser = std::make_shared<FileChooser>(
+        "Select Posteriorgram Directory", File::getSpecialLocation(File::userMusicDirectory), "", true, false, this);
+
+    mPosteriorgramDirectoryChooser->launchAsync(
+        FileBrowserComponent::openMode | FileBrowserComponent::canSelectDirectories, [this](const FileChooser& fc) {
+            if (fc.getResults().isEmpty() || mProcessor.getState() != PopulatedAudioAndMidiRegions)
+                return;
+
+            auto posteriorgrams = std::make_shared<BasicPitch::Posteriorgrams>();
+            std::string error;
+
+            if (!PosteriorgramIO::load(fc.getResult().getFullPathName().toStdString(), *posteriorgrams, error)) {
+                NativeMessageBox::showMessageBoxAsync(MessageBoxIconType::NoIcon, "Import Posteriorgrams", error);
+                return;
+            }
+
+            // Notes are created from the imported posteriorgrams, the model is not run
+            mProcessor.getTranscriptionManager()->launchTranscribeJob(std::move(posteriorgrams));
+        });
+}
+
+void NeuralNoteMainView::_showResourceUsage()
+{
+    auto format_snapshot = [](const ResourceStats::Snapshot& inSnapshot) {
+        String text;
+        text << "Memory: " << File::descriptionOfSizeInBytes(static_cast<int64>(inSnapshot.getTotalBytes())) << "\n";
+
+        for (size_t i = 0; i < ResourceStats::NUM_MEMORY_TYPES; i++) {
+            text << "    " << ResourceStats::getName(static_cast<ResourceStats::Memory>(i)) << ": "
+                 << File::descriptionOfSizeInBytes(static_cast<int64>(inSnapshot.bytes[i])) << "\n";
+        }
+
+        for (size_t i = 0; i < ResourceStats::NUM_JOB_TYPES; i++) {
+            const auto& job = inSnapshot.jobs[i];
+            text << ResourceStats::getName(static_cast<ResourceStats::Job>(i)) << " jobs: " << String(job.count)
+                 << ", total " << String(job.totalMs / 1000.0, 1) << " s, max " << String(job.maxMs / 1000.0, 1)
+                 << " s\n";
+        }
+
+        return text;
+    };
+
+    const auto snapshots = ResourceStats::Registry::getInstance().getSnapshots();
+    const auto& stats = mProcessor.getResourceStats();
+
+    String message;
+    message << "This instance (" << stats.getName() << ")\n" << format_snapshot(stats.getSnapshot()) << "\n";
+    message << "All " << String(snapshots.size()) << " instance(s) of this process\n"
+            << format_snapshot(ResourceStats::Registry::getTotal(snapshots));
+
+    NativeMessageBox::showMessageBoxAsync(MessageBoxIconType::NoIcon, "Resource Usage", message);
+}
+
 void NeuralNoteMainView::reloadBackground()
 {
     // Try to load from Desktop first (for easy testing)
@@ -441,14 +755,14 @@ void NeuralNoteMainView::reloadBackground()
     if (desktopBg.existsAsFile()) {
         mBackgroundImage = ImageCache::getFromFile(desktopBg)
                                .rescaled(1000, 640, Graphics::ResamplingQuality::highResamplingQuality);
-        DBG("Loaded background from: " + desktopBg.getFullPathName());
+        NN_LOG_DEBUG(UI, "Loaded background from: {}", desktopBg.getFullPathName().toRawUTF8());
     } else {
         // Fallback to embedded default
         mBackgroundImage = ImageCache::getFromMemory(BinaryData::background_png, BinaryData::background_pngSize)
                                .rescaled(1000, 640, Graphics::ResamplingQuality::highResamplingQuality);
-        DBG("Loaded default embedded background");
+        NN_LOG_DEBUG(UI, "Loaded default embedded background");
     }
 
     repaint();
-    DBG("Background reloaded! (Cmd+B to reload again)");
+    NN_LOG_DEBUG(UI, "Background reloaded (Cmd+B to reload again)");
 }
@@ -16,11 +16,12 @@
 #include "NeuralNoteLNF.h"
 #include "NnId.h"
 #include "UpdateCheck.h"
+#include "PlaybackVBlank.h"
 
 class NeuralNoteMainView
     : public Component
-    , public Timer
     , public ValueTree::Listener
+    , public ChangeListener
 {
 public:
     explicit NeuralNoteMainView(NeuralNoteAudioProcessor& processor);
@@ -31,10 +32,12 @@ public:
 
     void paint(Graphics& g) override;
 
-    void timerCallback() override;
+    void changeListenerCallback(ChangeBroadcaster* source) override;
 
     void repaintPianoRoll();
 
+    void repaintPianoRoll(const Notes::EventsDiff& inNoteEventsDiff);
+
     bool keyPressed(const KeyPress& key) override;
 
     void setTimedWords(const std::vector<TimedWord>& words);
@@ -44,12 +47,37 @@ public:
 private:
     void updateEnablements();
 
+    /**
+     * Update the buttons and enablements after a state change of the processor.
+     */
+    void _updateFromProcessorState();
+
+    void _updatePlayPauseButton();
+
     void valueTreePropertyChanged(ValueTree& treeWhosePropertyHasChanged, const Identifier& property) override;
 
     void _updateSettingsMenuTicks();
 
     void _updateTooltipVisibility();
 
+    /**
+     * Refill the batch item selector from the batch transcription queue. Hidden when less than two files were dropped.
+     */
+    void _updateBatchItemSelector();
+
+    void _exportAllBatchMidi();
+
+    void _bounceTranscriptionToAudio();
+
+    void _exportPosteriorgrams();
+
+    void _importPosteriorgrams();
+
+    /**
+     * Show the memory and job statistics of this instance and of all the instances of the process.
+     */
+    void _showResourceUsage();
+
     NeuralNoteAudioProcessor& mProcessor;
     NeuralNoteLNF mLNF;
 
@@ -87,6 +115,11 @@ private:
     std::unique_ptr<Knob> mMinNoteSlider;
     std::unique_ptr<Knob> mMaxNoteSlider;
 
+    std::unique_ptr<ComboBox> mBatchItemSelector;
+    std::shared_ptr<FileChooser> mExportDirectoryChooser;
+    std::shared_ptr<FileChooser> mBounceFileChooser;
+    std::shared_ptr<FileChooser> mPosteriorgramDirectoryChooser;
+
     std::unique_ptr<ComboBox> mKey; // C, C#, D, D# ...
     std::unique_ptr<ComboBox> mMode; // Major, Minor, Chromatic
 
@@ -96,6 +129,9 @@ private:
     int mNumCallbacksStuckInProcessingState = 0;
 
     std::unique_ptr<UpdateCheck> mUpdateCheck;
+
+    // Playback stops on the audio thread at the end of the audio, without notifying the state change listeners
+    PlaybackVBlank mPlaybackVBlank;
 };
 
 #endif // PluginMainView_h
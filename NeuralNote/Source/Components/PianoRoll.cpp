@@ -38,6 +38,42 @@ void PianoRoll::setZoomLevel(double inZoomLevel)
     repaint();
 }
 
+void PianoRoll::repaintNoteChanges(const Notes::EventsDiff& inNoteEventsDiff)
+{
+    if (inNoteEventsDiff.isEmpty())
+        return;
+
+    if (inNoteEventsDiff.getNumChanges() > mMaxNumChangesToRepaintSeparately) {
+        repaint();
+        return;
+    }
+
+    auto repaint_note_event = [this](const Notes::Event& inNoteEvent) {
+        auto area = _getNoteEventArea(inNoteEvent).getIntersection(getLocalBounds());
+
+        if (!area.isEmpty())
+            repaint(area);
+    };
+
+    for (const auto& note_event: inNoteEventsDiff.removed)
+        repaint_note_event(note_event);
+
+    for (const auto& [prev_note_event, new_note_event]: inNoteEventsDiff.modified) {
+        repaint_note_event(prev_note_event);
+        repaint_note_event(new_note_event);
+    }
+
+    for (const auto& note_event: inNoteEventsDiff.added)
+        repaint_note_event(note_event);
+}
+
+void PianoRoll::setViewStartTime(double inTimeSeconds)
+{
+    mViewStartTime = inTimeSeconds;
+    mPlayhead.setViewStartTime(inTimeSeconds);
+    repaint();
+}
+
 void PianoRoll::paint(Graphics& g)
 {
     Rectangle<float> local_bounds = {0, 0, static_cast<float>(getWidth()), static_cast<float>(getHeight())};
@@ -67,8 +103,13 @@ void PianoRoll::paint(Graphics& g)
             _drawBeatVerticalLines(g);
         }
 
-        // Draw notes
+        const double view_end_time = _pixelToTime(rect_width);
+
+        // Draw notes, skipping those outside of the visible time range
         for (auto& note_event: mProcessor->getTranscriptionManager()->getNoteEventVector()) {
+            if (note_event.endTime < mViewStartTime || note_event.startTime > view_end_time)
+                continue;
+
             auto [note_y_start, note_height] = _getNoteHeightAndWidthPianoRoll(note_event.pitch);
             auto start = static_cast<float>(note_event.startTime);
             auto end = static_cast<float>(note_event.endTime);
@@ -138,12 +179,12 @@ void PianoRoll::valueTreePropertyChanged(ValueTree& treeWhosePropertyHasChanged,
 
 float PianoRoll::_timeToPixel(float inTime) const
 {
-    return inTime * static_cast<float>(mBaseNumPixelsPerSecond * mZoomLevel);
+    return static_cast<float>((inTime - mViewStartTime) * mBaseNumPixelsPerSecond * mZoomLevel);
 }
 
 float PianoRoll::_pixelToTime(float inPixel) const
 {
-    return inPixel / static_cast<float>(mBaseNumPixelsPerSecond * mZoomLevel);
+    return static_cast<float>(mViewStartTime + inPixel / (mBaseNumPixelsPerSecond * mZoomLevel));
 }
 
 std::pair<float, float> PianoRoll::_getNoteHeightAndWidthPianoRoll(int inNote) const
@@ -176,6 +217,25 @@ float PianoRoll::_noteBottomY(int inNote) const
     return static_cast<float>(getHeight()) - mKeyboard.getKeyStartPosition(inNote);
 }
 
+Rectangle<int> PianoRoll::_getNoteEventArea(const Notes::Event& inNoteEvent) const
+{
+    auto [note_y_start, note_height] = _getNoteHeightAndWidthPianoRoll(inNoteEvent.pitch);
+
+    // Pitch bend path can go above or below the note rectangle, see paint()
+    float bend_extent = 0.0f;
+
+    for (auto bend: inNoteEvent.bends)
+        bend_extent = std::max(bend_extent, static_cast<float>(std::abs(bend)) * note_height / 3.0f);
+
+    auto start_x = _timeToPixel(static_cast<float>(inNoteEvent.startTime));
+    auto end_x = _timeToPixel(static_cast<float>(inNoteEvent.endTime));
+
+    // Margin for the outline and anti-aliasing
+    return Rectangle<float>(start_x, note_y_start - bend_extent, end_x - start_x, note_height + 2.0f * bend_extent)
+        .getSmallestIntegerContainer()
+        .expanded(2);
+}
+
 bool PianoRoll::_isWhiteKey(int inNote)
 {
     int note = inNote % 12;
@@ -200,8 +260,10 @@ void PianoRoll::_drawBeatVerticalLines(Graphics& g) const
 
     const double beat_increments = 4.0 / tq_info.timeSignatureDenom;
 
-    // Beat number in quarter notes
-    double beat_pos_qn = 0;
+    // Beat number in quarter notes, starting from the first beat visible
+    const auto first_beat_idx =
+        std::max(0.0, std::floor((mViewStartTime / seconds_per_beat + offset_bar_start) / beat_increments));
+    double beat_pos_qn = first_beat_idx * beat_increments;
     double beat_pixel = _beatPosQnToPixel(beat_pos_qn, offset_bar_start, seconds_per_beat);
 
     const auto width = static_cast<float>(getWidth());
@@ -223,5 +285,5 @@ void PianoRoll::_drawBeatVerticalLines(Graphics& g) const
 
 double PianoRoll::_beatPosQnToPixel(double inPosQn, double inOffsetBarStart, double inSecondsPerBeat) const
 {
-    return static_cast<float>((inPosQn - inOffsetBarStart) * inSecondsPerBeat * mBaseNumPixelsPerSecond * mZoomLevel);
+    return ((inPosQn - inOffsetBarStart) * inSecondsPerBeat - mViewStartTime) * mBaseNumPixelsPerSecond * mZoomLevel;
 }
\ No newline at end of file
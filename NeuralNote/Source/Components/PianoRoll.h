@@ -33,6 +33,18 @@ public:
 
     void setZoomLevel(double inZoomLevel);
 
+    /**
+     * Repaint only the areas covered by the previous and new versions of the changed notes.
+     * @param inNoteEventsDiff Changes made to the note events displayed.
+     */
+    void repaintNoteChanges(const Notes::EventsDiff& inNoteEventsDiff);
+
+    /**
+     * Set the time shown at the left edge of the piano roll.
+     * @param inTimeSeconds Time in seconds.
+     */
+    void setViewStartTime(double inTimeSeconds);
+
 private:
     void valueTreePropertyChanged(ValueTree& treeWhosePropertyHasChanged, const Identifier& property) override;
 
@@ -65,12 +77,21 @@ private:
 
     float _getNoteWidth(int inNote) const;
 
+    /**
+     * @return Area covered by the drawing of the note event, including its pitch bend path.
+     */
+    Rectangle<int> _getNoteEventArea(const Notes::Event& inNoteEvent) const;
+
+    // Above this number of changes a single repaint of the whole piano roll is cheaper than many small ones
+    static constexpr size_t mMaxNumChangesToRepaintSeparately = 64;
+
     void _drawBeatVerticalLines(Graphics& g) const;
 
     double _beatPosQnToPixel(double inPosQn, double inOffsetBarStart, double inSecondsPerBeat) const;
 
     const double mBaseNumPixelsPerSecond;
     double mZoomLevel = 1.0;
+    double mViewStartTime = 0.0;
 
     ColourGradient mNoteGradient;
 
@@ -0,0 +1,43 @@
+#include "PlaybackVBlank.h"
+
+PlaybackVBlank::PlaybackVBlank(Component* inComponent, Player* inPlayer, std::function<void()> inCallback)
+    : mComponent(inComponent)
+    , mPlayer(inPlayer)
+    , mCallback(std::move(inCallback))
+{
+}
+
+PlaybackVBlank::~PlaybackVBlank()
+{
+    cancelPendingUpdate();
+}
+
+void PlaybackVBlank::update()
+{
+    if (mPlayer->isPlaying() && mVBlankAttachment == nullptr) {
+        mVBlankAttachment = std::make_unique<VBlankAttachment>(mComponent, [this]() { _onVBlankCallback(); });
+    }
+}
+
+bool PlaybackVBlank::isAttached() const
+{
+    return mVBlankAttachment != nullptr;
+}
+
+void PlaybackVBlank::handleAsyncUpdate()
+{
+    // Playback may have restarted since the last callback
+    if (!mPlayer->isPlaying()) {
+        mVBlankAttachment.reset();
+    }
+}
+
+void PlaybackVBlank::_onVBlankCallback()
+{
+    mCallback();
+
+    // The attachment cannot be destroyed from its own callback
+    if (!mPlayer->isPlaying()) {
+        triggerAsyncUpdate();
+    }
+}
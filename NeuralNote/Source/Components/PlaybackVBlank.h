@@ -0,0 +1,39 @@
+#ifndef PlaybackVBlank_h
+#define PlaybackVBlank_h
+
+#include <JuceHeader.h>
+
+#include "Player.h"
+
+/**
+ * Calls a callback on each vertical blank of the display, but only while the player is playing, so that idle instances
+ * do not run anything at the display rate. Once playback stopped, the callback is called a last time before detaching.
+ */
+class PlaybackVBlank : private AsyncUpdater
+{
+public:
+    PlaybackVBlank(Component* inComponent, Player* inPlayer, std::function<void()> inCallback);
+
+    ~PlaybackVBlank() override;
+
+    /**
+     * Attach to the vertical blank if the player is playing. To call on the message thread when the playing state may
+     * have changed, e.g. from a state change listener of the processor.
+     */
+    void update();
+
+    bool isAttached() const;
+
+private:
+    void handleAsyncUpdate() override;
+
+    void _onVBlankCallback();
+
+    Component* mComponent;
+    Player* mPlayer;
+    std::function<void()> mCallback;
+
+    std::unique_ptr<VBlankAttachment> mVBlankAttachment;
+};
+
+#endif // PlaybackVBlank_h
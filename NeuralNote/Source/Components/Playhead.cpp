@@ -5,10 +5,19 @@
 #include "Playhead.h"
 Playhead::Playhead(NeuralNoteAudioProcessor* inProcessor, double inNumPixelsPerSecond)
     : mProcessor(inProcessor)
-    , mVBlankAttachment(this, [this]() { _onVBlankCallback(); })
+    , mPlaybackVBlank(this, inProcessor->getPlayer(), [this]() { _updatePlayhead(); })
     , mBaseNumPixelsPerSecond(inNumPixelsPerSecond)
 {
     setInterceptsMouseClicks(false, false);
+
+    mProcessor->addStateChangeListener(this);
+    _updatePlayhead();
+    mPlaybackVBlank.update();
+}
+
+Playhead::~Playhead()
+{
+    mProcessor->removeStateChangeListener(this);
 }
 
 void Playhead::resized()
@@ -19,7 +28,10 @@ void Playhead::paint(Graphics& g)
 {
     if (mAudioSampleDuration > 0 && mProcessor->getState() == PopulatedAudioAndMidiRegions) {
         auto playhead_x = static_cast<int>(std::round(computePlayheadPositionPixel(
-            mCurrentPlayerPlayheadTime, mAudioSampleDuration, mBaseNumPixelsPerSecond, mZoomLevel, getWidth())));
+            mCurrentPlayerPlayheadTime, mAudioSampleDuration, mViewStartTime, mBaseNumPixelsPerSecond * mZoomLevel)));
+
+        if (playhead_x < 0 || playhead_x > getWidth())
+            return;
 
         g.setColour(juce::Colours::white);
         g.drawVerticalLine(playhead_x, 0, static_cast<float>(getHeight()));
@@ -43,29 +55,56 @@ void Playhead::setPlayheadTime(double inNewTime)
 
 double Playhead::computePlayheadPositionPixel(double inPlayheadPositionSeconds,
                                               double inSampleDuration,
-                                              double inBaseNumPixelPerSecond,
-                                              double inZoomLevel,
-                                              int inWidth)
+                                              double inViewStartSeconds,
+                                              double inNumPixelsPerSecond)
 {
-    auto playhead_pos =
-        inPlayheadPositionSeconds / inSampleDuration
-        * std::min(inBaseNumPixelPerSecond * inZoomLevel * inSampleDuration, static_cast<double>(inWidth));
-    return jlimit(0.0, static_cast<double>(inWidth), playhead_pos);
+    auto playhead_time = jlimit(0.0, inSampleDuration, inPlayheadPositionSeconds);
+    return (playhead_time - inViewStartSeconds) * inNumPixelsPerSecond;
 }
 
 void Playhead::setZoomLevel(double inZoomLevel)
 {
     mZoomLevel = inZoomLevel;
+    repaint();
 }
 
-void Playhead::_onVBlankCallback()
+void Playhead::setViewStartTime(double inTimeSeconds)
+{
+    mViewStartTime = inTimeSeconds;
+    repaint();
+}
+
+void Playhead::changeListenerCallback(ChangeBroadcaster* source)
+{
+    juce::ignoreUnused(source);
+
+    // The playhead moves on its own only while playing, otherwise it changes with the state or when set by the user
+    _updatePlayhead();
+    mPlaybackVBlank.update();
+}
+
+void Playhead::_updatePlayhead()
 {
     auto playhead_time = mProcessor->getPlayer()->getPlayheadPositionSeconds();
     auto sample_duration = mProcessor->getSourceAudioManager()->getAudioSampleDuration();
 
-    if (mCurrentPlayerPlayheadTime != playhead_time || sample_duration != mAudioSampleDuration) {
+    if (sample_duration != mAudioSampleDuration) {
         mCurrentPlayerPlayheadTime = playhead_time;
         mAudioSampleDuration = sample_duration;
         repaint();
+    } else if (mCurrentPlayerPlayheadTime != playhead_time) {
+        // Only repaint the strips around the previous and new playhead positions
+        _repaintAroundPlayhead();
+        mCurrentPlayerPlayheadTime = playhead_time;
+        _repaintAroundPlayhead();
     }
 }
+
+void Playhead::_repaintAroundPlayhead()
+{
+    auto playhead_x = static_cast<int>(std::round(computePlayheadPositionPixel(
+        mCurrentPlayerPlayheadTime, mAudioSampleDuration, mViewStartTime, mBaseNumPixelsPerSecond * mZoomLevel)));
+
+    auto half_width = static_cast<int>(std::ceil(mTriangleSide / 2.0f)) + 1;
+    repaint(playhead_x - half_width, 0, 2 * half_width + 1, getHeight());
+}
@@ -6,36 +6,55 @@
 #define Playhead_h
 
 #include "PluginProcessor.h"
+#include "PlaybackVBlank.h"
 #include <JuceHeader.h>
 
-class Playhead : public Component
+class Playhead
+    : public Component
+    , public ChangeListener
 {
 public:
     Playhead(NeuralNoteAudioProcessor* inProcessor, double inNumPixelsPerSecond);
 
+    ~Playhead() override;
+
     void resized() override;
 
     void paint(juce::Graphics& g) override;
 
     void setPlayheadTime(double inNewTime);
 
+    /**
+     * Compute the playhead position relative to the left edge of the view.
+     * @param inPlayheadPositionSeconds Playhead position.
+     * @param inSampleDuration Duration of the audio, the playhead is clamped to it.
+     * @param inViewStartSeconds Time at the left edge of the view.
+     * @param inNumPixelsPerSecond Zoomed number of pixels per second.
+     * @return Position in pixels, outside of the component bounds if the playhead is not visible.
+     */
     static double computePlayheadPositionPixel(double inPlayheadPositionSeconds,
                                                double inSampleDuration,
-                                               double inBaseNumPixelPerSecond,
-                                               double inZoomLevel,
-                                               int inWidth);
+                                               double inViewStartSeconds,
+                                               double inNumPixelsPerSecond);
 
     void setZoomLevel(double inZoomLevel);
 
+    void setViewStartTime(double inTimeSeconds);
+
+    void changeListenerCallback(ChangeBroadcaster* source) override;
+
 private:
-    void _onVBlankCallback();
+    void _updatePlayhead();
+
+    void _repaintAroundPlayhead();
 
     NeuralNoteAudioProcessor* mProcessor;
-    VBlankAttachment mVBlankAttachment;
+    PlaybackVBlank mPlaybackVBlank;
 
     double mCurrentPlayerPlayheadTime = 0;
     double mAudioSampleDuration = 0;
     double mZoomLevel = 1.0;
+    double mViewStartTime = 0.0;
     const double mBaseNumPixelsPerSecond;
 
     static constexpr float mTriangleSide = 8.0f;
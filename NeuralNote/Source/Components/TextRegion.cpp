@@ -1,9 +1,18 @@
 #include "TextRegion.h"
+#include "AsyncLogger.h"
 
 TextRegion::TextRegion(NeuralNoteAudioProcessor* processor)
     : mProcessor(processor)
+    , mPlaybackVBlank(this, processor->getPlayer(), [this]() { _updateCurrentWord(); })
 {
-    startTimerHz(30); // Refresh at 30 Hz for smooth playback display
+    // The highlighted word only changes while playing
+    mProcessor->addStateChangeListener(this);
+    mPlaybackVBlank.update();
+}
+
+TextRegion::~TextRegion()
+{
+    mProcessor->removeStateChangeListener(this);
 }
 
 void TextRegion::resized()
@@ -13,8 +22,7 @@ void TextRegion::resized()
 
 void TextRegion::paint(Graphics& g)
 {
-    // Debug: Always show we're painting
-    DBG("TextRegion::paint - words count: " + juce::String(mTimedWords.size()) + ", bounds: " + getLocalBounds().toString());
+    NN_LOG_DEBUG(UI, "TextRegion::paint - words count: {}, width: {}", mTimedWords.size(), getWidth());
 
     if (mTimedWords.empty()) {
         // Semi-transparent background
@@ -27,6 +35,8 @@ void TextRegion::paint(Graphics& g)
         g.drawText("Text transcription will appear here",
                    getLocalBounds(),
                    Justification::centred);
+
+        _drawBackendDescription(g);
         return;
     }
 
@@ -36,7 +46,8 @@ void TextRegion::paint(Graphics& g)
     // Draw all words with timestamps
     g.setFont(Font(FontOptions()).withPointHeight(12.0f));
 
-    for (const auto& word : mTimedWords) {
+    for (size_t i = 0; i < mTimedWords.size(); i++) {
+        const auto& word = mTimedWords[i];
         float x = timeToPixel(word.startTime);
         float width = timeToPixel(word.endTime) - x;
 
@@ -46,12 +57,7 @@ void TextRegion::paint(Graphics& g)
         }
 
         // Highlight current word during playback
-        bool isCurrent = false;
-        auto* player = mProcessor->getPlayer();
-        if (player && player->isPlaying()) {
-            double playbackTime = player->getPlayheadPositionSeconds();
-            isCurrent = (playbackTime >= word.startTime && playbackTime < word.endTime);
-        }
+        bool isCurrent = static_cast<int>(i) == mCurrentWordIndex;
 
         // Draw word background
         if (isCurrent) {
@@ -66,8 +72,8 @@ void TextRegion::paint(Graphics& g)
     }
 
     // Draw full text at bottom as subtitle
-    std::string currentWord = getCurrentWord();
-    if (!currentWord.empty()) {
+    if (mCurrentWordIndex >= 0) {
+        const auto& currentWord = mTimedWords[static_cast<size_t>(mCurrentWordIndex)].text;
         g.setColour(WHITE_SOLID);
         g.setFont(Font(FontOptions(Font::bold)).withPointHeight(16.0f));
         Rectangle<int> subtitleArea = getLocalBounds().removeFromBottom(30).reduced(10, 5);
@@ -76,13 +82,41 @@ void TextRegion::paint(Graphics& g)
         g.setColour(BLACK);
         g.drawText(currentWord, subtitleArea, Justification::centred);
     }
+
+    _drawBackendDescription(g);
 }
 
-void TextRegion::timerCallback()
+void TextRegion::_drawBackendDescription(Graphics& g) const
 {
-    // Repaint to update current word highlighting during playback
-    auto* player = mProcessor->getPlayer();
-    if (player && player->isPlaying() && !mTimedWords.empty()) {
+    auto* text_transcription_manager = mProcessor->getTextTranscriptionManager();
+    if (text_transcription_manager == nullptr) {
+        return;
+    }
+
+    auto description = text_transcription_manager->getBackendDescription();
+    if (description.empty()) {
+        return;
+    }
+
+    g.setColour(WHITE_TRANSPARENT);
+    g.setFont(Font(FontOptions()).withPointHeight(10.0f));
+    g.drawText(description, getLocalBounds().reduced(6, 2), Justification::topRight);
+}
+
+void TextRegion::changeListenerCallback(ChangeBroadcaster* source)
+{
+    juce::ignoreUnused(source);
+
+    _updateCurrentWord();
+    mPlaybackVBlank.update();
+}
+
+void TextRegion::_updateCurrentWord()
+{
+    auto word_index = _getCurrentWordIndex();
+
+    if (word_index != mCurrentWordIndex) {
+        mCurrentWordIndex = word_index;
         repaint();
     }
 }
@@ -90,12 +124,14 @@ void TextRegion::timerCallback()
 void TextRegion::setTimedWords(const std::vector<TimedWord>& words)
 {
     mTimedWords = words;
+    mCurrentWordIndex = _getCurrentWordIndex();
     repaint();
 }
 
 void TextRegion::clear()
 {
     mTimedWords.clear();
+    mCurrentWordIndex = -1;
     repaint();
 }
 
@@ -105,28 +141,28 @@ void TextRegion::setZoomLevel(double inZoomLevel)
     repaint();
 }
 
-void TextRegion::setViewportOffset(double offsetSeconds)
+void TextRegion::setViewStartTime(double inTimeSeconds)
 {
-    mViewportOffset = offsetSeconds;
+    mViewStartTime = inTimeSeconds;
     repaint();
 }
 
-std::string TextRegion::getCurrentWord() const
+int TextRegion::_getCurrentWordIndex() const
 {
     auto* player = mProcessor->getPlayer();
     if (!player || !player->isPlaying() || mTimedWords.empty()) {
-        return "";
+        return -1;
     }
 
     double playbackTime = player->getPlayheadPositionSeconds();
 
-    for (const auto& word : mTimedWords) {
-        if (playbackTime >= word.startTime && playbackTime < word.endTime) {
-            return word.text;
+    for (size_t i = 0; i < mTimedWords.size(); i++) {
+        if (playbackTime >= mTimedWords[i].startTime && playbackTime < mTimedWords[i].endTime) {
+            return static_cast<int>(i);
         }
     }
 
-    return "";
+    return -1;
 }
 
 float TextRegion::timeToPixel(double timeInSeconds) const
@@ -135,5 +171,5 @@ float TextRegion::timeToPixel(double timeInSeconds) const
     const double basePixelsPerSecond = 100.0;
     double pixelsPerSecond = basePixelsPerSecond * mZoomLevel;
 
-    return static_cast<float>((timeInSeconds - mViewportOffset) * pixelsPerSecond);
+    return static_cast<float>((timeInSeconds - mViewStartTime) * pixelsPerSecond);
 }
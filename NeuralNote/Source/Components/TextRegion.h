@@ -3,22 +3,25 @@
 #include <JuceHeader.h>
 #include "WhisperTranscriber.h"
 #include "PluginProcessor.h"
+#include "PlaybackVBlank.h"
 #include "UIDefines.h"
 
 /**
  * UI component to display transcribed text with word-level timestamps
  * Shows text overlaid on the audio timeline, similar to subtitles
  */
-class TextRegion : public Component, public Timer
+class TextRegion : public Component, public ChangeListener
 {
 public:
     TextRegion(NeuralNoteAudioProcessor* processor);
 
+    ~TextRegion() override;
+
     void resized() override;
 
     void paint(Graphics& g) override;
 
-    void timerCallback() override;
+    void changeListenerCallback(ChangeBroadcaster* source) override;
 
     void setTimedWords(const std::vector<TimedWord>& words);
 
@@ -26,7 +29,7 @@ public:
 
     void setZoomLevel(double inZoomLevel);
 
-    void setViewportOffset(double offsetSeconds);
+    void setViewStartTime(double inTimeSeconds);
 
 private:
     NeuralNoteAudioProcessor* mProcessor;
@@ -34,11 +37,22 @@ private:
     std::vector<TimedWord> mTimedWords;
 
     double mZoomLevel = 1.0;
-    double mViewportOffset = 0.0;
+    double mViewStartTime = 0.0;
+
+    // Index of the highlighted word, -1 if none
+    int mCurrentWordIndex = -1;
+
+    PlaybackVBlank mPlaybackVBlank;
 
-    // Returns the word that should be displayed at the current playback time
-    std::string getCurrentWord() const;
+    // Repaint if the highlighted word changed
+    void _updateCurrentWord();
+
+    // Index of the word at the current playback time, -1 if not playing or between words
+    int _getCurrentWordIndex() const;
 
     // Convert time in seconds to x-position in pixels
     float timeToPixel(double timeInSeconds) const;
+
+    // Draw the Whisper backend and model in use in the top right corner
+    void _drawBackendDescription(Graphics& g) const;
 };
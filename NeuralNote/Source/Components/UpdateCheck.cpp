@@ -67,6 +67,8 @@ void UpdateCheck::timerCallback()
 
     if (current_time >= mHideTime) {
         _hideNotification();
+    } else {
+        _startHideTimer();
     }
 }
 
@@ -115,7 +117,7 @@ void UpdateCheck::_showNewVersionAvailableNotification()
     mUrlButton.setVisible(true);
     mHideTime = Time::getCurrentTime() + RelativeTime::seconds(mNotificationDurationSeconds);
 
-    startTimerHz(5);
+    _startHideTimer();
 }
 
 void UpdateCheck::_showOnLatestVersionNotification()
@@ -125,7 +127,14 @@ void UpdateCheck::_showOnLatestVersionNotification()
     mUrlButton.setVisible(false);
     mHideTime = Time::getCurrentTime() + RelativeTime::seconds(mNotificationDurationSeconds);
 
-    startTimerHz(5);
+    _startHideTimer();
+}
+
+void UpdateCheck::_startHideTimer()
+{
+    // Single shot at the hide time rather than polling: the mouse is only checked when the notification should hide
+    auto ms_until_hide = (mHideTime - Time::getCurrentTime()).inMilliseconds();
+    startTimer(static_cast<int>(jlimit<int64>(1, std::numeric_limits<int>::max(), ms_until_hide)));
 }
 
 void UpdateCheck::_hideNotification()
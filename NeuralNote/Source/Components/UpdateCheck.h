@@ -27,6 +27,11 @@ private:
 
     void _showOnLatestVersionNotification();
 
+    /**
+     * Call timerCallback at the hide time. If the mouse is over the notification then, it is kept a few more seconds.
+     */
+    void _startHideTimer();
+
     void _hideNotification();
 
     bool mUpdateAvailable {false};
@@ -11,13 +11,9 @@ VisualizationPanel::VisualizationPanel(NeuralNoteAudioProcessor* processor)
     , mCombinedAudioMidiRegion(processor, mKeyboard)
     , mMidiFileDrag(processor)
 {
-    mAudioMidiViewport.setViewedComponent(&mCombinedAudioMidiRegion);
-    addAndMakeVisible(mAudioMidiViewport);
-    mCombinedAudioMidiRegion.setViewportPtr(&mAudioMidiViewport);
-
+    addAndMakeVisible(mCombinedAudioMidiRegion);
     addAndMakeVisible(mKeyboard);
 
-    mAudioMidiViewport.setScrollBarsShown(false, true, false, false);
     addChildComponent(mMidiFileDrag);
 
     auto tempo_str_validator = [](const String& tempo_str) {
@@ -75,9 +71,6 @@ void VisualizationPanel::resized()
     mKeyboard.setBounds(
         0, mCombinedAudioMidiRegion.mPianoRollY, KEYBOARD_WIDTH, getHeight() - mCombinedAudioMidiRegion.mPianoRollY);
 
-    mAudioMidiViewport.setBounds(KEYBOARD_WIDTH, 0, getWidth() - KEYBOARD_WIDTH, getHeight());
-
-    mCombinedAudioMidiRegion.setBaseWidth(getWidth() - KEYBOARD_WIDTH);
     mCombinedAudioMidiRegion.setBounds(KEYBOARD_WIDTH, 0, getWidth() - KEYBOARD_WIDTH, getHeight());
     mCombinedAudioMidiRegion.changeListenerCallback(mProcessor->getSourceAudioManager()->getAudioThumbnail());
 
@@ -110,7 +103,8 @@ void VisualizationPanel::paint(Graphics& g)
 
 void VisualizationPanel::clear()
 {
-    mCombinedAudioMidiRegion.setSize(getWidth() - KEYBOARD_WIDTH, getHeight());
+    mCombinedAudioMidiRegion.updateTimeRange();
+    mCombinedAudioMidiRegion.setViewStartTime(0.0);
     mMidiFileDrag.setVisible(false);
     mFileTempo->setVisible(false);
     mCombinedAudioMidiRegion.clearTimedWords();
@@ -121,6 +115,11 @@ void VisualizationPanel::repaintPianoRoll()
     mCombinedAudioMidiRegion.repaintPianoRoll();
 }
 
+void VisualizationPanel::repaintPianoRoll(const Notes::EventsDiff& inNoteEventsDiff)
+{
+    mCombinedAudioMidiRegion.repaintPianoRoll(inNoteEventsDiff);
+}
+
 void VisualizationPanel::setTimedWords(const std::vector<TimedWord>& words)
 {
     mCombinedAudioMidiRegion.setTimedWords(words);
@@ -165,11 +164,6 @@ void VisualizationPanel::mouseExit(const MouseEvent& event)
     }
 }
 
-Viewport& VisualizationPanel::getAudioMidiViewport()
-{
-    return mAudioMidiViewport;
-}
-
 CombinedAudioMidiRegion& VisualizationPanel::getCombinedAudioMidiRegion()
 {
     return mCombinedAudioMidiRegion;
@@ -29,6 +29,8 @@ public:
 
     void repaintPianoRoll();
 
+    void repaintPianoRoll(const Notes::EventsDiff& inNoteEventsDiff);
+
     void setMidiFileDragComponentVisible();
 
     void setTimedWords(const std::vector<TimedWord>& words);
@@ -39,8 +41,6 @@ public:
 
     void mouseExit(const MouseEvent& event) override;
 
-    Viewport& getAudioMidiViewport();
-
     CombinedAudioMidiRegion& getCombinedAudioMidiRegion();
 
     static constexpr int KEYBOARD_WIDTH = 50;
@@ -48,7 +48,6 @@ public:
 private:
     NeuralNoteAudioProcessor* mProcessor;
     Keyboard mKeyboard;
-    Viewport mAudioMidiViewport;
     CombinedAudioMidiRegion mCombinedAudioMidiRegion;
     MidiFileDrag mMidiFileDrag;
 
@@ -3,40 +3,88 @@
 //
 
 #include "MidiFileWriter.h"
+#include "AsyncLogger.h"
 
 bool MidiFileWriter::writeMidiFile(const std::vector<Notes::Event>& inNoteEvents,
                                    const File& fileToUse,
                                    const TimeQuantizeOptions::TimeQuantizeInfo& inInfo,
                                    double inExportBpm,
                                    PitchBendModes inPitchBendMode) const
+{
+    return writeMidiFile(
+        std::vector<std::vector<Notes::Event>> {inNoteEvents}, fileToUse, inInfo, inExportBpm, inPitchBendMode);
+}
+
+bool MidiFileWriter::writeMidiFile(const std::vector<std::vector<Notes::Event>>& inNoteEventsPerTrack,
+                                   const File& fileToUse,
+                                   const TimeQuantizeOptions::TimeQuantizeInfo& inInfo,
+                                   double inExportBpm,
+                                   PitchBendModes inPitchBendMode) const
 {
     // Compute offset to start at beginning of the previous bar
     const double start_offset = - inInfo.getStartLastBarSec();
     jassert(start_offset >= 0.0);
 
-    MidiMessageSequence message_sequence;
+    MidiFile midi_file;
+
+    midi_file.setTicksPerQuarterNote(mTicksPerQuarterNote);
 
-    // Set tempo
-    auto tempo_meta_event =
-        MidiMessage::tempoMetaEvent(static_cast<int>(std::round(_BPMToMicrosecondsPerQuarterNote(inExportBpm))));
-    tempo_meta_event.setTimeStamp(0.0);
-    message_sequence.addEvent(tempo_meta_event);
+    for (size_t track_idx = 0; track_idx < inNoteEventsPerTrack.size(); track_idx++) {
+        auto message_sequence = _createTrack(inNoteEventsPerTrack[track_idx],
+                                             start_offset,
+                                             inExportBpm,
+                                             inPitchBendMode,
+                                             static_cast<int>(std::min<size_t>(track_idx, 15)) + 1);
+
+        if (track_idx == 0) {
+            // Set tempo
+            auto tempo_meta_event = MidiMessage::tempoMetaEvent(
+                static_cast<int>(std::round(_BPMToMicrosecondsPerQuarterNote(inExportBpm))));
+            tempo_meta_event.setTimeStamp(0.0);
+            message_sequence.addEvent(tempo_meta_event);
+
+            // Set time signature
+            auto time_signature_meta_event =
+                MidiMessage::timeSignatureMetaEvent(inInfo.timeSignatureNum, inInfo.timeSignatureDenom);
+            time_signature_meta_event.setTimeStamp(0.0);
+            message_sequence.addEvent(time_signature_meta_event);
+
+            message_sequence.sort();
+            message_sequence.updateMatchedPairs();
+        }
+
+        midi_file.addTrack(message_sequence);
+    }
 
-    // Set time signature
-    auto time_signature_meta_event =
-        MidiMessage::timeSignatureMetaEvent(inInfo.timeSignatureNum, inInfo.timeSignatureDenom);
-    time_signature_meta_event.setTimeStamp(0.0);
-    message_sequence.addEvent(time_signature_meta_event);
+    FileOutputStream output_stream(fileToUse);
+
+    if (!output_stream.openedOk())
+        return false;
+
+    output_stream.setPosition(0);
+
+    bool success = midi_file.writeTo(output_stream);
+
+    return success;
+}
+
+MidiMessageSequence MidiFileWriter::_createTrack(const std::vector<Notes::Event>& inNoteEvents,
+                                                 double inStartOffset,
+                                                 double inExportBpm,
+                                                 PitchBendModes inPitchBendMode,
+                                                 int inMidiChannel) const
+{
+    MidiMessageSequence message_sequence;
 
     float prev_pitch_bend_semitone = 0.0f;
 
     // Add note events
     for (auto& note: inNoteEvents) {
-        auto note_on = MidiMessage::noteOn(1, note.pitch, static_cast<float>(note.amplitude));
-        note_on.setTimeStamp((note.startTime + start_offset) * inExportBpm / 60.0 * mTicksPerQuarterNote);
+        auto note_on = MidiMessage::noteOn(inMidiChannel, note.pitch, static_cast<float>(note.amplitude));
+        note_on.setTimeStamp((note.startTime + inStartOffset) * inExportBpm / 60.0 * mTicksPerQuarterNote);
 
-        auto note_off = MidiMessage::noteOff(1, note.pitch);
-        note_off.setTimeStamp((note.endTime + start_offset) * inExportBpm / 60.0 * mTicksPerQuarterNote);
+        auto note_off = MidiMessage::noteOff(inMidiChannel, note.pitch);
+        note_off.setTimeStamp((note.endTime + inStartOffset) * inExportBpm / 60.0 * mTicksPerQuarterNote);
 
         message_sequence.addEvent(note_on);
 
@@ -45,8 +93,8 @@ bool MidiFileWriter::writeMidiFile(const std::vector<Notes::Event>& inNoteEvents
             for (size_t i = 0; i < note.bends.size(); i++) {
                 prev_pitch_bend_semitone = static_cast<float>(note.bends[i]) / 3.0f;
                 auto pitch_wheel_pos = MidiMessage::pitchbendToPitchwheelPos(prev_pitch_bend_semitone, 4.0f);
-                auto pitch_wheel_event = MidiMessage::pitchWheel(1, pitch_wheel_pos);
-                pitch_wheel_event.setTimeStamp((note.startTime + start_offset + i * FFT_HOP / BASIC_PITCH_SAMPLE_RATE)
+                auto pitch_wheel_event = MidiMessage::pitchWheel(inMidiChannel, pitch_wheel_pos);
+                pitch_wheel_event.setTimeStamp((note.startTime + inStartOffset + i * FFT_HOP / BASIC_PITCH_SAMPLE_RATE)
                                                * inExportBpm / 60.0 * mTicksPerQuarterNote);
                 message_sequence.addEvent(pitch_wheel_event);
             }
@@ -54,8 +102,8 @@ bool MidiFileWriter::writeMidiFile(const std::vector<Notes::Event>& inNoteEvents
             if (note.bends.empty() && prev_pitch_bend_semitone != 0) {
                 prev_pitch_bend_semitone = 0.0f;
                 auto pitch_wheel_pos = MidiMessage::pitchbendToPitchwheelPos(0.0f, 4.0f);
-                auto pitch_wheel_event = MidiMessage::pitchWheel(1, pitch_wheel_pos);
-                pitch_wheel_event.setTimeStamp((note.startTime + start_offset) * inExportBpm / 60.0
+                auto pitch_wheel_event = MidiMessage::pitchWheel(inMidiChannel, pitch_wheel_pos);
+                pitch_wheel_event.setTimeStamp((note.startTime + inStartOffset) * inExportBpm / 60.0
                                                * mTicksPerQuarterNote);
                 message_sequence.addEvent(pitch_wheel_event);
             }
@@ -68,26 +116,12 @@ bool MidiFileWriter::writeMidiFile(const std::vector<Notes::Event>& inNoteEvents
     message_sequence.sort();
     message_sequence.updateMatchedPairs();
 
-    DBG("Length of note vector: " << inNoteEvents.size());
-    DBG("NumEvents in message sequence:" << message_sequence.getNumEvents());
-
-    // Write midi file
-    MidiFile midi_file;
-
-    midi_file.setTicksPerQuarterNote(mTicksPerQuarterNote);
-
-    midi_file.addTrack(message_sequence);
+    NN_LOG_DEBUG(Transcription,
+                 "Length of note vector: {}, num events in message sequence: {}",
+                 inNoteEvents.size(),
+                 message_sequence.getNumEvents());
 
-    FileOutputStream output_stream(fileToUse);
-
-    if (!output_stream.openedOk())
-        return false;
-
-    output_stream.setPosition(0);
-
-    bool success = midi_file.writeTo(output_stream);
-
-    return success;
+    return message_sequence;
 }
 
 double MidiFileWriter::_BPMToMicrosecondsPerQuarterNote(double inTempoBPM)
@@ -20,7 +20,23 @@ public:
                        double inExportBpm,
                        PitchBendModes inPitchBendMode) const;
 
+    /**
+     * Write a multi-track MIDI file, one track per note event vector (e.g. one per transcribed audio channel).
+     * Track i uses MIDI channel i + 1 (up to 16). Tempo and time signature are written on the first track.
+     */
+    bool writeMidiFile(const std::vector<std::vector<Notes::Event>>& inNoteEventsPerTrack,
+                       const File& fileToUse,
+                       const TimeQuantizeOptions::TimeQuantizeInfo& inInfo,
+                       double inExportBpm,
+                       PitchBendModes inPitchBendMode) const;
+
 private:
+    MidiMessageSequence _createTrack(const std::vector<Notes::Event>& inNoteEvents,
+                                     double inStartOffset,
+                                     double inExportBpm,
+                                     PitchBendModes inPitchBendMode,
+                                     int inMidiChannel) const;
+
     static double _BPMToMicrosecondsPerQuarterNote(double inTempoBPM);
 
     const int mTicksPerQuarterNote = 960;
@@ -65,6 +65,10 @@ const String mute = "Mute / Unmute input | m";
 
 const String export_tempo = "Set export tempo for midi file";
 
+const String batch_item_selector = "Select the dropped file to show\n"
+                                   "Files are transcribed in the background and can be exported at once from the "
+                                   "settings menu";
+
 const String source_audio_level = "Set source audio level";
 
 const String internal_synth_level = "Set internal synth level";
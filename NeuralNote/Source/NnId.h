@@ -35,6 +35,8 @@ inline static Identifier ZoomLevelId = "ZOOM_LEVEL";
 
 inline static Identifier TooltipVisibleId = "TOOLTIP_VISIBLE";
 
+inline static Identifier TranscribePerChannelId = "TRANSCRIBE_PER_CHANNEL";
+
 // --------------- Time quantization ----------------
 inline static Identifier TempoId = "TEMPO";
 
@@ -62,7 +64,8 @@ const std::vector<std::pair<Identifier, var>> OrderedStatePropertiesWithDefault
     {PlayheadCenteredId, true},
     {ZoomLevelId, 1.0},
     {MidiOut, false},
-    {TooltipVisibleId, true}};
+    {TooltipVisibleId, true},
+    {TranscribePerChannelId, false}};
 
 } // namespace NnId
 
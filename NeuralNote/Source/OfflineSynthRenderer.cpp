@@ -0,0 +1,137 @@
+#include "OfflineSynthRenderer.h"
+#include "Player.h"
+#include "SynthController.h"
+
+OfflineSynthRenderer::OfflineSynthRenderer()
+    : mThreadPool(1)
+{
+}
+
+OfflineSynthRenderer::~OfflineSynthRenderer()
+{
+    cancel();
+}
+
+bool OfflineSynthRenderer::render(const std::vector<Notes::Event>& inNoteEvents,
+                                  double inDurationSeconds,
+                                  double inSampleRate,
+                                  AudioBuffer<float>& outBuffer,
+                                  const std::atomic<bool>& inShouldStop)
+{
+    jassert(inSampleRate > 0);
+
+    // Same events and voices as the player
+    auto events = SynthController::buildMidiEventsVector(inNoteEvents);
+
+    double end_time = inDurationSeconds;
+
+    if (!events.empty()) {
+        end_time = std::max(end_time, events.back().getTimeStamp() + TAIL_SECONDS);
+    }
+
+    const auto num_samples = static_cast<int>(std::ceil(end_time * inSampleRate));
+
+    outBuffer.setSize(1, num_samples);
+    outBuffer.clear();
+
+    MPESynthesiser synth;
+    synth.setCurrentPlaybackSampleRate(inSampleRate);
+
+    for (int i = 0; i < Player::NUM_VOICES_SYNTH; i++) {
+        synth.addVoice(new SynthVoice());
+    }
+
+    MidiBuffer midi_buffer;
+    size_t event_index = 0;
+
+    for (int block_start = 0; block_start < num_samples; block_start += BLOCK_SIZE) {
+        if (inShouldStop) {
+            return false;
+        }
+
+        const int block_size = std::min(BLOCK_SIZE, num_samples - block_start);
+        const int block_end = block_start + block_size;
+
+        midi_buffer.clear();
+
+        // Sample accurate event positions (in buffer coordinates): the synthesiser splits the block at each event
+        while (event_index < events.size()) {
+            auto sample_position = static_cast<int>(std::round(events[event_index].getTimeStamp() * inSampleRate));
+
+            if (sample_position >= block_end) {
+                break;
+            }
+
+            midi_buffer.addEvent(events[event_index], std::max(sample_position, block_start));
+            event_index++;
+        }
+
+        synth.renderNextBlock(outBuffer, midi_buffer, block_start, block_size);
+    }
+
+    return true;
+}
+
+bool OfflineSynthRenderer::writeWavFile(const AudioBuffer<float>& inBuffer, double inSampleRate, const File& inFile)
+{
+    inFile.deleteFile();
+
+    auto output_stream = inFile.createOutputStream();
+
+    if (output_stream == nullptr) {
+        return false;
+    }
+
+    WavAudioFormat format;
+    std::unique_ptr<AudioFormatWriter> writer(format.createWriterFor(
+        output_stream.get(), inSampleRate, static_cast<unsigned int>(inBuffer.getNumChannels()), 24, {}, 0));
+
+    if (writer == nullptr) {
+        return false;
+    }
+
+    // The writer now owns the stream
+    output_stream.release();
+
+    return writer->writeFromAudioSampleBuffer(inBuffer, 0, inBuffer.getNumSamples());
+}
+
+void OfflineSynthRenderer::launchRenderToFile(const std::vector<Notes::Event>& inNoteEvents,
+                                              double inDurationSeconds,
+                                              double inSampleRate,
+                                              const File& inFile,
+                                              std::function<void(bool)> inOnFinished)
+{
+    cancel();
+    mShouldStop = false;
+
+    mThreadPool.addJob([this,
+                        note_events = inNoteEvents,
+                        inDurationSeconds,
+                        inSampleRate,
+                        inFile,
+                        on_finished = std::move(inOnFinished)] {
+        AudioBuffer<float> rendered_audio;
+
+        if (!render(note_events, inDurationSeconds, inSampleRate, rendered_audio, mShouldStop)) {
+            return;
+        }
+
+        bool success = writeWavFile(rendered_audio, inSampleRate, inFile);
+
+        if (on_finished) {
+            MessageManager::callAsync([on_finished, success] { on_finished(success); });
+        }
+    });
+}
+
+bool OfflineSynthRenderer::isRendering() const
+{
+    return mThreadPool.getNumJobs() > 0;
+}
+
+void OfflineSynthRenderer::cancel()
+{
+    mShouldStop = true;
+    mThreadPool.removeAllJobs(true, 5000);
+}
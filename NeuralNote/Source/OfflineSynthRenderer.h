@@ -0,0 +1,69 @@
+#ifndef OfflineSynthRenderer_h
+#define OfflineSynthRenderer_h
+
+#include <JuceHeader.h>
+
+#include "Notes.h"
+
+/**
+ * Renders note events to audio with the same synth as the player, faster than real time. Unlike the player, the
+ * rendering does not go through the audio callback: it owns its synthesiser, places the MIDI events with sample
+ * accuracy and renders large blocks without taking the callback lock.
+ */
+class OfflineSynthRenderer
+{
+public:
+    OfflineSynthRenderer();
+
+    ~OfflineSynthRenderer();
+
+    /**
+     * Render note events to a mono buffer.
+     * @param inNoteEvents Note events to render
+     * @param inDurationSeconds Duration to render. The buffer is extended if needed so the last release is not cut.
+     * @param inSampleRate Sample rate of the rendered audio
+     * @param outBuffer Buffer where the audio is written. Resized to one channel and the rendered number of samples.
+     * @param inShouldStop Checked between blocks to cancel the rendering
+     * @return False if the rendering was cancelled
+     */
+    static bool render(const std::vector<Notes::Event>& inNoteEvents,
+                       double inDurationSeconds,
+                       double inSampleRate,
+                       AudioBuffer<float>& outBuffer,
+                       const std::atomic<bool>& inShouldStop);
+
+    /**
+     * Write a buffer to a 24 bit wav file.
+     * @return Whether the file was written
+     */
+    static bool writeWavFile(const AudioBuffer<float>& inBuffer, double inSampleRate, const File& inFile);
+
+    /**
+     * Render note events to a wav file on a background thread. A render already running is cancelled.
+     * @param inNoteEvents Note events to render (copied)
+     * @param inDurationSeconds Duration to render
+     * @param inSampleRate Sample rate of the wav file
+     * @param inFile Output wav file
+     * @param inOnFinished Called on the message thread with whether the file was written. Not called if cancelled.
+     */
+    void launchRenderToFile(const std::vector<Notes::Event>& inNoteEvents,
+                            double inDurationSeconds,
+                            double inSampleRate,
+                            const File& inFile,
+                            std::function<void(bool)> inOnFinished);
+
+    bool isRendering() const;
+
+    void cancel();
+
+    static constexpr int BLOCK_SIZE = 8192;
+
+    // Release time of the synth voices, rendered after the last note off
+    static constexpr double TAIL_SECONDS = 0.2;
+
+private:
+    std::atomic<bool> mShouldStop = false;
+    ThreadPool mThreadPool;
+};
+
+#endif // OfflineSynthRenderer_h
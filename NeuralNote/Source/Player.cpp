@@ -143,6 +143,12 @@ void Player::setPlayingState(bool inIsPlaying)
     if (!inIsPlaying) {
         mSynth->turnOffAllVoices(true);
     }
+
+    // Playback stops on the audio thread at the end of the audio, which must not post messages. The components
+    // refreshed at the display rate while playing notice it on their next vertical blank.
+    if (MessageManager::existsAndIsCurrentThread()) {
+        mProcessor->sendStateChangeMessage();
+    }
 }
 
 void Player::reset()
@@ -150,6 +156,7 @@ void Player::reset()
     mSynthController->reset();
     setPlayingState(false);
     mPlayheadTime = 0;
+    mProcessor->sendStateChangeMessage();
 }
 
 double Player::getPlayheadPositionSeconds() const
@@ -162,6 +169,7 @@ void Player::setPlayheadPositionSeconds(double inNewPosition)
     if (inNewPosition >= 0 && inNewPosition < mProcessor->getSourceAudioManager()->getAudioSampleDuration()) {
         mSynthController->setNewTimeSeconds(inNewPosition);
         mPlayheadTime = inNewPosition;
+        mProcessor->sendStateChangeMessage();
     }
 }
 
@@ -170,6 +178,11 @@ SynthController* Player::getSynthController() const
     return mSynthController.get();
 }
 
+OfflineSynthRenderer* Player::getOfflineSynthRenderer()
+{
+    return &mOfflineSynthRenderer;
+}
+
 void Player::saveStateToValueTree()
 {
     mProcessor->getValueTree().setPropertyExcludingListener(this, NnId::PlayheadPositionSecId, mPlayheadTime, nullptr);
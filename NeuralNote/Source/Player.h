@@ -7,6 +7,7 @@
 
 #include <JuceHeader.h>
 
+#include "OfflineSynthRenderer.h"
 #include "SynthController.h"
 #include "SynthVoice.h"
 
@@ -40,6 +41,11 @@ public:
 
     SynthController* getSynthController() const;
 
+    /**
+     * @return Renderer to bounce note events to audio faster than real time, outside of the audio callback.
+     */
+    OfflineSynthRenderer* getOfflineSynthRenderer();
+
     void saveStateToValueTree();
 
     static constexpr int NUM_VOICES_SYNTH = 16;
@@ -58,6 +64,8 @@ private:
     std::unique_ptr<SynthController> mSynthController;
     std::unique_ptr<MPESynthesiser> mSynth;
 
+    OfflineSynthRenderer mOfflineSynthRenderer;
+
     AudioBuffer<float> mInternalBuffer;
 
     double mPlayheadTime = 0;
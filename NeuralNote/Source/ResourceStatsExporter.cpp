@@ -0,0 +1,25 @@
+#include "ResourceStatsExporter.h"
+#include "AsyncLogger.h"
+#include "ResourceStats.h"
+
+ResourceStatsExporter::ResourceStatsExporter()
+{
+    if (const char* file_path = std::getenv("NEURALNOTE_STATS_FILE")) {
+        mFilePath = file_path;
+        startTimer(EXPORT_INTERVAL_MS);
+    }
+}
+
+ResourceStatsExporter::~ResourceStatsExporter()
+{
+    stopTimer();
+}
+
+void ResourceStatsExporter::timerCallback()
+{
+    std::string error;
+
+    if (!ResourceStats::Registry::getInstance().writeJsonFile(mFilePath, error)) {
+        NN_LOG_WARNING(UI, "Could not export the resource statistics: {}", error);
+    }
+}
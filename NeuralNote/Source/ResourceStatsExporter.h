@@ -0,0 +1,26 @@
+#ifndef ResourceStatsExporter_h
+#define ResourceStatsExporter_h
+
+#include <JuceHeader.h>
+
+/**
+ * Periodically writes the statistics of all the NeuralNote instances of the process to the JSON file given by the
+ * NEURALNOTE_STATS_FILE environment variable, so that an external monitor can read them. Does nothing if the variable
+ * is not set. Shared by the instances through a SharedResourcePointer, so the file is written once per interval.
+ */
+class ResourceStatsExporter : private Timer
+{
+public:
+    ResourceStatsExporter();
+
+    ~ResourceStatsExporter() override;
+
+    static constexpr int EXPORT_INTERVAL_MS = 2000;
+
+private:
+    void timerCallback() override;
+
+    std::string mFilePath;
+};
+
+#endif // ResourceStatsExporter_h
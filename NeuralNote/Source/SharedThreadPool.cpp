@@ -0,0 +1,108 @@
+#include "SharedThreadPool.h"
+
+class SharedThreadPool::OwnedJob : public ThreadPoolJob
+{
+public:
+    OwnedJob(SharedThreadPool& inPool, const void* inOwner, std::function<void()> inJob)
+        : ThreadPoolJob("NeuralNote shared job")
+        , mPool(inPool)
+        , mOwner(inOwner)
+        , mJob(std::move(inJob))
+    {
+    }
+
+    // Deleted by the thread pool once run or removed
+    ~OwnedJob() override
+    {
+        const ScopedLock sl(mPool.mLock);
+
+        if (--mPool.mNumJobsPerOwner[mOwner] == 0) {
+            mPool.mNumJobsPerOwner.erase(mOwner);
+        }
+    }
+
+    JobStatus runJob() override
+    {
+        mJob();
+        return jobHasFinished;
+    }
+
+    const void* getOwner() const { return mOwner; }
+
+private:
+    SharedThreadPool& mPool;
+    const void* mOwner;
+    std::function<void()> mJob;
+};
+
+SharedThreadPool::~SharedThreadPool()
+{
+    // Owners remove their jobs before being destroyed
+    jassert(mNumJobsPerOwner.empty());
+
+    // Destroyed here rather than with the members, as the jobs it deletes update the job counts
+    mThreadPool.reset();
+}
+
+int SharedThreadPool::getNumThreads()
+{
+    return jlimit(1, 8, SystemStats::getNumPhysicalCpus() - 1);
+}
+
+void SharedThreadPool::addJob(const void* inOwner, std::function<void()> inJob)
+{
+    ThreadPool* thread_pool = nullptr;
+
+    {
+        const ScopedLock sl(mLock);
+
+        if (mThreadPool == nullptr) {
+            mThreadPool = std::make_unique<ThreadPool>(
+                ThreadPoolOptions().withThreadName("NeuralNote shared pool").withNumberOfThreads(getNumThreads()));
+        }
+
+        mNumJobsPerOwner[inOwner]++;
+        thread_pool = mThreadPool.get();
+    }
+
+    thread_pool->addJob(new OwnedJob(*this, inOwner, std::move(inJob)), true);
+}
+
+bool SharedThreadPool::removeJobs(const void* inOwner, int inTimeOutMs)
+{
+    struct OwnerSelector : ThreadPool::JobSelector {
+        explicit OwnerSelector(const void* inSelectedOwner)
+            : owner(inSelectedOwner)
+        {
+        }
+
+        bool isJobSuitable(ThreadPoolJob* inJob) override
+        {
+            return static_cast<OwnedJob*>(inJob)->getOwner() == owner;
+        }
+
+        const void* owner;
+    };
+
+    ThreadPool* thread_pool = nullptr;
+
+    {
+        const ScopedLock sl(mLock);
+        thread_pool = mThreadPool.get();
+    }
+
+    if (thread_pool == nullptr) {
+        return true;
+    }
+
+    OwnerSelector selector(inOwner);
+    return thread_pool->removeAllJobs(false, inTimeOutMs, &selector);
+}
+
+int SharedThreadPool::getNumJobs(const void* inOwner) const
+{
+    const ScopedLock sl(mLock);
+
+    auto it = mNumJobsPerOwner.find(inOwner);
+    return it != mNumJobsPerOwner.end() ? it->second : 0;
+}
@@ -0,0 +1,57 @@
+#ifndef SharedThreadPool_h
+#define SharedThreadPool_h
+
+#include <JuceHeader.h>
+
+/**
+ * Thread pool shared by all the NeuralNote instances of the process for the jobs running in parallel (batch
+ * transcription, channels transcribed separately), so that the instances together never use more threads than the
+ * budget. Hold it with a SharedResourcePointer. The threads are only started by the first job added.
+ * Jobs are added for an owner, so that an instance only removes and waits for its own jobs.
+ */
+class SharedThreadPool
+{
+public:
+    SharedThreadPool() = default;
+
+    ~SharedThreadPool();
+
+    /**
+     * @return Number of threads of the pool: one per physical core, except one left for the audio thread and the UI.
+     */
+    static int getNumThreads();
+
+    /**
+     * Add a job, run on the next free thread.
+     * @param inOwner Owner of the job, e.g. the object whose members the job uses
+     * @param inJob Job to run
+     */
+    void addJob(const void* inOwner, std::function<void()> inJob);
+
+    /**
+     * Remove the queued jobs of an owner and wait for its running ones. Running jobs are not interrupted: they should
+     * check a stop flag of their owner to return early.
+     * @param inOwner Owner of the jobs
+     * @param inTimeOutMs Maximum time to wait, -1 to wait as long as needed
+     * @return False if the timeout expired before the running jobs finished
+     */
+    bool removeJobs(const void* inOwner, int inTimeOutMs = -1);
+
+    /**
+     * @return Number of jobs of an owner queued or running.
+     */
+    int getNumJobs(const void* inOwner) const;
+
+private:
+    class OwnedJob;
+
+    CriticalSection mLock;
+    std::map<const void*, int> mNumJobsPerOwner;
+
+    // Created by the first job added
+    std::unique_ptr<ThreadPool> mThreadPool;
+
+    JUCE_DECLARE_NON_COPYABLE(SharedThreadPool)
+};
+
+#endif // SharedThreadPool_h
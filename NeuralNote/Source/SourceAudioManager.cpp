@@ -6,6 +6,7 @@
 
 #include "SourceAudioManager.h"
 #include "PluginProcessor.h"
+#include "AsyncLogger.h"
 
 SourceAudioManager::SourceAudioManager(NeuralNoteAudioProcessor* inProcessor)
     : mProcessor(inProcessor)
@@ -13,6 +14,12 @@ SourceAudioManager::SourceAudioManager(NeuralNoteAudioProcessor* inProcessor)
     , mThumbnail(mSourceSamplesPerThumbnailSample, mThumbnailFormatManager, mThumbnailCache)
 {
     mProcessor->addListenerToStateValueTree(this);
+
+    mDerivedAudio.setComputeFunction(DerivedAudioBuffers::Type::Transcription,
+                                     [this]() { return _computeDownsampledSourceAudio(); });
+    mDerivedAudio.setComputeFunction(DerivedAudioBuffers::Type::Whisper,
+                                     [this]() { return _computeAudioResampled16k(); });
+
     jassert(mProcessor->getValueTree().hasProperty(NnId::SourceAudioNativeSrPathId));
 }
 
@@ -35,11 +42,18 @@ void SourceAudioManager::prepareToPlay(double inSampleRate, int inSamplesPerBloc
 
     auto state = mProcessor->getState();
     if ((state == PopulatedAudioAndMidiRegions || state == Processing) && mSampleRate != mSourceAudioSampleRate) {
-        AudioBuffer<float> tmp_buffer;
-        AudioUtils::resampleBuffer(mSourceAudio, tmp_buffer, mSourceAudioSampleRate, mSampleRate);
-        mSourceAudio = std::move(tmp_buffer);
-        mSourceAudioSampleRate = mSampleRate;
+        // Other instances running at the same sample rate may have resampled it already
+        auto playback_audio = SourceAudioCache::getInstance().getOrCompute<AudioBuffer<float>>(
+            mSourceFileKey, SourceAudioCache::Representation::Playback, mSampleRate, [this]() {
+                auto buffer = std::make_shared<AudioBuffer<float>>();
+                AudioUtils::resampleBuffer(*mSourceAudio, *buffer, mSourceAudioSampleRate, mSampleRate);
+                return buffer;
+            });
+
+        _setSourceAudio(std::move(playback_audio), mSampleRate, mSourceFileKey);
     }
+
+    _updateResourceStats();
 }
 
 void SourceAudioManager::processBlock(const AudioBuffer<float>& inBuffer)
@@ -51,7 +65,7 @@ void SourceAudioManager::processBlock(const AudioBuffer<float>& inBuffer)
         bool result = mThreadedWriter->write(inBuffer.getArrayOfReadPointers(), inBuffer.getNumSamples());
         if (!result) {
             // Recording write failed - stop recording to prevent data loss
-            DBG("WARNING: Failed to write audio samples at native rate. Stopping recording.");
+            NN_LOG_WARNING(Recording, "Failed to write audio samples at native rate. Stopping recording.");
             // Note: We continue processing this block but will stop recording after
             mIsRecording.store(false);
         }
@@ -78,7 +92,7 @@ void SourceAudioManager::processBlock(const AudioBuffer<float>& inBuffer)
             mThreadedWriterDown->write(mInternalDownsampledBuffer.getArrayOfReadPointers(), num_samples_down);
         if (!result_down) {
             // Downsampled write failed - stop recording to prevent data loss
-            DBG("WARNING: Failed to write downsampled audio samples. Stopping recording.");
+            NN_LOG_WARNING(Recording, "Failed to write downsampled audio samples. Stopping recording.");
             mIsRecording.store(false);
         }
 
@@ -182,8 +196,10 @@ void SourceAudioManager::stopRecording()
     mWriterThread.stopThread(1000);
     mWriterThreadDown.stopThread(1000);
 
-    bool success = AudioUtils::loadAudioFile(mSourceFile, mSourceAudio, mSourceAudioSampleRate);
-    jassert(mSourceAudioSampleRate == mSampleRate);
+    AudioBuffer<float> recorded_audio;
+    double recorded_sample_rate;
+    bool success = AudioUtils::loadAudioFile(mSourceFile, recorded_audio, recorded_sample_rate);
+    jassert(recorded_sample_rate == mSampleRate);
 
     // Should def not happen
     if (!success) {
@@ -193,19 +209,31 @@ void SourceAudioManager::stopRecording()
         return;
     }
 
-    double dummy_sr;
-    success = AudioUtils::loadAudioFile(mRecordedFileDown, mDownsampledSourceAudio, dummy_sr);
-    jassert(dummy_sr == BASIC_PITCH_SAMPLE_RATE);
+    _setSourceAudio(std::make_shared<AudioBuffer<float>>(std::move(recorded_audio)), recorded_sample_rate, {});
+    mDerivedAudio.clear();
 
-    // Should def not happen
-    if (!success) {
-        mProcessor->clear();
-        NativeMessageBox::showMessageBoxAsync(
-            MessageBoxIconType::NoIcon, "Could not load the recorded audio sample.", "");
-        return;
+    // When keeping the input channels separate for the transcription, the downsampled audio is computed from the
+    // source audio by the transcription. Otherwise the downsampled file recorded is the mono downmix to transcribe.
+    if (!static_cast<bool>(mProcessor->getValueTree().getProperty(NnId::TranscribePerChannelId, false))
+        || mSourceAudio->getNumChannels() == 1) {
+        AudioBuffer<float> recorded_audio_down;
+        double dummy_sr;
+        success = AudioUtils::loadAudioFile(mRecordedFileDown, recorded_audio_down, dummy_sr);
+        jassert(dummy_sr == BASIC_PITCH_SAMPLE_RATE);
+
+        // Should def not happen
+        if (!success) {
+            mProcessor->clear();
+            NativeMessageBox::showMessageBoxAsync(
+                MessageBoxIconType::NoIcon, "Could not load the recorded audio sample.", "");
+            return;
+        }
+
+        mDerivedAudio.setBuffer(DerivedAudioBuffers::Type::Transcription,
+                                std::make_shared<AudioBuffer<float>>(std::move(recorded_audio_down)));
     }
 
-    _updateWhisperAudioBuffer();
+    _updateResourceStats();
 
     auto& tree = mProcessor->getValueTree();
     tree.setPropertyExcludingListener(this, NnId::SourceAudioNativeSrPathId, mSourceFile.getFullPathName(), nullptr);
@@ -214,13 +242,68 @@ void SourceAudioManager::stopRecording()
     mProcessor->getTextTranscriptionManager()->setLaunchNewTranscription();
 }
 
-bool SourceAudioManager::onFileDrop(const File& inFile)
+bool SourceAudioManager::onFileDrop(const File& inFile,
+                                    std::shared_ptr<const BasicPitch::Posteriorgrams> inCachedPosteriorgrams)
 {
     if (mProcessor->getState() == EmptyAudioAndMidiRegions || mProcessor->getState() == PopulatedAudioAndMidiRegions) {
         mProcessor->clear();
-        bool success = AudioUtils::loadAudioFile(inFile, mSourceAudio, mSourceAudioSampleRate);
 
-        if (!success) {
+        AudioBuffer<float> file_audio;
+        double file_sample_rate = 0.0;
+        bool is_file_loaded = false;
+
+        // Decode the file only if another instance does not hold what is computed from it already
+        auto load_file = [&]() {
+            if (!is_file_loaded) {
+                is_file_loaded = AudioUtils::loadAudioFile(inFile, file_audio, file_sample_rate);
+            }
+
+            return is_file_loaded;
+        };
+
+        auto& cache = SourceAudioCache::getInstance();
+        const auto file_key = SourceAudioCache::FileKey::fromPath(inFile.getFullPathName().toStdString());
+
+        // Downsample to basic pitch sample rate from the file sample rate. The thumbnail needs it right away, so it is
+        // not left to compute on request from the playback buffer.
+        auto downsampled_audio = cache.getOrCompute<AudioBuffer<float>>(
+            file_key,
+            SourceAudioCache::Representation::Transcription,
+            BASIC_PITCH_SAMPLE_RATE,
+            [&]() -> DerivedAudioBuffers::Buffer {
+                if (!load_file()) {
+                    return nullptr;
+                }
+
+                auto buffer = std::make_shared<AudioBuffer<float>>();
+                AudioUtils::resampleBuffer(file_audio, *buffer, file_sample_rate, BASIC_PITCH_SAMPLE_RATE);
+                return buffer;
+            });
+
+        // Resample to current plugin sample rate for playback
+        std::shared_ptr<AudioBuffer<float>> playback_audio;
+
+        if (downsampled_audio != nullptr) {
+            playback_audio = cache.getOrCompute<AudioBuffer<float>>(
+                file_key,
+                SourceAudioCache::Representation::Playback,
+                mSampleRate,
+                [&]() -> DerivedAudioBuffers::Buffer {
+                    if (!load_file()) {
+                        return nullptr;
+                    }
+
+                    if (file_sample_rate == mSampleRate) {
+                        return std::make_shared<AudioBuffer<float>>(std::move(file_audio));
+                    }
+
+                    auto buffer = std::make_shared<AudioBuffer<float>>();
+                    AudioUtils::resampleBuffer(file_audio, *buffer, file_sample_rate, mSampleRate);
+                    return buffer;
+                });
+        }
+
+        if (downsampled_audio == nullptr || playback_audio == nullptr) {
             mProcessor->clear();
             NativeMessageBox::showMessageBoxAsync(
                 MessageBoxIconType::NoIcon,
@@ -229,24 +312,14 @@ bool SourceAudioManager::onFileDrop(const File& inFile)
             return false;
         }
 
-        // Downsample to basic pitch sample rate
-        AudioUtils::resampleBuffer(
-            mSourceAudio, mDownsampledSourceAudio, mSourceAudioSampleRate, BASIC_PITCH_SAMPLE_RATE);
+        mNumSamplesAcquiredDown = downsampled_audio->getNumSamples();
+        mDerivedAudio.setBuffer(DerivedAudioBuffers::Type::Transcription, std::move(downsampled_audio));
 
-        // Resample to current plugin sample rate for playback
-        if (mSourceAudioSampleRate != mSampleRate) {
-            AudioBuffer<float> tmp_buffer;
-            AudioUtils::resampleBuffer(mSourceAudio, tmp_buffer, mSourceAudioSampleRate, mSampleRate);
-            mSourceAudio = std::move(tmp_buffer);
-            mSourceAudioSampleRate = mSampleRate;
-        }
+        _setSourceAudio(std::move(playback_audio), mSampleRate, file_key);
 
-        mNumSamplesAcquiredDown = mDownsampledSourceAudio.getNumSamples();
-        mNumSamplesAcquired = mSourceAudio.getNumSamples();
+        mNumSamplesAcquired = mSourceAudio->getNumSamples();
         mDuration = static_cast<double>(mNumSamplesAcquiredDown) / BASIC_PITCH_SAMPLE_RATE;
 
-        _updateWhisperAudioBuffer();
-
         mDroppedFilename = inFile.getFileNameWithoutExtension();
         mSourceFile = inFile;
 
@@ -254,12 +327,16 @@ bool SourceAudioManager::onFileDrop(const File& inFile)
         tree.setPropertyExcludingListener(this, NnId::SourceAudioNativeSrPathId, inFile.getFullPathName(), nullptr);
         mProcessor->getTranscriptionManager()->getTimeQuantizeOptions().fileLoaded();
 
+        // The thumbnail reads its source again when zoomed in: hold it as long as it is set
         mThumbnail.clear();
         mThumbnailCache.clear();
-        mThumbnail.setSource(&mDownsampledSourceAudio, BASIC_PITCH_SAMPLE_RATE, 0);
+        mThumbnailSourceAudio = mDerivedAudio.acquire(DerivedAudioBuffers::Type::Transcription);
+        mThumbnail.setSource(mThumbnailSourceAudio.get(), BASIC_PITCH_SAMPLE_RATE, 0);
+
+        _updateResourceStats();
 
         // Launch transcription jobs
-        mProcessor->getTranscriptionManager()->launchTranscribeJob();
+        mProcessor->getTranscriptionManager()->launchTranscribeJob(std::move(inCachedPosteriorgrams));
         mProcessor->getTextTranscriptionManager()->launchTranscribeJob();
 
     } else {
@@ -275,13 +352,15 @@ void SourceAudioManager::clear()
         stopRecording();
     }
 
-    mSourceAudio = {};
-    mDownsampledSourceAudio = {};
-    mWhisperSourceAudio16k = {};
+    _setSourceAudio(std::make_shared<AudioBuffer<float>>(), mSourceAudioSampleRate, {});
+
+    // Release the thumbnail source only once the thumbnail no longer reads it
+    mThumbnail.clear();
+    mThumbnailSourceAudio.reset();
+    mDerivedAudio.clear();
 
     mNumSamplesAcquiredDown = 0;
     mNumSamplesAcquired = 0;
-    mNumSamplesAcquired16k = 0;
     mDuration = 0.0;
 
     _deleteFilesToDelete();
@@ -289,16 +368,21 @@ void SourceAudioManager::clear()
     mProcessor->getValueTree().setPropertyExcludingListener(this, NnId::SourceAudioNativeSrPathId, String(), nullptr);
 
     mDroppedFilename = "";
+
+    _updateResourceStats();
 }
 
-AudioBuffer<float>& SourceAudioManager::getDownsampledSourceAudioForTranscription()
+DerivedAudioBuffers::Buffer SourceAudioManager::getDownsampledSourceAudioForTranscription()
 {
-    return mDownsampledSourceAudio;
+    auto buffer = mDerivedAudio.acquire(DerivedAudioBuffers::Type::Transcription);
+    _updateResourceStats();
+
+    return buffer;
 }
 
-AudioBuffer<float>& SourceAudioManager::getSourceAudioForPlayback()
+const AudioBuffer<float>& SourceAudioManager::getSourceAudioForPlayback()
 {
-    return mSourceAudio;
+    return *mSourceAudio;
 }
 
 String SourceAudioManager::getDroppedFilename() const
@@ -321,18 +405,18 @@ AudioThumbnail* SourceAudioManager::getAudioThumbnail()
     return &mThumbnail;
 }
 
-float* SourceAudioManager::getAudioResampled16k()
+DerivedAudioBuffers::Buffer SourceAudioManager::getAudioResampled16k()
 {
-    if (mWhisperSourceAudio16k.getNumSamples() == 0) {
-        return nullptr;
-    }
+    auto buffer = mDerivedAudio.acquire(DerivedAudioBuffers::Type::Whisper);
+    _updateResourceStats();
 
-    return mWhisperSourceAudio16k.getWritePointer(0);
+    return buffer;
 }
 
-int SourceAudioManager::getNumSamples16k() const
+void SourceAudioManager::releaseUnusedAudio()
 {
-    return static_cast<int>(mNumSamplesAcquired16k);
+    mDerivedAudio.trim();
+    _updateResourceStats();
 }
 
 void SourceAudioManager::valueTreePropertyChanged(ValueTree& treeWhosePropertyHasChanged, const Identifier& property)
@@ -368,11 +452,13 @@ void SourceAudioManager::_deleteFilesToDelete()
             bool res = file.deleteFile();
             if (!res) {
                 // Log error but continue - file deletion failures shouldn't break the plugin
-                DBG("WARNING: Failed to delete temporary file: " + file.getFullPathName());
+                NN_LOG_WARNING(Recording, "Failed to delete temporary file: {}", file.getFullPathName().toRawUTF8());
             }
         } else {
             // This should never happen - we're trying to delete a file outside our directory
-            DBG("ERROR: Attempted to delete file outside NeuralNote directory: " + file.getFullPathName());
+            NN_LOG_ERROR(Recording,
+                         "Attempted to delete file outside NeuralNote directory: {}",
+                         file.getFullPathName().toRawUTF8());
             jassertfalse;
         }
     }
@@ -380,18 +466,65 @@ void SourceAudioManager::_deleteFilesToDelete()
     mFilesToDelete.clear();
 }
 
-void SourceAudioManager::_updateWhisperAudioBuffer()
+DerivedAudioBuffers::Buffer SourceAudioManager::_computeDownsampledSourceAudio()
 {
-    if (mDownsampledSourceAudio.getNumSamples() == 0) {
-        mWhisperSourceAudio16k.setSize(0, 0);
-        mNumSamplesAcquired16k = 0;
-        return;
+    ScopedLock sl(mSourceAudioLock);
+
+    return SourceAudioCache::getInstance().getOrCompute<AudioBuffer<float>>(
+        mSourceFileKey, SourceAudioCache::Representation::Transcription, BASIC_PITCH_SAMPLE_RATE, [this]() {
+            auto buffer = std::make_shared<AudioBuffer<float>>();
+
+            if (mSourceAudio->getNumSamples() > 0) {
+                AudioUtils::resampleBuffer(*mSourceAudio, *buffer, mSourceAudioSampleRate, BASIC_PITCH_SAMPLE_RATE);
+            }
+
+            return buffer;
+        });
+}
+
+DerivedAudioBuffers::Buffer SourceAudioManager::_computeAudioResampled16k()
+{
+    ScopedLock sl(mSourceAudioLock);
+
+    return SourceAudioCache::getInstance().getOrCompute<AudioBuffer<float>>(
+        mSourceFileKey, SourceAudioCache::Representation::Whisper, WhisperConstants::WHISPER_SAMPLE_RATE, [this]() {
+            auto buffer = std::make_shared<AudioBuffer<float>>();
+
+            if (mSourceAudio->getNumSamples() > 0) {
+                AudioBuffer<float> mono_buffer;
+                AudioUtils::downmixToMono(*mSourceAudio, mono_buffer);
+                AudioUtils::resampleBuffer(
+                    mono_buffer, *buffer, mSourceAudioSampleRate, WhisperConstants::WHISPER_SAMPLE_RATE);
+            }
+
+            return buffer;
+        });
+}
+
+void SourceAudioManager::_setSourceAudio(std::shared_ptr<AudioBuffer<float>> inBuffer,
+                                         double inSampleRate,
+                                         const SourceAudioCache::FileKey& inFileKey)
+{
+    ScopedLock sl(mSourceAudioLock);
+
+    mSourceAudio = std::move(inBuffer);
+    mSourceAudioSampleRate = inSampleRate;
+    mSourceFileKey = inFileKey;
+}
+
+void SourceAudioManager::_updateResourceStats()
+{
+    // Buffers shared with other instances through the source audio cache are counted by each of them
+    uint64_t num_bytes = mDerivedAudio.getResidentBytes();
+
+    {
+        ScopedLock sl(mSourceAudioLock);
+        num_bytes += DerivedAudioBuffers::getNumBytes(*mSourceAudio);
     }
 
-    AudioUtils::resampleBuffer(mDownsampledSourceAudio,
-                               mWhisperSourceAudio16k,
-                               BASIC_PITCH_SAMPLE_RATE,
-                               WhisperConstants::WHISPER_SAMPLE_RATE);
+    for (const auto* buffer: {&mInternalMonoBuffer, &mInternalDownsampledBuffer}) {
+        num_bytes += DerivedAudioBuffers::getNumBytes(*buffer);
+    }
 
-    mNumSamplesAcquired16k = static_cast<unsigned long long>(mWhisperSourceAudio16k.getNumSamples());
+    mProcessor->getResourceStats().setBytes(ResourceStats::Memory::SourceAudio, num_bytes);
 }
@@ -6,9 +6,12 @@
 #define SourceAudioManager_h
 
 #include <JuceHeader.h>
+#include "BasicPitch.h"
 #include "BasicPitchConstants.h"
 #include "Resampler.h"
 #include "AudioUtils.h"
+#include "DerivedAudioBuffers.h"
+#include "SourceAudioCache.h"
 #include "WhisperConstants.h"
 
 class NeuralNoteAudioProcessor;
@@ -48,9 +51,11 @@ public:
     /**
      * Function to call when a file is dropped on the audio region to load it.
      * @param inFile Audio file to load
+     * @param inCachedPosteriorgrams Posteriorgrams already computed for this file, to skip running the CNN again.
      * @return Whether audio file load was successful
      */
-    bool onFileDrop(const File& inFile);
+    bool onFileDrop(const File& inFile,
+                    std::shared_ptr<const BasicPitch::Posteriorgrams> inCachedPosteriorgrams = nullptr);
 
     /**
      * Stop recording if needed and then reset/clear everything owned by this class.
@@ -59,15 +64,17 @@ public:
 
     /**
      * To call only when the recording/file loading is fully completed, otherwise you'll get and empty buffer.
-     * @return A reference to the downsampled source audio.
+     * Computed on first request, and kept in memory as long as the returned pointer is held. Must not be modified.
+     * @return The source audio at basic pitch sample rate, with all the source channels.
      */
-    AudioBuffer<float>& getDownsampledSourceAudioForTranscription();
+    DerivedAudioBuffers::Buffer getDownsampledSourceAudioForTranscription();
 
     /**
-     * Get source audio at current processor sample rate.
+     * Get source audio at current processor sample rate. Always resident since it is read on the audio thread, the
+     * other representations are derived from it. Shared with the other instances that loaded the same file.
      * @return Reference to source audio buffer (recorded or loaded from file).
      */
-    AudioBuffer<float>& getSourceAudioForPlayback();
+    const AudioBuffer<float>& getSourceAudioForPlayback();
 
     /**
      * Return a string containing the filename of the dropped audio file.
@@ -95,21 +102,27 @@ public:
     AudioThumbnail* getAudioThumbnail();
 
     /**
-     * Retrieve audio resampled to 16 kHz for Whisper integration.
-     * @return Pointer to the mono 16 kHz buffer or nullptr if unavailable.
+     * Retrieve audio resampled to 16 kHz for Whisper integration. Computed on first request, so only when a Whisper
+     * backend is ready to use it, and kept in memory as long as the returned pointer is held. Must not be modified.
+     * @return The mono 16 kHz buffer, empty if no source audio.
      */
-    float* getAudioResampled16k();
+    DerivedAudioBuffers::Buffer getAudioResampled16k();
 
     /**
-     * Number of samples available in the 16 kHz Whisper buffer.
+     * Evict the derived buffers no transcription holds anymore if over the memory budget. To call once done with them.
      */
-    int getNumSamples16k() const;
+    void releaseUnusedAudio();
 
 private:
     void valueTreePropertyChanged(ValueTree& treeWhosePropertyHasChanged, const Identifier& property) override;
 
     void _deleteFilesToDelete();
 
+    /**
+     * Report the memory held by the audio buffers to the instance statistics.
+     */
+    void _updateResourceStats();
+
     NeuralNoteAudioProcessor* mProcessor;
 
     std::unique_ptr<juce::AudioFormatWriter::ThreadedWriter> mThreadedWriter;
@@ -126,25 +139,36 @@ private:
     juce::AudioThumbnailCache mThumbnailCache;
     juce::AudioThumbnail mThumbnail;
 
+    // Source of the thumbnail for loaded files, which keeps reading it when zoomed in
+    DerivedAudioBuffers::Buffer mThumbnailSourceAudio;
+
     const File mNeuralNoteDir =
         File::getSpecialLocation(File::SpecialLocationType::userApplicationDataDirectory).getChildFile("NeuralNote");
     File mSourceFile;
     File mRecordedFileDown;
 
-    AudioBuffer<float> mSourceAudio;
-    AudioBuffer<float> mDownsampledSourceAudio; // Always at basic pitch sample rate
-    AudioBuffer<float> mWhisperSourceAudio16k;  // Mono buffer at 16 kHz for Whisper
+    // Never modified once set, since it can be shared with other instances
+    std::shared_ptr<AudioBuffer<float>> mSourceAudio = std::make_shared<AudioBuffer<float>>();
 
     // Sample rate for mSourceAudio buffer
     double mSourceAudioSampleRate = 44100;
 
+    // Key of the loaded file in the process wide cache, invalid for recorded audio
+    SourceAudioCache::FileKey mSourceFileKey;
+
+    // Locks the replacement of mSourceAudio against the computation of the derived buffers on the job threads
+    CriticalSection mSourceAudioLock;
+
+    // Bytes the derived buffers no longer in use may keep, to avoid computing them again on the next transcription
+    static constexpr uint64_t DERIVED_AUDIO_MEMORY_BUDGET = 16 * 1024 * 1024;
+    DerivedAudioBuffers mDerivedAudio {DERIVED_AUDIO_MEMORY_BUDGET};
+
     std::vector<juce::File> mFilesToDelete;
 
     double mSampleRate = 44100;
 
     std::atomic<unsigned long long> mNumSamplesAcquired = 0;
     std::atomic<unsigned long long> mNumSamplesAcquiredDown = 0;
-    std::atomic<unsigned long long> mNumSamplesAcquired16k = 0;
     std::atomic<double> mDuration = 0.0;
 
     String mDroppedFilename;
@@ -154,7 +178,16 @@ private:
 
     std::atomic<bool> mIsRecording = false;
 
-    void _updateWhisperAudioBuffer();
+    DerivedAudioBuffers::Buffer _computeDownsampledSourceAudio();
+
+    DerivedAudioBuffers::Buffer _computeAudioResampled16k();
+
+    /**
+     * Replace the source audio, after a recording or a file load.
+     */
+    void _setSourceAudio(std::shared_ptr<AudioBuffer<float>> inBuffer,
+                         double inSampleRate,
+                         const SourceAudioCache::FileKey& inFileKey);
 };
 
 #endif // SourceAudioManager_h
@@ -70,6 +70,33 @@ void SynthController::setNewMidiEventsVectorToUse(std::vector<MidiMessage>& inEv
     _sanitizeVoices();
 }
 
+void SynthController::applyNoteEventsDiff(const Notes::EventsDiff& inDiff)
+{
+    if (inDiff.isEmpty())
+        return;
+
+    const ScopedLock sl(mProcessor->getCallbackLock());
+
+    for (const auto& note_event: inDiff.removed)
+        _removeNoteEvent(note_event);
+
+    for (const auto& [prev_note_event, new_note_event]: inDiff.modified) {
+        _removeNoteEvent(prev_note_event);
+        _insertNoteEvent(new_note_event);
+    }
+
+    for (const auto& note_event: inDiff.added)
+        _insertNoteEvent(note_event);
+
+    _updateCurrentEventIndex();
+    _sanitizeVoices();
+}
+
+bool SynthController::shouldPatchWithDiff(const Notes::EventsDiff& inDiff, size_t inNumEvents)
+{
+    return inDiff.getNumChanges() <= std::min(mMaxNumChangesToPatch, inNumEvents / 4);
+}
+
 void SynthController::setSampleRate(double inSampleRate)
 {
     mSampleRate = inSampleRate;
@@ -156,6 +183,44 @@ void SynthController::_updateCurrentEventIndex()
                          - mEvents.begin();
 }
 
+void SynthController::_removeNoteEvent(const Notes::Event& inNoteEvent)
+{
+    // Same messages as the ones built by buildMidiEventsVector
+    auto remove_message = [this](double inTimeStamp, int inMidiNote, bool inIsNoteOn) {
+        auto iter = std::lower_bound(mEvents.begin(), mEvents.end(), inTimeStamp, [](const MidiMessage& a, double b) {
+            return a.getTimeStamp() < b;
+        });
+
+        for (; iter != mEvents.end() && iter->getTimeStamp() == inTimeStamp; ++iter) {
+            if (iter->getNoteNumber() == inMidiNote && (inIsNoteOn ? iter->isNoteOn() : iter->isNoteOff())) {
+                mEvents.erase(iter);
+                return;
+            }
+        }
+
+        jassertfalse;
+    };
+
+    remove_message(inNoteEvent.startTime, inNoteEvent.pitch, true);
+    remove_message(inNoteEvent.endTime, inNoteEvent.pitch, false);
+}
+
+void SynthController::_insertNoteEvent(const Notes::Event& inNoteEvent)
+{
+    _insertMidiMessage(MidiMessage::noteOn(1, inNoteEvent.pitch, (float) inNoteEvent.amplitude)
+                           .withTimeStamp(inNoteEvent.startTime));
+    _insertMidiMessage(MidiMessage::noteOff(1, inNoteEvent.pitch).withTimeStamp(inNoteEvent.endTime));
+}
+
+void SynthController::_insertMidiMessage(const MidiMessage& inMessage)
+{
+    auto iter = std::upper_bound(mEvents.begin(),
+                                 mEvents.end(),
+                                 inMessage.getTimeStamp(),
+                                 [](double a, const MidiMessage& b) { return a < b.getTimeStamp(); });
+    mEvents.insert(iter, inMessage);
+}
+
 bool SynthController::_isNextOnOffEventNoteOff(int inMidiNote)
 {
     auto iter = std::find_if(
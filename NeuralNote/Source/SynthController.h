@@ -23,6 +23,20 @@ public:
 
     void setNewMidiEventsVectorToUse(std::vector<MidiMessage>& inEvents);
 
+    /**
+     * Patch the current events vector in place with the changes of a post-processing update, instead of swapping the
+     * whole vector. Should be used for small diffs only as every change moves the events after it.
+     * @param inDiff Changes between the note events used to build the current events vector and the new ones.
+     */
+    void applyNoteEventsDiff(const Notes::EventsDiff& inDiff);
+
+    /**
+     * @param inDiff Changes between two note event vectors.
+     * @param inNumEvents Number of note events after the changes.
+     * @return True if the diff is small enough to be applied with applyNoteEventsDiff.
+     */
+    static bool shouldPatchWithDiff(const Notes::EventsDiff& inDiff, size_t inNumEvents);
+
     const MidiBuffer& generateNextMidiBuffer(int inNumSamples);
 
     void reset();
@@ -38,6 +52,15 @@ private:
 
     bool _isNextOnOffEventNoteOff(int inMidiNote);
 
+    void _removeNoteEvent(const Notes::Event& inNoteEvent);
+
+    void _insertNoteEvent(const Notes::Event& inNoteEvent);
+
+    void _insertMidiMessage(const MidiMessage& inMessage);
+
+    // Above this number of changes, rebuilding and swapping the whole vector is cheaper than patching it
+    static constexpr size_t mMaxNumChangesToPatch = 32;
+
     NeuralNoteAudioProcessor* mProcessor;
     MPESynthesiser* mSynth;
 
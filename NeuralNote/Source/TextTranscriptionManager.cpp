@@ -1,34 +1,81 @@
 #include "TextTranscriptionManager.h"
 #include "PluginProcessor.h"
+#include "AsyncLogger.h"
+#include "ResourceStats.h"
 
 TextTranscriptionManager::TextTranscriptionManager(NeuralNoteAudioProcessor* inProcessor)
     : mProcessor(inProcessor)
     , mThreadPool(1)
 {
+    mJobLambda = [this] { _runModel(); };
+
+    // Loading the model (or probing the HTTP service) can take seconds: never on the thread creating the plugin.
+    // Jobs run in order on the single thread, so transcriptions launched meanwhile wait for the backend.
+    mThreadPool.addJob([this] { _initializeBackend(); });
+
+    // TODO: Add parameter listeners for text transcription settings when UI is implemented
+    // For example: language selection, model size, etc.
+}
+
+TextTranscriptionManager::~TextTranscriptionManager()
+{
+    cancelPendingUpdate();
+
+    // Abort the running transcription or warm-up (a whisper.cpp run, or a request waiting for the HTTP service).
+    // Model loading cannot be interrupted, wait for it rather than destroying the transcriber under it.
+    mShouldStopWarmUp = true;
+    mWhisperTranscriber.abort();
+    mThreadPool.removeAllJobs(true, -1);
+}
+
+TextTranscriptionManager::Status TextTranscriptionManager::getStatus() const
+{
+    return mStatus.load();
+}
+
+void TextTranscriptionManager::_initializeBackend()
+{
+    mWhisperTranscriber.initialize();
+
     // Check if Whisper model initialization succeeded
     if (!mWhisperTranscriber.isInitialized()) {
-        DBG("WARNING: Whisper model not initialized: " + mWhisperTranscriber.getErrorMessage());
+        NN_LOG_WARNING(Whisper, "Whisper model not initialized: {}", mWhisperTranscriber.getErrorMessage());
         // Don't show error dialog since this is a new feature and models may not be embedded yet
-        // NativeMessageBox::showMessageBoxAsync(MessageBoxIconType::InfoIcon,
-        //                                        "Text Transcription",
-        //                                        "Whisper model not available:\n" + mWhisperTranscriber.getErrorMessage()
-        //                                            + "\n\nText transcription will not be available.");
+        mStatus = Status::Unavailable;
+    } else {
+        mStatus = Status::Ready;
     }
 
-    mJobLambda = [this] { _runModel(); };
+    _updateResourceStats();
 
-    // TODO: Add parameter listeners for text transcription settings when UI is implemented
-    // For example: language selection, model size, etc.
+    // Refresh the UI, which shows the backend in use
+    mShouldUpdateDisplay = true;
+    triggerAsyncUpdate();
 
-    startTimerHz(30);
+#if WHISPER_WARM_UP
+    // A warm-up runs a full Whisper window, so it is opt-in
+    if (mStatus == Status::Ready) {
+        mWhisperTranscriber.warmUp(mShouldStopWarmUp);
+    }
+#endif
 }
 
-TextTranscriptionManager::~TextTranscriptionManager()
+void TextTranscriptionManager::_retryBackend()
 {
-    stopTimer();
+    if (mWhisperTranscriber.retryHTTPService()) {
+        mStatus = Status::Ready;
+    } else {
+        NN_LOG_WARNING(Whisper, "Whisper still unavailable: {}", mWhisperTranscriber.getErrorMessage());
+        mStatus = Status::Unavailable;
+    }
+
+    _updateResourceStats();
+
+    mShouldUpdateDisplay = true;
+    triggerAsyncUpdate();
 }
 
-void TextTranscriptionManager::timerCallback()
+void TextTranscriptionManager::handleAsyncUpdate()
 {
     if (mShouldRunNewTranscription) {
         launchTranscribeJob();
@@ -41,18 +88,30 @@ void TextTranscriptionManager::setLaunchNewTranscription()
 {
     mShouldRunNewTranscription = true;
     mShouldUpdateDisplay = false;
+
+    triggerAsyncUpdate();
 }
 
 void TextTranscriptionManager::launchTranscribeJob()
 {
     mShouldRunNewTranscription = false;
 
-    if (!mWhisperTranscriber.isInitialized()) {
-        DBG("Cannot launch text transcription - Whisper model not initialized");
-        return;
+    if (mStatus == Status::Unavailable) {
+        const auto now = Time::getMillisecondCounter();
+
+        if (mLastRetryBackendTime != 0 && now - mLastRetryBackendTime < mRetryBackendIntervalMs) {
+            NN_LOG_WARNING(Whisper, "Cannot launch text transcription - Whisper model not initialized");
+            return;
+        }
+
+        // The HTTP service may have been started since the backend initialization: check again before transcribing.
+        // Loading until the check is done, so that the UI does not read the backend while it changes.
+        mLastRetryBackendTime = now;
+        mStatus = Status::Loading;
+        mThreadPool.addJob([this] { _retryBackend(); });
     }
 
-    // Launch job on background thread
+    // Launch job on background thread, after the backend initialization if still loading
     mThreadPool.addJob(mJobLambda);
 }
 
@@ -64,25 +123,39 @@ void TextTranscriptionManager::_runModel()
 
     auto* sourceAudioManager = mProcessor->getSourceAudioManager();
     if (sourceAudioManager == nullptr) {
-        DBG("Text transcription skipped - missing SourceAudioManager");
+        NN_LOG_WARNING(Whisper, "Text transcription skipped - missing SourceAudioManager");
         return;
     }
 
-    float* audio16k = sourceAudioManager->getAudioResampled16k();
-    const int numSamples = sourceAudioManager->getNumSamples16k();
+    // Computed on first request, only once a backend is ready to use it
+    auto audio16k = sourceAudioManager->getAudioResampled16k();
 
-    if (audio16k == nullptr || numSamples == 0) {
-        DBG("Text transcription skipped - 16kHz audio not available yet");
+    if (audio16k == nullptr || audio16k->getNumSamples() == 0) {
+        NN_LOG_INFO(Whisper, "Text transcription skipped - 16kHz audio not available yet");
         return;
     }
 
-    auto words = mWhisperTranscriber.transcribeToText(audio16k, numSamples);
-    if (words.empty()) {
-        DBG("Text transcription completed but returned no tokens.");
+    {
+        ResourceStats::InstanceStats::ScopedJob stats_job(mProcessor->getResourceStats(),
+                                                          ResourceStats::Job::TextTranscription);
+
+        // Shared with other instances and threads, so only read: getWritePointer would write its isClear flag. The
+        // backends take a non const pointer but do not write the audio.
+        auto words = mWhisperTranscriber.transcribeToText(const_cast<float*>(audio16k->getReadPointer(0)),
+                                                          audio16k->getNumSamples());
+        if (words.empty()) {
+            NN_LOG_INFO(Whisper, "Text transcription completed but returned no tokens.");
+        }
     }
 
+    audio16k.reset();
+    sourceAudioManager->releaseUnusedAudio();
+
+    _updateResourceStats();
+
     // Signal UI update
     mShouldUpdateDisplay = true;
+    triggerAsyncUpdate();
 }
 
 void TextTranscriptionManager::_updateTranscriptionDisplay()
@@ -120,12 +193,31 @@ std::string TextTranscriptionManager::getFullText() const
     return mWhisperTranscriber.getFullText();
 }
 
+std::string TextTranscriptionManager::getBackendDescription() const
+{
+    // The transcriber is being initialized on the job thread while loading
+    if (mStatus == Status::Loading) {
+        return "Loading Whisper...";
+    }
+
+    return mWhisperTranscriber.getBackendDescription();
+}
+
 void TextTranscriptionManager::clear()
 {
-    mWhisperTranscriber.reset();
     mShouldRunNewTranscription = false;
     mShouldUpdateDisplay = false;
     mProcessor->clearTimedWordsOnUI();
+
+    // The transcriber is only used on the job thread, where a transcription may be running: reset it after the jobs
+    // queued so far, then refresh the UI in case a running transcription updated it meanwhile.
+    mThreadPool.addJob([this] {
+        mWhisperTranscriber.reset();
+        _updateResourceStats();
+
+        mShouldUpdateDisplay = true;
+        triggerAsyncUpdate();
+    });
 }
 
 void TextTranscriptionManager::setLanguage(WhisperConstants::Language language)
@@ -137,3 +229,14 @@ WhisperConstants::Language TextTranscriptionManager::getLanguage() const
 {
     return mWhisperTranscriber.getLanguage();
 }
+
+void TextTranscriptionManager::_updateResourceStats()
+{
+    // Reported by _initializeBackend once loaded
+    if (mStatus == Status::Loading) {
+        return;
+    }
+
+    mProcessor->getResourceStats().setBytes(ResourceStats::Memory::Whisper,
+                                            mWhisperTranscriber.getEstimatedMemoryBytes());
+}
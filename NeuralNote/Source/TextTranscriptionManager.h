@@ -7,17 +7,25 @@ class NeuralNoteAudioProcessor;
 
 /**
  * Manager for text transcription using Whisper model
- * Handles background threading and coordination with UI
+ * Handles background threading and coordination with UI, through async updates posted when there is something to do
  */
 class TextTranscriptionManager
-    : public Timer
-    , public AudioProcessorValueTreeState::Listener
+    : public AudioProcessorValueTreeState::Listener
+    , private AsyncUpdater
 {
 public:
+    enum class Status { Loading = 0, Ready, Unavailable };
+
     explicit TextTranscriptionManager(NeuralNoteAudioProcessor* inProcessor);
     ~TextTranscriptionManager() override;
 
-    void timerCallback() override;
+    /**
+     * The Whisper backend is discovered and its model loaded on the job thread after construction, so that creating
+     * an instance never waits for Whisper. Transcriptions launched while loading run once it is done. Transcriptions
+     * launched while unavailable check again for the HTTP service first, which may have been started since.
+     * @return Whether text transcription is ready, still loading, or unavailable (no backend found).
+     */
+    Status getStatus() const;
 
     void setLaunchNewTranscription();
 
@@ -31,6 +39,12 @@ public:
 
     std::string getFullText() const;
 
+    /**
+     * @return Description of the Whisper backend and model in use, a loading message while the backend is
+     * initialized, empty if none is available.
+     */
+    std::string getBackendDescription() const;
+
     void clear();
 
     void setLanguage(WhisperConstants::Language language);
@@ -38,16 +52,39 @@ public:
     WhisperConstants::Language getLanguage() const;
 
 private:
+    void handleAsyncUpdate() override;
+
+    /**
+     * Job run first on the job thread: initialize the Whisper backend, then set the status.
+     */
+    void _initializeBackend();
+
+    /**
+     * Job run before a transcription launched while unavailable: check again for the HTTP service, then set the status.
+     */
+    void _retryBackend();
+
     void _runModel();
 
     void _updateTranscriptionDisplay();
 
+    /**
+     * Report the memory used by the transcriber. Reads the transcriber, so only called on the job thread.
+     */
+    void _updateResourceStats();
+
     NeuralNoteAudioProcessor* mProcessor;
 
     WhisperTranscriber mWhisperTranscriber;
+    std::atomic<Status> mStatus = Status::Loading;
 
     std::atomic<bool> mShouldRunNewTranscription = false;
     std::atomic<bool> mShouldUpdateDisplay = false;
+    std::atomic<bool> mShouldStopWarmUp = false;
+
+    // Minimum time between two checks for the HTTP service while unavailable
+    static constexpr uint32 mRetryBackendIntervalMs = 5000;
+    uint32 mLastRetryBackendTime = 0;
 
     ThreadPool mThreadPool;
     std::function<void()> mJobLambda;
@@ -107,45 +107,6 @@ void TimeQuantizeOptions::_setInfo(const Optional<AudioPlayHead::PositionInfo>&
     mInfoUpdated = true;
 }
 
-void TimeQuantizeOptions::setParameters(bool inEnable,
-                                        TimeQuantizeUtils::TimeDivisions inDivision,
-                                        float inQuantizationForce)
-{
-    mParameters.enable = inEnable;
-    mParameters.division = inDivision;
-    mParameters.quantizationForce = inQuantizationForce;
-}
-
-std::vector<Notes::Event> TimeQuantizeOptions::quantize(const std::vector<Notes::Event>& inNoteEvents) const
-{
-    if (!mParameters.enable) {
-        return inNoteEvents;
-    }
-
-    std::vector<Notes::Event> out_events;
-
-    const double bpm = mTimeQuantizeInfo.bpm;
-    // Offset from previous bar start
-    const double start_pos_qn = mTimeQuantizeInfo.getStartQn() - mTimeQuantizeInfo.getStartLastBarQn();
-
-    const double time_division = TimeQuantizeUtils::TimeDivisionsDouble.at(static_cast<size_t>(mParameters.division));
-
-    for (const auto& event: inNoteEvents) {
-        double duration = event.endTime - event.startTime;
-        jassert(duration > 0);
-        double new_start_time =
-            _quantizeTime(event.startTime, bpm, time_division, start_pos_qn, mParameters.quantizationForce);
-        double new_end_time = new_start_time + duration;
-
-        Notes::Event quantized_event = event;
-        quantized_event.startTime = new_start_time;
-        quantized_event.endTime = new_end_time;
-        out_events.push_back(quantized_event);
-    }
-
-    return out_events;
-}
-
 void TimeQuantizeOptions::clear()
 {
     // Kepp bpm and time signature, reset ref positions
@@ -199,40 +160,11 @@ bool TimeQuantizeOptions::checkInfoUpdated()
 
 TimeQuantizeOptions::TimeQuantizeInfo TimeQuantizeOptions::getTimeQuantizeInfo() const
 {
+    // Also read on the job threads, for the post-processing
+    ScopedLock lock(mInfoCriticalSection);
     return mTimeQuantizeInfo;
 }
 
-double TimeQuantizeOptions::_quantizeTime(
-    double inEventTime, double inBPM, double inTimeDivision, double inStartTimeQN, float inQuantizationForce)
-{
-    jassert(inEventTime >= 0.0);
-    const double seconds_per_qn = 60.0 / inBPM;
-
-    const double division_duration = inTimeDivision * 4.0 * seconds_per_qn;
-
-    // Set previous bar start of recording start as new time origin.
-    double new_time_origin = inStartTimeQN * seconds_per_qn;
-    double shifted_time = inEventTime + new_time_origin;
-
-    double time_since_previous_division = std::fmod(shifted_time, division_duration);
-
-    // Get the time of the first division tick before the note start
-    double previous_division_time = shifted_time - time_since_previous_division;
-
-    double target_time = time_since_previous_division < division_duration / 2.0
-                             ? previous_division_time
-                             : previous_division_time + division_duration;
-
-    jassert(shifted_time >= previous_division_time && shifted_time < previous_division_time + division_duration);
-
-    double quantized_shifted_time = jmap(static_cast<double>(inQuantizationForce), shifted_time, target_time);
-
-    // Re-shift
-    double quantized_time = quantized_shifted_time - new_time_origin;
-
-    return quantized_time;
-}
-
 void TimeQuantizeOptions::valueTreePropertyChanged(ValueTree& treeWhosePropertyHasChanged, const Identifier& property)
 {
     if (property == NnId::TempoId) {
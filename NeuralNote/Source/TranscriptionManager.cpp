@@ -5,6 +5,8 @@
 #include "TranscriptionManager.h"
 #include "PluginProcessor.h"
 #include "NeuralNoteMainView.h"
+#include "AsyncLogger.h"
+#include "ResourceStats.h"
 
 TranscriptionManager::TranscriptionManager(NeuralNoteAudioProcessor* inProcessor)
     : mProcessor(inProcessor)
@@ -13,7 +15,7 @@ TranscriptionManager::TranscriptionManager(NeuralNoteAudioProcessor* inProcessor
 {
     // Check if model initialization succeeded
     if (!mBasicPitch.isInitialized()) {
-        DBG("ERROR: BasicPitch model failed to initialize: " + mBasicPitch.getErrorMessage());
+        NN_LOG_ERROR(Transcription, "BasicPitch model failed to initialize: {}", mBasicPitch.getErrorMessage());
         NativeMessageBox::showMessageBoxAsync(MessageBoxIconType::WarningIcon,
                                                "NeuralNote Initialization Error",
                                                "Failed to load transcription model:\n" + mBasicPitch.getErrorMessage()
@@ -22,6 +24,23 @@ TranscriptionManager::TranscriptionManager(NeuralNoteAudioProcessor* inProcessor
 
     mJobLambda = [this] { _runModel(); };
 
+    // A single transcription is latency bound: split the CNN branches over two cores when there are enough of them.
+    // The per channel instances already run in parallel, so they keep the sequential CNN.
+    mBasicPitch.setParallelCNN(SystemStats::getNumPhysicalCpus() > 2);
+    // Parameter updates of long files convert the whole posteriorgrams again: split them over the cores as well.
+    mBasicPitch.setNumNotesThreads(static_cast<size_t>(std::max(1, SystemStats::getNumPhysicalCpus())));
+
+    // Warm up the models in the background. Transcription jobs use the same single thread pool, so they simply wait
+    // for the warm-up to finish.
+    if (mBasicPitch.isInitialized()) {
+        mThreadPool.addJob([this] {
+            mBasicPitch.warmUp(mShouldStopWarmUp);
+            mWarmUpDone.signal();
+        });
+    } else {
+        mWarmUpDone.signal();
+    }
+
     auto& apvts = mProcessor->getAPVTS();
 
     apvts.addParameterListener(ParameterHelpers::getIdStr(ParameterHelpers::NoteSensitivityId), this);
@@ -39,12 +58,22 @@ TranscriptionManager::TranscriptionManager(NeuralNoteAudioProcessor* inProcessor
     apvts.addParameterListener(ParameterHelpers::getIdStr(ParameterHelpers::EnableTimeQuantizationId), this);
     apvts.addParameterListener(ParameterHelpers::getIdStr(ParameterHelpers::TimeDivisionId), this);
     apvts.addParameterListener(ParameterHelpers::getIdStr(ParameterHelpers::QuantizationForceId), this);
+}
 
-    startTimerHz(30);
+TranscriptionManager::~TranscriptionManager()
+{
+    cancelPendingUpdate();
+
+    // Cancel the warm-up if still running, and wait for any job to finish before the models are destroyed. The
+    // transcription job waits for its channel jobs: those are done once it is.
+    mShouldStopWarmUp = true;
+    mThreadPool.removeAllJobs(true, 5000);
+    mChannelThreadPool->removeJobs(this, 5000);
 }
 
-void TranscriptionManager::timerCallback()
+void TranscriptionManager::handleAsyncUpdate()
 {
+    // The time quantize info is only set while recording, and recording ends with a new transcription
     if (mTimeQuantizeOptions.checkInfoUpdated()) {
         mTimeQuantizeOptions.saveStateToValueTree(true);
     }
@@ -54,14 +83,15 @@ void TranscriptionManager::timerCallback()
         _repaintPianoRoll();
     } else if (mShouldUpdateTranscription) {
         _updateTranscription();
-        _repaintPianoRoll();
+        _repaintPianoRollChanges();
     } else if (mShouldUpdatePostProcessing) {
         _updatePostProcessing();
-        _repaintPianoRoll();
+        _repaintPianoRollChanges();
     } else if (mShouldRepaintPianoRoll) {
         _repaintPianoRoll();
     }
 }
+
 void TranscriptionManager::prepareToPlay(double inSampleRate)
 {
     mTimeQuantizeOptions.prepareToPlay(inSampleRate);
@@ -77,6 +107,8 @@ void TranscriptionManager::setLaunchNewTranscription()
     mShouldRunNewTranscription = true;
     mShouldUpdateTranscription = false;
     mShouldUpdatePostProcessing = false;
+
+    triggerAsyncUpdate();
 }
 
 void TranscriptionManager::parameterChanged(const String& parameterID, float newValue)
@@ -89,58 +121,113 @@ void TranscriptionManager::parameterChanged(const String& parameterID, float new
     if (mProcessor->getState() == PopulatedAudioAndMidiRegions) {
         if (parameterID == ParameterHelpers::getIdStr(ParameterHelpers::NoteSensitivityId)
             || parameterID == ParameterHelpers::getIdStr(ParameterHelpers::SplitSensitivityId)
-            || parameterID == ParameterHelpers::getIdStr(ParameterHelpers::MinimumNoteDurationId)) {
+            || parameterID == ParameterHelpers::getIdStr(ParameterHelpers::MinimumNoteDurationId)
+            // The MIDI note range of the key options is applied by Notes::convert, to skip the pitches out of it
+            || parameterID == ParameterHelpers::getIdStr(ParameterHelpers::EnableNoteQuantizationId)
+            || parameterID == ParameterHelpers::getIdStr(ParameterHelpers::MinMidiNoteId)
+            || parameterID == ParameterHelpers::getIdStr(ParameterHelpers::MaxMidiNoteId)) {
             mShouldUpdateTranscription = true;
 
-        } else if (parameterID == ParameterHelpers::getIdStr(ParameterHelpers::EnableNoteQuantizationId)
-                   || parameterID == ParameterHelpers::getIdStr(ParameterHelpers::KeyRootNoteId)
+        } else if (parameterID == ParameterHelpers::getIdStr(ParameterHelpers::KeyRootNoteId)
                    || parameterID == ParameterHelpers::getIdStr(ParameterHelpers::KeyTypeId)
                    || parameterID == ParameterHelpers::getIdStr(ParameterHelpers::KeySnapModeId)
-                   || parameterID == ParameterHelpers::getIdStr(ParameterHelpers::MinMidiNoteId)
-                   || parameterID == ParameterHelpers::getIdStr(ParameterHelpers::MaxMidiNoteId)
-                   || parameterID == ParameterHelpers::getIdStr(ParameterHelpers::EnableTimeQuantizationId)
                    || parameterID == ParameterHelpers::getIdStr(ParameterHelpers::TimeDivisionId)
                    || parameterID == ParameterHelpers::getIdStr(ParameterHelpers::QuantizationForceId)) {
             mShouldUpdatePostProcessing = true;
+            // The bends are computed on demand: they are needed to snap notes in adjust mode.
+            if (_shouldComputePitchBends() && !mArePitchBendsComputed) {
+                mShouldUpdateTranscription = true;
+            }
+        } else if (parameterID == ParameterHelpers::getIdStr(ParameterHelpers::EnableTimeQuantizationId)) {
+            // Beat lines are shown or hidden: the whole piano roll needs to be repainted
+            mShouldUpdatePostProcessing = true;
+            mShouldRepaintPianoRoll = true;
         } else if (parameterID == ParameterHelpers::getIdStr(ParameterHelpers::PitchBendModeId)) {
             mShouldRepaintPianoRoll = true;
+
+            if (_shouldComputePitchBends() && !mArePitchBendsComputed) {
+                mShouldUpdateTranscription = true;
+            }
         }
+
+        // Parameters can change on any thread, e.g. automation on the audio thread: the update is done on the message
+        // thread. Several changes before the update is handled result in a single update.
+        triggerAsyncUpdate();
     }
 }
 
 void TranscriptionManager::_runModel()
 {
-    mBasicPitch.setParameters(mProcessor->getParameterValue(ParameterHelpers::NoteSensitivityId),
-                              mProcessor->getParameterValue(ParameterHelpers::SplitSensitivityId),
-                              mProcessor->getParameterValue(ParameterHelpers::MinimumNoteDurationId));
-    mBasicPitch.transcribeToMIDI(
-        mProcessor->getSourceAudioManager()->getDownsampledSourceAudioForTranscription().getWritePointer(0),
-        mProcessor->getSourceAudioManager()->getNumSamplesDownAcquired());
+    ResourceStats::InstanceStats::ScopedJob stats_job(mProcessor->getResourceStats(),
+                                                      ResourceStats::Job::Transcription);
+
+    auto* source_audio_manager = mProcessor->getSourceAudioManager();
+    auto source_audio_buffer = source_audio_manager->getDownsampledSourceAudioForTranscription();
+    jassert(source_audio_buffer != nullptr);
+    // Shared with other instances and threads, so only read: getWritePointer would write its isClear flag. The models
+    // take a non const pointer but do not write the audio.
+    const auto& source_audio = *source_audio_buffer;
+
+    // A buffer computed again from the source audio can differ by a few samples from the one recorded
+    const int num_samples = std::min(source_audio_manager->getNumSamplesDownAcquired(), source_audio.getNumSamples());
+
+    if (mCachedPosteriorgrams != nullptr) {
+        // Posteriorgrams from the batch queue are computed on the mono downmix
+        mNumTranscribedChannels = 1;
+        _setBasicPitchParameters();
+        mBasicPitch.setPosteriorgrams(*mCachedPosteriorgrams);
+        mCachedPosteriorgrams.reset();
+    } else if (mShouldTranscribePerChannel && source_audio.getNumChannels() > 1) {
+        mNumTranscribedChannels = std::min(source_audio.getNumChannels(), mMaxNumTranscribedChannels);
+
+        while (static_cast<int>(mChannelBasicPitch.size()) < mNumTranscribedChannels - 1) {
+            mChannelBasicPitch.push_back(std::make_unique<BasicPitch>());
+        }
 
-    mNoteOptions.setParameters(
-        mProcessor->getParameterValue(ParameterHelpers::EnableNoteQuantizationId) > 0.5f,
-        static_cast<NoteUtils::RootNote>(mProcessor->getParameterValue(ParameterHelpers::KeyRootNoteId)),
-        static_cast<NoteUtils::ScaleType>(mProcessor->getParameterValue(ParameterHelpers::KeyTypeId)),
-        static_cast<NoteUtils::SnapMode>(mProcessor->getParameterValue(ParameterHelpers::KeySnapModeId)),
-        static_cast<int>(mProcessor->getParameterValue(ParameterHelpers::MinMidiNoteId)),
-        static_cast<int>(mProcessor->getParameterValue(ParameterHelpers::MaxMidiNoteId)));
+        _setBasicPitchParameters();
 
-    auto post_processed_notes = mNoteOptions.process(mBasicPitch.getNoteEvents());
+        // Each channel is an independent stream: run channels 1 and up on the channel pool, channel 0 here.
+        std::atomic<int> num_channels_remaining = mNumTranscribedChannels - 1;
+        WaitableEvent channels_done;
 
-    mTimeQuantizeOptions.setParameters(
-        mProcessor->getParameterValue(ParameterHelpers::EnableTimeQuantizationId) > 0.5f,
-        static_cast<TimeQuantizeUtils::TimeDivisions>(mProcessor->getParameterValue(ParameterHelpers::TimeDivisionId)),
-        mProcessor->getParameterValue(ParameterHelpers::QuantizationForceId));
+        for (int ch = 1; ch < mNumTranscribedChannels; ch++) {
+            mChannelThreadPool->addJob(this, [&, ch] {
+                _getChannelBasicPitch(ch).transcribeToMIDI(const_cast<float*>(source_audio.getReadPointer(ch)),
+                                                           num_samples);
+
+                if (--num_channels_remaining == 0) {
+                    channels_done.signal();
+                }
+            });
+        }
+
+        mBasicPitch.transcribeToMIDI(const_cast<float*>(source_audio.getReadPointer(0)), num_samples);
+        channels_done.wait();
+    } else {
+        mNumTranscribedChannels = 1;
+        _setBasicPitchParameters();
+
+        if (source_audio.getNumChannels() > 1) {
+            AudioUtils::downmixToMono(source_audio, mMonoDownmixBuffer);
+            mBasicPitch.transcribeToMIDI(mMonoDownmixBuffer.getWritePointer(0), num_samples);
+            mMonoDownmixBuffer = {};
+        } else {
+            mBasicPitch.transcribeToMIDI(const_cast<float*>(source_audio.getReadPointer(0)), num_samples);
+        }
+    }
 
-    mPostProcessedNotes = mTimeQuantizeOptions.quantize(post_processed_notes);
+    source_audio_buffer.reset();
+    source_audio_manager->releaseUnusedAudio();
 
-    Notes::dropOverlappingPitchBends(mPostProcessedNotes);
-    Notes::mergeOverlappingNotesWithSamePitch(mPostProcessedNotes);
+    mPostProcessedNotes = _postProcessAllChannels(mPostProcessedNotesPerChannel);
+    mLastNoteEventsDiff = {};
 
     // For the synth
     auto single_events = SynthController::buildMidiEventsVector(mPostProcessedNotes);
     mProcessor->getPlayer()->getSynthController()->setNewMidiEventsVectorToUse(single_events);
 
+    _updateResourceStats();
+
     mProcessor->setStateToPopulatedAudioAndMidiRegions();
 }
 
@@ -149,12 +236,14 @@ void TranscriptionManager::_updateTranscription()
     jassert(mProcessor->getState() == PopulatedAudioAndMidiRegions);
 
     if (mProcessor->getState() == PopulatedAudioAndMidiRegions) {
-        mBasicPitch.setParameters(mProcessor->getParameterValue(ParameterHelpers::NoteSensitivityId),
-                                  mProcessor->getParameterValue(ParameterHelpers::SplitSensitivityId),
-                                  mProcessor->getParameterValue(ParameterHelpers::MinimumNoteDurationId));
+        _setBasicPitchParameters();
+
+        for (int ch = 0; ch < mNumTranscribedChannels; ch++) {
+            _getChannelBasicPitch(ch).updateMIDI();
+        }
 
-        mBasicPitch.updateMIDI();
         _updatePostProcessing();
+        _updateResourceStats();
     }
 
     mShouldUpdateTranscription = false;
@@ -166,32 +255,22 @@ void TranscriptionManager::_updatePostProcessing()
     jassert(mProcessor->getState() == PopulatedAudioAndMidiRegions);
 
     if (mProcessor->getState() == PopulatedAudioAndMidiRegions) {
-        mNoteOptions.setParameters(
-            mProcessor->getParameterValue(ParameterHelpers::EnableNoteQuantizationId) > 0.5f,
-            static_cast<NoteUtils::RootNote>(mProcessor->getParameterValue(ParameterHelpers::KeyRootNoteId)),
-            static_cast<NoteUtils::ScaleType>(mProcessor->getParameterValue(ParameterHelpers::KeyTypeId)),
-            static_cast<NoteUtils::SnapMode>(mProcessor->getParameterValue(ParameterHelpers::KeySnapModeId)),
-            static_cast<int>(mProcessor->getParameterValue(ParameterHelpers::MinMidiNoteId)),
-            static_cast<int>(mProcessor->getParameterValue(ParameterHelpers::MaxMidiNoteId)));
-
-        // TODO: Make this vector a member to avoid reallocating every time
-        auto post_processed_notes = mNoteOptions.process(mBasicPitch.getNoteEvents());
+        std::vector<std::vector<Notes::Event>> new_notes_per_channel;
+        auto new_notes = _postProcessAllChannels(new_notes_per_channel);
 
-        mTimeQuantizeOptions.setParameters(mProcessor->getParameterValue(ParameterHelpers::EnableTimeQuantizationId)
-                                               > 0.5f,
-                                           static_cast<TimeQuantizeUtils::TimeDivisions>(
-                                               mProcessor->getParameterValue(ParameterHelpers::TimeDivisionId)),
-                                           mProcessor->getParameterValue(ParameterHelpers::QuantizationForceId));
+        mLastNoteEventsDiff = Notes::computeEventsDiff(mPostProcessedNotes, new_notes);
+        mPostProcessedNotes = std::move(new_notes);
+        mPostProcessedNotesPerChannel = std::move(new_notes_per_channel);
 
-        // TODO: Pass mPostProcessedNotes as reference
-        mPostProcessedNotes = mTimeQuantizeOptions.quantize(post_processed_notes);
+        // For the synth: nothing to do if no note changed, patch the events for a few changes, swap otherwise.
+        auto* synth_controller = mProcessor->getPlayer()->getSynthController();
 
-        Notes::dropOverlappingPitchBends(mPostProcessedNotes);
-        Notes::mergeOverlappingNotesWithSamePitch(mPostProcessedNotes);
-
-        // For the synth
-        auto single_events = SynthController::buildMidiEventsVector(mPostProcessedNotes);
-        mProcessor->getPlayer()->getSynthController()->setNewMidiEventsVectorToUse(single_events);
+        if (SynthController::shouldPatchWithDiff(mLastNoteEventsDiff, mPostProcessedNotes.size())) {
+            synth_controller->applyNoteEventsDiff(mLastNoteEventsDiff);
+        } else if (!mLastNoteEventsDiff.isEmpty()) {
+            auto single_events = SynthController::buildMidiEventsVector(mPostProcessedNotes);
+            synth_controller->setNewMidiEventsVectorToUse(single_events);
+        }
     }
 
     mShouldUpdatePostProcessing = false;
@@ -207,28 +286,163 @@ const std::vector<Notes::Event>& TranscriptionManager::getNoteEventVector() cons
     return mPostProcessedNotes;
 }
 
+const std::vector<std::vector<Notes::Event>>& TranscriptionManager::getNoteEventsPerChannel() const
+{
+    return mPostProcessedNotesPerChannel;
+}
+
 TimeQuantizeOptions& TranscriptionManager::getTimeQuantizeOptions()
 {
     return mTimeQuantizeOptions;
 }
 
+BasicPitch::Posteriorgrams TranscriptionManager::getPosteriorgrams() const
+{
+    jassert(!isJobRunningOrQueued());
+    return mBasicPitch.getPosteriorgrams();
+}
+
+TranscriptionManager::PostProcessing TranscriptionManager::createPostProcessing() const
+{
+    PostProcessing post_processing;
+
+    post_processing.noteOptions.setParameters(
+        mProcessor->getParameterValue(ParameterHelpers::EnableNoteQuantizationId) > 0.5f,
+        static_cast<NoteUtils::RootNote>(mProcessor->getParameterValue(ParameterHelpers::KeyRootNoteId)),
+        static_cast<NoteUtils::ScaleType>(mProcessor->getParameterValue(ParameterHelpers::KeyTypeId)),
+        static_cast<NoteUtils::SnapMode>(mProcessor->getParameterValue(ParameterHelpers::KeySnapModeId)),
+        static_cast<int>(mProcessor->getParameterValue(ParameterHelpers::MinMidiNoteId)),
+        static_cast<int>(mProcessor->getParameterValue(ParameterHelpers::MaxMidiNoteId)));
+
+    post_processing.timeQuantizer.setParameters(
+        mProcessor->getParameterValue(ParameterHelpers::EnableTimeQuantizationId) > 0.5f,
+        static_cast<TimeQuantizeUtils::TimeDivisions>(mProcessor->getParameterValue(ParameterHelpers::TimeDivisionId)),
+        mProcessor->getParameterValue(ParameterHelpers::QuantizationForceId));
+    post_processing.timeQuantizer.setInfo(mTimeQuantizeOptions.getTimeQuantizeInfo());
+
+    return post_processing;
+}
+
+std::vector<Notes::Event>
+    TranscriptionManager::PostProcessing::process(const std::vector<Notes::Event>& inNoteEvents)
+{
+    auto post_processed_notes = noteOptions.process(inNoteEvents);
+    auto quantized_notes = timeQuantizer.process(post_processed_notes);
+
+    Notes::dropOverlappingPitchBends(quantized_notes);
+    Notes::mergeOverlappingNotesWithSamePitch(quantized_notes);
+
+    return quantized_notes;
+}
+
+std::vector<Notes::Event>
+    TranscriptionManager::_postProcessAllChannels(std::vector<std::vector<Notes::Event>>& outNotesPerChannel)
+{
+    outNotesPerChannel.resize(static_cast<size_t>(mNumTranscribedChannels));
+    auto post_processing = createPostProcessing();
+
+    // Channels are post-processed separately so notes of different channels are never merged together
+    for (int ch = 0; ch < mNumTranscribedChannels; ch++) {
+        outNotesPerChannel[static_cast<size_t>(ch)] =
+            post_processing.process(_getChannelBasicPitch(ch).getNoteEvents());
+    }
+
+    if (mNumTranscribedChannels == 1) {
+        return outNotesPerChannel[0];
+    }
+
+    std::vector<Notes::Event> all_notes;
+
+    for (const auto& channel_notes: outNotesPerChannel) {
+        all_notes.insert(all_notes.end(), channel_notes.begin(), channel_notes.end());
+    }
+
+    return all_notes;
+}
+
+BasicPitch& TranscriptionManager::_getChannelBasicPitch(int inChannel)
+{
+    jassert(inChannel >= 0 && inChannel < mNumTranscribedChannels);
+    return inChannel == 0 ? mBasicPitch : *mChannelBasicPitch[static_cast<size_t>(inChannel - 1)];
+}
+
+void TranscriptionManager::_setBasicPitchParameters()
+{
+    const bool compute_pitch_bends = _shouldComputePitchBends();
+
+    // Like the other key options, the note range only applies when they are enabled
+    const bool is_note_range_enabled = mProcessor->getParameterValue(ParameterHelpers::EnableNoteQuantizationId) > 0.5f;
+    const auto min_midi_note = is_note_range_enabled
+                                   ? static_cast<int>(mProcessor->getParameterValue(ParameterHelpers::MinMidiNoteId))
+                                   : MIDI_OFFSET;
+    const auto max_midi_note = is_note_range_enabled
+                                   ? static_cast<int>(mProcessor->getParameterValue(ParameterHelpers::MaxMidiNoteId))
+                                   : MIDI_OFFSET + MAX_NOTE_IDX;
+
+    for (int ch = 0; ch < mNumTranscribedChannels; ch++) {
+        _getChannelBasicPitch(ch).setMidiNoteRange(min_midi_note, max_midi_note);
+        _getChannelBasicPitch(ch).setParameters(mProcessor->getParameterValue(ParameterHelpers::NoteSensitivityId),
+                                                mProcessor->getParameterValue(ParameterHelpers::SplitSensitivityId),
+                                                mProcessor->getParameterValue(ParameterHelpers::MinimumNoteDurationId),
+                                                compute_pitch_bends);
+    }
+
+    mArePitchBendsComputed = compute_pitch_bends;
+}
+
+bool TranscriptionManager::_shouldComputePitchBends() const
+{
+    const auto pitch_bend_mode = static_cast<PitchBendModes>(
+        static_cast<int>(std::round(mProcessor->getParameterValue(ParameterHelpers::PitchBendModeId))));
+
+    if (pitch_bend_mode != NoPitchBend) {
+        return true;
+    }
+
+    return mProcessor->getParameterValue(ParameterHelpers::EnableNoteQuantizationId) > 0.5f
+           && static_cast<NoteUtils::ScaleType>(mProcessor->getParameterValue(ParameterHelpers::KeyTypeId))
+                  != NoteUtils::Chromatic
+           && static_cast<NoteUtils::SnapMode>(mProcessor->getParameterValue(ParameterHelpers::KeySnapModeId))
+                  == NoteUtils::Adjust;
+}
+
 void TranscriptionManager::clear()
 {
+    // Called on the message thread, e.g. for too short a recording, maybe while the warm-up still runs the models on
+    // the job thread: stop it (it returns at the next CNN frame) and wait for it before resetting them.
+    mShouldStopWarmUp = true;
+    mWarmUpDone.wait();
+
     mBasicPitch.reset();
+
+    for (auto& channel_basic_pitch: mChannelBasicPitch) {
+        channel_basic_pitch->reset();
+    }
+
+    mNumTranscribedChannels = 1;
+    mPostProcessedNotesPerChannel.clear();
     mShouldRunNewTranscription = false;
     mShouldUpdateTranscription = false;
     mShouldUpdatePostProcessing = false;
     mPostProcessedNotes.clear();
+    mLastNoteEventsDiff = {};
+    mCachedPosteriorgrams.reset();
     mTimeQuantizeOptions.clear();
+
+    _updateResourceStats();
 }
 
-void TranscriptionManager::launchTranscribeJob()
+void TranscriptionManager::launchTranscribeJob(
+    std::shared_ptr<const BasicPitch::Posteriorgrams> inCachedPosteriorgrams)
 {
     jassert(MessageManager::getInstance()->isThisTheMessageThread());
     mProcessor->setStateToProcessing();
 
     // Have at least one second to transcribe
     if (mProcessor->getSourceAudioManager()->getNumSamplesDownAcquired() >= 1 * AUDIO_SAMPLE_RATE) {
+        mCachedPosteriorgrams = std::move(inCachedPosteriorgrams);
+        mShouldTranscribePerChannel =
+            static_cast<bool>(mProcessor->getValueTree().getProperty(NnId::TranscribePerChannelId, false));
         mThreadPool.addJob(mJobLambda);
     } else {
         mProcessor->clear();
@@ -249,3 +463,38 @@ void TranscriptionManager::_repaintPianoRoll()
 
     mShouldRepaintPianoRoll = false;
 }
+
+void TranscriptionManager::_repaintPianoRollChanges()
+{
+    if (mShouldRepaintPianoRoll) {
+        _repaintPianoRoll();
+        return;
+    }
+
+    auto* main_view = mProcessor->getNeuralNoteMainView();
+
+    if (main_view && !mLastNoteEventsDiff.isEmpty()) {
+        main_view->repaintPianoRoll(mLastNoteEventsDiff);
+    }
+}
+
+void TranscriptionManager::_updateResourceStats()
+{
+    size_t posteriorgrams_bytes = mBasicPitch.getPosteriorgramsSizeInBytes();
+    size_t notes_bytes =
+        mBasicPitch.getNotesScratchSizeInBytes() + ResourceStats::getAllocatedBytes(mPostProcessedNotes);
+
+    // Including the idle channel models, which keep their last posteriorgrams until reset
+    for (const auto& channel_basic_pitch: mChannelBasicPitch) {
+        posteriorgrams_bytes += channel_basic_pitch->getPosteriorgramsSizeInBytes();
+        notes_bytes += channel_basic_pitch->getNotesScratchSizeInBytes();
+    }
+
+    for (const auto& channel_notes: mPostProcessedNotesPerChannel) {
+        notes_bytes += ResourceStats::getAllocatedBytes(channel_notes);
+    }
+
+    auto& stats = mProcessor->getResourceStats();
+    stats.setBytes(ResourceStats::Memory::Posteriorgrams, posteriorgrams_bytes);
+    stats.setBytes(ResourceStats::Memory::NotesScratch, notes_bytes);
+}
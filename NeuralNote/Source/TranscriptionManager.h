@@ -8,20 +8,26 @@
 #include <JuceHeader.h>
 #include "BasicPitch.h"
 #include "NoteOptions.h"
+#include "SharedThreadPool.h"
 #include "TimeQuantizeOptions.h"
+#include "TimeQuantizer.h"
 
 class NeuralNoteAudioProcessor;
 class NeuralNoteMainView;
 class NeuralNoteEditor;
 
+/**
+ * Runs the transcription jobs and applies the parameter changes to the note events. Changes are posted as an async
+ * update handled on the message thread, so an idle instance does not run any callback.
+ */
 class TranscriptionManager
-    : public Timer
-    , public AudioProcessorValueTreeState::Listener
+    : public AudioProcessorValueTreeState::Listener
+    , private AsyncUpdater
 {
 public:
     explicit TranscriptionManager(NeuralNoteAudioProcessor* inProcessor);
 
-    void timerCallback() override;
+    ~TranscriptionManager() override;
 
     void prepareToPlay(double inSampleRate);
 
@@ -29,39 +35,131 @@ public:
 
     void setLaunchNewTranscription();
 
-    void launchTranscribeJob();
+    /**
+     * Launch the transcription of the source audio.
+     * @param inCachedPosteriorgrams Posteriorgrams already computed for the source audio (e.g. by the batch queue).
+     * If given, the CNN is not run again and only the note events are recomputed.
+     */
+    void launchTranscribeJob(std::shared_ptr<const BasicPitch::Posteriorgrams> inCachedPosteriorgrams = nullptr);
 
     void parameterChanged(const juce::String& parameterID, float newValue) override;
 
     bool isJobRunningOrQueued() const;
 
+    /**
+     * @return Post-processed note events of all transcribed channels.
+     */
     const std::vector<Notes::Event>& getNoteEventVector() const;
 
+    /**
+     * @return Post-processed note events of each transcribed channel. A single vector unless the source audio has
+     * several channels and transcribing channels separately is enabled.
+     */
+    const std::vector<std::vector<Notes::Event>>& getNoteEventsPerChannel() const;
+
     TimeQuantizeOptions& getTimeQuantizeOptions();
 
+    /**
+     * @return Copy of the posteriorgrams of the last transcription (of the first channel when transcribing channels
+     * separately).
+     */
+    BasicPitch::Posteriorgrams getPosteriorgrams() const;
+
+    /**
+     * Note and time quantization applied to the raw note events. A copy of the parameters, so that it can be used on
+     * any thread while they change.
+     */
+    struct PostProcessing {
+        NoteOptions noteOptions;
+        TimeQuantizer timeQuantizer;
+
+        /**
+         * @param inNoteEvents Note events from BasicPitch
+         * @return Post-processed note events
+         */
+        std::vector<Notes::Event> process(const std::vector<Notes::Event>& inNoteEvents);
+    };
+
+    /**
+     * @return Post-processing with the current parameters, as done for the displayed notes.
+     */
+    PostProcessing createPostProcessing() const;
+
     void clear();
 
 private:
+    void handleAsyncUpdate() override;
+
     void _runModel();
 
     void _updateTranscription();
 
     void _updatePostProcessing();
 
+    /**
+     * Post-process the note events of every transcribed channel.
+     * @param outNotesPerChannel Post-processed note events per channel
+     * @return Concatenation of outNotesPerChannel
+     */
+    std::vector<Notes::Event> _postProcessAllChannels(std::vector<std::vector<Notes::Event>>& outNotesPerChannel);
+
+    BasicPitch& _getChannelBasicPitch(int inChannel);
+
+    void _setBasicPitchParameters();
+
+    /**
+     * @return True if something uses the pitch bends of the note events with the current parameters: the piano roll
+     * and the MIDI export in single pitch bend mode, and the key snapping in adjust mode to choose the direction.
+     */
+    bool _shouldComputePitchBends() const;
+
+    /**
+     * Report the memory held by the posteriorgrams and the note events to the instance statistics.
+     */
+    void _updateResourceStats();
+
     void _repaintPianoRoll();
 
+    /**
+     * Repaint only the areas of the piano roll affected by the last post-processing update, or everything if a full
+     * repaint was requested meanwhile.
+     */
+    void _repaintPianoRollChanges();
+
     NeuralNoteAudioProcessor* mProcessor;
 
+    // Transcribes channel 0 (or the mono downmix)
     BasicPitch mBasicPitch;
-    NoteOptions mNoteOptions;
+    // Transcribe channels 1 and up when transcribing channels separately. Each has its own CNN state.
+    std::vector<std::unique_ptr<BasicPitch>> mChannelBasicPitch;
+    static constexpr int mMaxNumTranscribedChannels = 8;
+    int mNumTranscribedChannels = 1;
+    // Read on the message thread when the job is launched
+    bool mShouldTranscribePerChannel = false;
+    AudioBuffer<float> mMonoDownmixBuffer;
     TimeQuantizeOptions mTimeQuantizeOptions;
 
     std::vector<Notes::Event> mPostProcessedNotes;
+    std::vector<std::vector<Notes::Event>> mPostProcessedNotesPerChannel;
+    // Changes made to mPostProcessedNotes by the last post-processing update
+    Notes::EventsDiff mLastNoteEventsDiff;
 
     std::atomic<bool> mShouldRunNewTranscription = false;
     std::atomic<bool> mShouldUpdateTranscription = false;
     std::atomic<bool> mShouldUpdatePostProcessing = false;
     std::atomic<bool> mShouldRepaintPianoRoll = false;
+    std::atomic<bool> mShouldStopWarmUp = false;
+    // Signaled once the warm-up job is done, or right away if there is none
+    WaitableEvent mWarmUpDone {true};
+    // Whether the current note events of BasicPitch have their pitch bends
+    std::atomic<bool> mArePitchBendsComputed = false;
+
+    // Posteriorgrams to use for the next transcription job instead of running the CNN
+    std::shared_ptr<const BasicPitch::Posteriorgrams> mCachedPosteriorgrams;
+
+    // Runs the channels other than channel 0 while the transcription job runs channel 0. Shared by the instances and
+    // only started once something runs on it, so that instances never transcribing channels separately cost nothing.
+    SharedResourcePointer<SharedThreadPool> mChannelThreadPool;
 
     ThreadPool mThreadPool;
     std::function<void()> mJobLambda;
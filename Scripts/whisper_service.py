@@ -11,22 +11,27 @@ The service runs locally and provides endpoints for:
 - Language detection
 - Model info
 
+Concurrent /transcribe requests are queued and grouped into batches so that
+several clients (e.g. multiple plugin instances) share a single pipeline call
+instead of serializing on it.
+
 Usage:
     python Scripts/whisper_service.py --port 8765 --model openai/whisper-large-v3-turbo
 """
 
 import argparse
-import json
 import logging
+import os
+import queue
+import socket
+import stat
 import sys
-import tempfile
-from pathlib import Path
+import threading
+import time
 from typing import Dict, List, Optional
 
 import numpy as np
-import torch
 from flask import Flask, jsonify, request
-from transformers import AutoModelForSpeechSeq2Seq, AutoProcessor, pipeline
 
 # Configure logging
 logging.basicConfig(
@@ -39,13 +44,178 @@ app = Flask(__name__)
 
 # Global state
 whisper_pipeline = None
+# The Hugging Face pipeline is not thread-safe: calls from the workers are serialized
+pipeline_lock = threading.Lock()
 model_info = {}
+request_queue = None
+
+
+class TranscriptionJob:
+    """A single /transcribe request waiting for its batch to be processed."""
+
+    def __init__(self, audio: np.ndarray, generate_kwargs: Dict):
+        self.audio = audio
+        self.generate_kwargs = generate_kwargs
+        self.result = None
+        self.error = None
+        self.done = threading.Event()
+
+    def batch_key(self):
+        """Requests can only share a pipeline call if their generation options match."""
+        return tuple(sorted(self.generate_kwargs.items()))
+
+
+class BatchingRequestQueue:
+    """
+    Collects incoming transcription jobs and runs them through the pipeline in batches.
+
+    Each worker blocks on the queue for a first job, then keeps collecting jobs for at
+    most `max_wait_ms` or until `batch_size` jobs are gathered. Jobs with different
+    generation options (language, task) are split into separate pipeline calls.
+    """
+
+    def __init__(self, batch_size: int, max_wait_ms: float, num_workers: int):
+        self.batch_size = max(1, batch_size)
+        self.max_wait_s = max(0.0, max_wait_ms) / 1000.0
+        self._queue = queue.Queue()
+        self._lock = threading.Lock()
+        self._in_flight = 0
+        self._workers = [
+            threading.Thread(target=self._worker_loop, name=f"whisper-worker-{i}", daemon=True)
+            for i in range(max(1, num_workers))
+        ]
+
+        for worker in self._workers:
+            worker.start()
+
+    @property
+    def num_workers(self) -> int:
+        return len(self._workers)
+
+    def depth(self) -> int:
+        """Number of jobs waiting in the queue or currently being processed."""
+        with self._lock:
+            return self._queue.qsize() + self._in_flight
+
+    def submit(self, job: TranscriptionJob) -> TranscriptionJob:
+        self._queue.put(job)
+        return job
+
+    def _collect_batch(self) -> List[TranscriptionJob]:
+        batch = [self._queue.get()]
+        deadline = time.monotonic() + self.max_wait_s
+
+        while len(batch) < self.batch_size:
+            remaining = deadline - time.monotonic()
+            if remaining <= 0:
+                break
+            try:
+                batch.append(self._queue.get(timeout=remaining))
+            except queue.Empty:
+                break
+
+        with self._lock:
+            self._in_flight += len(batch)
+
+        return batch
+
+    def _worker_loop(self):
+        while True:
+            batch = self._collect_batch()
+
+            groups: Dict[tuple, List[TranscriptionJob]] = {}
+            for job in batch:
+                groups.setdefault(job.batch_key(), []).append(job)
+
+            for jobs in groups.values():
+                self._run_jobs(jobs)
+
+            with self._lock:
+                self._in_flight -= len(batch)
+
+    @staticmethod
+    def _call_pipeline(jobs: List[TranscriptionJob]) -> list:
+        sample_rate = model_info.get('sample_rate', 16000)
+        inputs = [{"array": job.audio, "sampling_rate": sample_rate} for job in jobs]
+
+        with pipeline_lock:
+            return whisper_pipeline(
+                inputs,
+                batch_size=len(inputs),
+                generate_kwargs=dict(jobs[0].generate_kwargs)
+            )
+
+    @classmethod
+    def _run_jobs(cls, jobs: List[TranscriptionJob]):
+        try:
+            start = time.monotonic()
+            results = cls._call_pipeline(jobs)
+            logger.info(f"Processed batch of {len(jobs)} request(s) in {time.monotonic() - start:.2f}s")
+
+            for job, result in zip(jobs, results):
+                job.result = result
+        except Exception as e:
+            if len(jobs) == 1:
+                logger.error(f"Transcription failed: {e}", exc_info=True)
+                jobs[0].error = str(e)
+            else:
+                # One bad request must not fail the ones batched with it: run them one by one
+                logger.warning(f"Batch of {len(jobs)} request(s) failed, retrying them separately: {e}")
+                for job in jobs:
+                    cls._run_jobs([job])
+                return
+
+        for job in jobs:
+            job.done.set()
+
+
+class StubPipeline:
+    """
+    Stand-in for the Hugging Face pipeline, used for load testing the service and its
+    clients without downloading a model. Returns one word per second of audio.
+    """
+
+    def __init__(self, sample_rate: int, latency_ms: float):
+        self.sample_rate = sample_rate
+        self.latency_s = latency_ms / 1000.0
+
+    def __call__(self, inputs, batch_size: int = 1, generate_kwargs: Optional[Dict] = None):
+        # Simulate a pipeline call whose cost grows sub-linearly with the batch size
+        time.sleep(self.latency_s * (1.0 + 0.1 * (len(inputs) - 1)))
+
+        results = []
+        for item in inputs:
+            duration = len(item["array"]) / self.sample_rate
+            chunks = [{"text": f" word{i}", "timestamp": (float(i), float(min(i + 1, duration)))}
+                      for i in range(int(duration))]
+            results.append({"text": "".join(c["text"] for c in chunks), "chunks": chunks})
+
+        return results
+
+
+def initialize_stub_model(latency_ms: float) -> None:
+    """Initialize the stub pipeline (no torch/transformers required)."""
+    global whisper_pipeline, model_info
+
+    logger.info(f"Initializing stub pipeline with {latency_ms} ms simulated latency")
+
+    whisper_pipeline = StubPipeline(16000, latency_ms)
+    model_info = {
+        "model_id": "stub",
+        "device": "cpu",
+        "dtype": "none",
+        "sample_rate": 16000
+    }
 
 
 def initialize_model(model_id: str, device: str = "auto", model_dir: Optional[str] = None) -> None:
     """Initialize the Whisper model and pipeline."""
     global whisper_pipeline, model_info
 
+    # Imported here so that the stub mode can run without torch and transformers installed
+    import torch
+    from transformers import AutoModelForSpeechSeq2Seq, AutoProcessor, pipeline
+
     logger.info(f"Initializing Whisper model: {model_id}")
     if model_dir:
         logger.info(f"Using model directory: {model_dir}")
@@ -112,7 +282,10 @@ def health_check():
 
     return jsonify({
         "status": "healthy",
-        "model": model_info
+        "model": model_info,
+        "queue_depth": request_queue.depth(),
+        "batch_size": request_queue.batch_size,
+        "num_workers": request_queue.num_workers
     })
 
 
@@ -164,13 +337,17 @@ def transcribe_audio():
         if 'language' in data and data['language']:
             generate_kwargs['language'] = data['language']
 
-        # Run transcription
-        logger.info(f"Transcribing audio: {len(audio_array)} samples, language={generate_kwargs.get('language', 'auto')}")
+        # Queue the request, it will be transcribed together with other pending requests
+        logger.info(f"Queueing audio: {len(audio_array)} samples, language={generate_kwargs.get('language', 'auto')}, "
+                    f"queue depth={request_queue.depth()}")
 
-        result = whisper_pipeline(
-            {"array": audio_array, "sampling_rate": expected_sr},
-            generate_kwargs=generate_kwargs
-        )
+        job = request_queue.submit(TranscriptionJob(audio_array, generate_kwargs))
+        job.done.wait()
+
+        if job.error is not None:
+            return jsonify({"error": job.error}), 500
+
+        result = job.result
 
         # Extract word-level timestamps
         words = []
@@ -235,12 +412,50 @@ def parse_args():
         default='127.0.0.1',
         help='Host to bind to (default: 127.0.0.1)'
     )
+    parser.add_argument(
+        '--unix-socket',
+        type=str,
+        nargs='?',
+        const='',
+        default=None,
+        help='Also serve on a Unix domain socket (default path: neuralnote-whisper.sock in $XDG_RUNTIME_DIR on Linux, '
+             '$TMPDIR on macOS, where NeuralNote looks for it). Not available on Windows.'
+    )
     parser.add_argument(
         '--device',
         type=str,
         default='auto',
         help='Device to use: auto, cpu, cuda:0, etc. (default: auto)'
     )
+    parser.add_argument(
+        '--batch-size',
+        type=int,
+        default=4,
+        help='Maximum number of queued requests transcribed in a single pipeline call (default: 4)'
+    )
+    parser.add_argument(
+        '--batch-timeout-ms',
+        type=float,
+        default=50.0,
+        help='How long a worker waits for more requests before running a partial batch (default: 50)'
+    )
+    parser.add_argument(
+        '--workers',
+        type=int,
+        default=1,
+        help='Number of worker threads collecting and running batches, pipeline calls are serialized (default: 1)'
+    )
+    parser.add_argument(
+        '--stub',
+        action='store_true',
+        help='Use a stub pipeline instead of a real model (for load testing, no torch required)'
+    )
+    parser.add_argument(
+        '--stub-latency-ms',
+        type=float,
+        default=200.0,
+        help='Simulated latency of a stub pipeline call in milliseconds (default: 200)'
+    )
     parser.add_argument(
         '--list-models',
         action='store_true',
@@ -287,6 +502,50 @@ def list_available_models():
     print()
 
 
+def default_socket_path() -> str:
+    """Socket path in the per-user runtime directory, so that other users cannot create or reach it."""
+    runtime_dir = os.environ.get("XDG_RUNTIME_DIR") if sys.platform.startswith("linux") else None
+
+    if sys.platform == "darwin":
+        runtime_dir = os.environ.get("TMPDIR")
+
+    if not runtime_dir or not os.path.isabs(runtime_dir):
+        raise RuntimeError("No per-user runtime directory ($XDG_RUNTIME_DIR or $TMPDIR), give a socket path")
+
+    return os.path.join(runtime_dir, "neuralnote-whisper.sock")
+
+
+def start_unix_socket_server(socket_path: str) -> None:
+    """Serve the same endpoints on a Unix domain socket, in a background thread."""
+    from werkzeug.serving import make_server
+
+    if not hasattr(socket, "AF_UNIX"):
+        raise RuntimeError("Unix domain sockets are not supported on this platform")
+
+    if not socket_path:
+        socket_path = default_socket_path()
+
+    # Remove a socket left over by a previous run of ours, but never a regular file or another user's socket
+    if os.path.lexists(socket_path):
+        socket_stat = os.lstat(socket_path)
+        if not stat.S_ISSOCK(socket_stat.st_mode):
+            raise RuntimeError(f"{socket_path} exists and is not a socket")
+        if socket_stat.st_uid != os.getuid():
+            raise RuntimeError(f"{socket_path} is owned by another user")
+        os.unlink(socket_path)
+
+    # Only the current user can connect
+    previous_umask = os.umask(0o177)
+    try:
+        server = make_server(f"unix://{socket_path}", 0, app, threaded=True)
+    finally:
+        os.umask(previous_umask)
+
+    threading.Thread(target=server.serve_forever, name="unix-socket-server", daemon=True).start()
+
+    logger.info(f"Serving on Unix socket {socket_path}")
+
+
 def main():
     args = parse_args()
 
@@ -298,13 +557,29 @@ def main():
     logger.info("NeuralNote Whisper Transcription Service")
     logger.info("=" * 60)
 
+    global request_queue
+
     # Initialize model
     try:
-        initialize_model(args.model, args.device, args.model_dir)
+        if args.stub:
+            initialize_stub_model(args.stub_latency_ms)
+        else:
+            initialize_model(args.model, args.device, args.model_dir)
     except Exception as e:
         logger.error(f"Failed to initialize: {e}")
         sys.exit(1)
 
+    request_queue = BatchingRequestQueue(args.batch_size, args.batch_timeout_ms, args.workers)
+    logger.info(f"Request batching: batch size {request_queue.batch_size}, "
+                f"timeout {args.batch_timeout_ms} ms, {request_queue.num_workers} worker(s)")
+
+    if args.unix_socket is not None:
+        try:
+            start_unix_socket_server(args.unix_socket)
+        except Exception as e:
+            logger.error(f"Failed to start Unix socket server: {e}")
+            sys.exit(1)
+
     # Run service
     logger.info(f"Starting service on {args.host}:{args.port}")
     logger.info("Press Ctrl+C to stop")
@@ -0,0 +1,404 @@
+#include <JuceHeader.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#include "AudioUtils.h"
+#include "BasicPitch.h"
+#include "NoteEvaluation.h"
+
+#if JUCE_WINDOWS
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+/*
+ * Runs the transcription over a directory of audio/MIDI pairs (same file name, .mid or .midi reference) and reports
+ * note-level F1 (mir_eval style), realtime factor and peak memory for one or two engine configurations.
+ *
+ * Usage:
+ *  NeuralNoteEvaluation <dataset_dir> [--config-a key=value,...] [--config-b key=value,...] [--report report.json]
+ *  NeuralNoteEvaluation --compare report_a.json report_b.json
+ *
+ * Configuration keys: name, note_sensitivity, split_sensitivity, min_note_duration_ms, posteriorgram_bits (32, 16 or
+ * 8: round the posteriorgrams to fp16 or uint8 before note creation, to preview reduced precision).
+ */
+
+namespace
+{
+struct EngineConfig {
+    String name = "default";
+    float noteSensitivity = 0.7f;
+    float splitSensitivity = 0.5f;
+    float minNoteDurationMs = 125.0f;
+    int posteriorgramBits = 32;
+};
+
+struct ConfigResult {
+    String name;
+    NoteEvaluation::Scores onset;
+    NoteEvaluation::Scores onsetOffset;
+    double audioSeconds = 0.0;
+    double processingSeconds = 0.0;
+    double peakMemoryMB = 0.0;
+    int numFiles = 0;
+
+    double getRealtimeFactor() const { return audioSeconds > 0.0 ? processingSeconds / audioSeconds : 0.0; }
+};
+
+double getPeakMemoryMB()
+{
+#if JUCE_WINDOWS
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return static_cast<double>(counters.PeakWorkingSetSize) / (1024.0 * 1024.0);
+    return 0.0;
+#else
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+#if JUCE_MAC
+    return static_cast<double>(usage.ru_maxrss) / (1024.0 * 1024.0); // Bytes
+#else
+    return static_cast<double>(usage.ru_maxrss) / 1024.0; // Kilobytes
+#endif
+#endif
+}
+
+bool parseConfig(const String& inDescription, EngineConfig& outConfig)
+{
+    for (const auto& entry: StringArray::fromTokens(inDescription, ",", "")) {
+        auto key = entry.upToFirstOccurrenceOf("=", false, false).trim();
+        auto value = entry.fromFirstOccurrenceOf("=", false, false).trim();
+
+        if (key == "name")
+            outConfig.name = value;
+        else if (key == "note_sensitivity")
+            outConfig.noteSensitivity = value.getFloatValue();
+        else if (key == "split_sensitivity")
+            outConfig.splitSensitivity = value.getFloatValue();
+        else if (key == "min_note_duration_ms")
+            outConfig.minNoteDurationMs = value.getFloatValue();
+        else if (key == "posteriorgram_bits" && (value == "32" || value == "16" || value == "8"))
+            outConfig.posteriorgramBits = value.getIntValue();
+        else {
+            std::cerr << "Unknown configuration entry: " << entry << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+float roundToHalfPrecision(float inValue)
+{
+    // Round the mantissa to the 11 significant bits of an IEEE half
+    int exponent;
+    auto mantissa = std::frexp(inValue, &exponent);
+    return std::ldexp(std::round(std::ldexp(mantissa, 11)), exponent - 11);
+}
+
+void reducePrecision(std::vector<std::vector<float>>& ioPosteriorgram, int inBits)
+{
+    for (auto& frame: ioPosteriorgram) {
+        for (auto& value: frame) {
+            value = inBits == 16 ? roundToHalfPrecision(value) : std::round(value * 255.0f) / 255.0f;
+        }
+    }
+}
+
+std::vector<NoteEvaluation::Note> loadReferenceNotes(const File& inMidiFile)
+{
+    std::vector<NoteEvaluation::Note> notes;
+
+    FileInputStream stream(inMidiFile);
+    MidiFile midi_file;
+
+    if (!stream.openedOk() || !midi_file.readFrom(stream)) {
+        return notes;
+    }
+
+    midi_file.convertTimestampTicksToSeconds();
+
+    for (int track = 0; track < midi_file.getNumTracks(); track++) {
+        MidiMessageSequence sequence(*midi_file.getTrack(track));
+        sequence.updateMatchedPairs();
+
+        for (auto* event: sequence) {
+            if (event->message.isNoteOn() && event->noteOffObject != nullptr) {
+                notes.push_back({event->message.getTimeStamp(),
+                                 event->noteOffObject->message.getTimeStamp(),
+                                 event->message.getNoteNumber()});
+            }
+        }
+    }
+
+    return notes;
+}
+
+bool loadAudioForTranscription(const File& inFile, AudioBuffer<float>& outAudio)
+{
+    AudioBuffer<float> source_audio;
+    double sample_rate;
+
+    if (!AudioUtils::loadAudioFile(inFile, source_audio, sample_rate)) {
+        return false;
+    }
+
+    AudioBuffer<float> downsampled_audio;
+    AudioUtils::resampleBuffer(source_audio, downsampled_audio, sample_rate, BASIC_PITCH_SAMPLE_RATE);
+    AudioUtils::downmixToMono(downsampled_audio, outAudio);
+
+    return true;
+}
+
+std::vector<std::pair<File, File>> findDatasetPairs(const File& inDirectory)
+{
+    std::vector<std::pair<File, File>> pairs;
+    auto extensions = AudioUtils::getSupportedAudioFileExtensions();
+
+    for (const auto& entry: RangedDirectoryIterator(inDirectory, true, "*", File::findFiles)) {
+        auto audio_file = entry.getFile();
+
+        if (!extensions.contains(audio_file.getFileExtension(), true)) {
+            continue;
+        }
+
+        for (const auto* midi_extension: {".mid", ".midi"}) {
+            auto midi_file = audio_file.withFileExtension(midi_extension);
+
+            if (midi_file.existsAsFile()) {
+                pairs.emplace_back(audio_file, midi_file);
+                break;
+            }
+        }
+    }
+
+    std::sort(pairs.begin(), pairs.end());
+
+    return pairs;
+}
+
+ConfigResult evaluateConfig(const EngineConfig& inConfig, const std::vector<std::pair<File, File>>& inPairs)
+{
+    ConfigResult result;
+    result.name = inConfig.name;
+
+    BasicPitch basic_pitch;
+
+    if (!basic_pitch.isInitialized()) {
+        std::cerr << "Model initialization failed: " << basic_pitch.getErrorMessage() << std::endl;
+        return result;
+    }
+
+    basic_pitch.setParameters(inConfig.noteSensitivity, inConfig.splitSensitivity, inConfig.minNoteDurationMs);
+
+    NoteEvaluation::MatchingParams onset_params;
+    onset_params.matchOffsets = false;
+    NoteEvaluation::MatchingParams onset_offset_params;
+
+    std::vector<NoteEvaluation::Scores> onset_scores;
+    std::vector<NoteEvaluation::Scores> onset_offset_scores;
+
+    for (const auto& [audio_file, midi_file]: inPairs) {
+        AudioBuffer<float> audio;
+
+        if (!loadAudioForTranscription(audio_file, audio)) {
+            std::cerr << "Could not load " << audio_file.getFullPathName() << std::endl;
+            continue;
+        }
+
+        auto start_time = std::chrono::steady_clock::now();
+
+        basic_pitch.transcribeToMIDI(audio.getWritePointer(0), audio.getNumSamples());
+
+        if (inConfig.posteriorgramBits < 32) {
+            auto posteriorgrams = basic_pitch.getPosteriorgrams();
+            reducePrecision(posteriorgrams.notes, inConfig.posteriorgramBits);
+            reducePrecision(posteriorgrams.onsets, inConfig.posteriorgramBits);
+            reducePrecision(posteriorgrams.contours, inConfig.posteriorgramBits);
+            basic_pitch.setPosteriorgrams(std::move(posteriorgrams));
+        }
+
+        std::chrono::duration<double> processing_duration = std::chrono::steady_clock::now() - start_time;
+
+        std::vector<NoteEvaluation::Note> estimated;
+
+        for (const auto& event: basic_pitch.getNoteEvents()) {
+            estimated.push_back({event.startTime, event.endTime, event.pitch});
+        }
+
+        auto reference = loadReferenceNotes(midi_file);
+
+        onset_scores.push_back(NoteEvaluation::computeScores(reference, estimated, onset_params));
+        onset_offset_scores.push_back(NoteEvaluation::computeScores(reference, estimated, onset_offset_params));
+
+        const double audio_seconds = audio.getNumSamples() / BASIC_PITCH_SAMPLE_RATE;
+        result.audioSeconds += audio_seconds;
+        result.processingSeconds += processing_duration.count();
+        result.numFiles++;
+
+        std::cout << "  " << audio_file.getFileName() << ": onset F1 " << String(onset_scores.back().f1, 3)
+                  << ", onset+offset F1 " << String(onset_offset_scores.back().f1, 3) << ", RTF "
+                  << String(processing_duration.count() / audio_seconds, 4) << std::endl;
+
+        basic_pitch.reset();
+    }
+
+    result.onset = NoteEvaluation::accumulateScores(onset_scores);
+    result.onsetOffset = NoteEvaluation::accumulateScores(onset_offset_scores);
+    // High-water mark of the process: includes the configurations evaluated before this one
+    result.peakMemoryMB = getPeakMemoryMB();
+
+    return result;
+}
+
+var resultToVar(const ConfigResult& inResult)
+{
+    auto* object = new DynamicObject();
+    object->setProperty("name", inResult.name);
+    object->setProperty("num_files", inResult.numFiles);
+    object->setProperty("onset_precision", inResult.onset.precision);
+    object->setProperty("onset_recall", inResult.onset.recall);
+    object->setProperty("onset_f1", inResult.onset.f1);
+    object->setProperty("onset_offset_precision", inResult.onsetOffset.precision);
+    object->setProperty("onset_offset_recall", inResult.onsetOffset.recall);
+    object->setProperty("onset_offset_f1", inResult.onsetOffset.f1);
+    object->setProperty("audio_seconds", inResult.audioSeconds);
+    object->setProperty("processing_seconds", inResult.processingSeconds);
+    object->setProperty("realtime_factor", inResult.getRealtimeFactor());
+    object->setProperty("peak_memory_mb", inResult.peakMemoryMB);
+    return var(object);
+}
+
+const StringArray comparedMetrics = {
+    "onset_f1", "onset_offset_f1", "onset_precision", "onset_recall", "realtime_factor", "peak_memory_mb"};
+
+void printResult(const var& inResult)
+{
+    std::cout << inResult["name"].toString() << " (" << static_cast<int>(inResult["num_files"]) << " files)"
+              << std::endl;
+
+    for (const auto& metric: comparedMetrics) {
+        std::cout << "  " << metric.paddedRight(' ', 20) << String(static_cast<double>(inResult[Identifier(metric)]), 4)
+                  << std::endl;
+    }
+}
+
+void printDeltas(const var& inResultA, const var& inResultB)
+{
+    std::cout << std::endl
+              << "Delta " << inResultB["name"].toString() << " - " << inResultA["name"].toString() << std::endl;
+
+    for (const auto& metric: comparedMetrics) {
+        auto a = static_cast<double>(inResultA[Identifier(metric)]);
+        auto b = static_cast<double>(inResultB[Identifier(metric)]);
+        std::cout << "  " << metric.paddedRight(' ', 20) << (b - a >= 0.0 ? "+" : "") << String(b - a, 4)
+                  << std::endl;
+    }
+}
+
+int compareReports(const File& inReportA, const File& inReportB)
+{
+    auto report_a = JSON::parse(inReportA);
+    auto report_b = JSON::parse(inReportB);
+
+    if (!report_a.isObject() || !report_b.isObject()) {
+        std::cerr << "Could not parse the reports" << std::endl;
+        return 1;
+    }
+
+    // Reports hold the results of their configurations in order, compare the first ones
+    auto result_a = report_a["results"][0];
+    auto result_b = report_b["results"][0];
+
+    printResult(result_a);
+    printResult(result_b);
+    printDeltas(result_a, result_b);
+
+    return 0;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    ScopedJuceInitialiser_GUI juce_initialiser;
+
+    StringArray args;
+    for (int i = 1; i < argc; i++)
+        args.add(argv[i]);
+
+    if (args.size() == 3 && args[0] == "--compare") {
+        return compareReports(File::getCurrentWorkingDirectory().getChildFile(args[1]),
+                              File::getCurrentWorkingDirectory().getChildFile(args[2]));
+    }
+
+    if (args.isEmpty() || args[0].startsWith("--")) {
+        std::cerr << "Usage: NeuralNoteEvaluation <dataset_dir> [--config-a key=value,...] "
+                     "[--config-b key=value,...] [--report report.json]"
+                  << std::endl
+                  << "       NeuralNoteEvaluation --compare report_a.json report_b.json" << std::endl;
+        return 1;
+    }
+
+    auto dataset_dir = File::getCurrentWorkingDirectory().getChildFile(args[0]);
+    std::vector<EngineConfig> configs;
+    File report_file;
+
+    for (int i = 1; i + 1 < args.size(); i += 2) {
+        if (args[i] == "--config-a" || args[i] == "--config-b") {
+            EngineConfig config;
+            config.name = args[i].getLastCharacters(1);
+
+            if (!parseConfig(args[i + 1], config))
+                return 1;
+
+            configs.push_back(config);
+        } else if (args[i] == "--report") {
+            report_file = File::getCurrentWorkingDirectory().getChildFile(args[i + 1]);
+        } else {
+            std::cerr << "Unknown argument: " << args[i] << std::endl;
+            return 1;
+        }
+    }
+
+    if (configs.empty())
+        configs.emplace_back();
+
+    auto pairs = findDatasetPairs(dataset_dir);
+
+    if (pairs.empty()) {
+        std::cerr << "No audio/MIDI pairs found in " << dataset_dir.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    Array<var> results;
+
+    for (const auto& config: configs) {
+        std::cout << "Evaluating " << config.name << " on " << pairs.size() << " files" << std::endl;
+        results.add(resultToVar(evaluateConfig(config, pairs)));
+    }
+
+    std::cout << std::endl;
+
+    for (const auto& result: results)
+        printResult(result);
+
+    if (results.size() == 2)
+        printDeltas(results[0], results[1]);
+
+    if (report_file != File()) {
+        auto* report = new DynamicObject();
+        report->setProperty("dataset", dataset_dir.getFullPathName());
+        report->setProperty("results", results);
+
+        if (!report_file.replaceWithText(JSON::toString(var(report)))) {
+            std::cerr << "Could not write " << report_file.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -7,6 +7,15 @@
 #include "cnn_test.h"
 #include "perf_test.h"
 #include "notes_test.h"
+#include "note_evaluation_test.h"
+#include "posteriorgram_io_test.h"
+#include "core_api_test.h"
+#include "async_logger_test.h"
+#include "resource_stats_test.h"
+#include "whisper_service_test.h"
+#include "derived_audio_buffers_test.h"
+#include "source_audio_cache_test.h"
+#include "worker_pool_test.h"
 
 int main()
 {
@@ -18,11 +27,65 @@ int main()
     std::cout << std::endl << "CNN TEST" << std::endl;
     result |= !cnn_test();
 
+    std::cout << std::endl << "CNN PARALLEL BRANCHES TEST" << std::endl;
+    result |= !cnn_parallel_branches_test();
+
+    std::cout << std::endl << "CNN STATE TEST" << std::endl;
+    result |= !cnn_state_test();
+
     std::cout << std::endl << "PERF TEST" << std::endl;
     result |= !perf_test();
 
     std::cout << std::endl << "NOTES TEST" << std::endl;
     result |= !notes_test();
 
+    std::cout << std::endl << "NOTES DIFF TEST" << std::endl;
+    result |= !notes_diff_test();
+
+    std::cout << std::endl << "NOTES PIPELINE TEST" << std::endl;
+    result |= !notes_pipeline_test();
+
+    std::cout << std::endl << "NOTES PITCH BENDS CACHE TEST" << std::endl;
+    result |= !notes_pitch_bends_cache_test();
+
+    std::cout << std::endl << "NOTES RANGE TEST" << std::endl;
+    result |= !notes_range_test();
+
+    std::cout << std::endl << "NOTES PARALLEL TEST" << std::endl;
+    result |= !notes_parallel_test();
+
+    std::cout << std::endl << "NOTE EVALUATION TEST" << std::endl;
+    result |= !note_evaluation_test();
+
+    std::cout << std::endl << "POSTERIORGRAM IO TEST" << std::endl;
+    result |= !posteriorgram_io_test();
+
+    std::cout << std::endl << "CORE API TEST" << std::endl;
+    result |= !core_api_test();
+
+    std::cout << std::endl << "ASYNC LOGGER TEST" << std::endl;
+    result |= !async_logger_test();
+
+    std::cout << std::endl << "RESOURCE STATS TEST" << std::endl;
+    result |= !resource_stats_test();
+
+    std::cout << std::endl << "WHISPER SERVICE LOAD TEST" << std::endl;
+    result |= !whisper_service_load_test();
+
+    std::cout << std::endl << "WHISPER TRANSPORT BENCHMARK" << std::endl;
+    result |= !whisper_transport_benchmark();
+
+    std::cout << std::endl << "WHISPER LAZY INIT TEST" << std::endl;
+    result |= !whisper_lazy_init_test();
+
+    std::cout << std::endl << "DERIVED AUDIO BUFFERS TEST" << std::endl;
+    result |= !derived_audio_buffers_test();
+
+    std::cout << std::endl << "SOURCE AUDIO CACHE TEST" << std::endl;
+    result |= !source_audio_cache_test();
+
+    std::cout << std::endl << "WORKER POOL TEST" << std::endl;
+    result |= !worker_pool_test();
+
     return result;
 }
\ No newline at end of file
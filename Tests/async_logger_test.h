@@ -0,0 +1,115 @@
+#ifndef NN_ASYNC_LOGGER_TEST_H
+#define NN_ASYNC_LOGGER_TEST_H
+
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "AsyncLogger.h"
+
+/**
+ * Log from several threads at once, then check that every message was written exactly once and formatted, and that
+ * messages dropped on overflow are all accounted for.
+ */
+bool async_logger_test()
+{
+    constexpr int num_threads = 4;
+    constexpr int num_messages_per_thread = 200;
+    constexpr int num_overflow_messages = 4 * static_cast<int>(Log::AsyncLogger::CAPACITY);
+
+    auto log_file = File::getSpecialLocation(File::tempDirectory).getNonexistentChildFile("async_logger", ".log");
+    const auto log_path = log_file.getFullPathName().toStdString();
+
+    auto& logger = Log::AsyncLogger::getInstance();
+
+    if (!logger.start(log_path, false)) {
+        std::cout << "FAIL: Could not start the logger with " << log_path << std::endl;
+        return false;
+    }
+
+    logger.setMinLevel(Log::Level::Debug);
+    logger.setCategoryEnabled(Log::Category::UI, false);
+
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < num_messages_per_thread; i++) {
+                NN_LOG_INFO(Recording, "thread {} message {} value {} {}", t, i, 0.5f, std::string("text"));
+                // Disabled category: never written
+                NN_LOG_ERROR(UI, "should not be written");
+            }
+        });
+    }
+
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    // Fewer messages than the capacity: none can be dropped
+    logger.flush();
+    const auto num_dropped_before_overflow = logger.getNumDropped();
+
+    for (int i = 0; i < num_overflow_messages; i++) {
+        NN_LOG_DEBUG(Transcription, "overflow {}", i);
+    }
+
+    logger.stop();
+    logger.setCategoryEnabled(Log::Category::UI, true);
+    logger.setMinLevel(Log::Level::Info);
+
+    const auto num_dropped = logger.getNumDropped() - num_dropped_before_overflow;
+
+    std::ifstream stream(log_path);
+    std::string line;
+    int num_thread_lines = 0;
+    int num_overflow_lines = 0;
+    int num_dropped_lines = 0;
+    bool succeeded = true;
+
+    while (std::getline(stream, line)) {
+        if (line.find("[INFO] [Recording] thread ") != std::string::npos) {
+            num_thread_lines++;
+
+            if (line.find(" value 0.5 text") == std::string::npos) {
+                std::cout << "FAIL: Badly formatted line: " << line << std::endl;
+                succeeded = false;
+            }
+        } else if (line.find("[DEBUG] [Transcription] overflow ") != std::string::npos) {
+            num_overflow_lines++;
+        } else if (line.find("log messages dropped") != std::string::npos) {
+            num_dropped_lines++;
+        } else {
+            std::cout << "FAIL: Unexpected line: " << line << std::endl;
+            succeeded = false;
+        }
+    }
+
+    log_file.deleteFile();
+
+    if (num_dropped_before_overflow != 0 || num_thread_lines != num_threads * num_messages_per_thread) {
+        std::cout << "FAIL: Expected " << num_threads * num_messages_per_thread << " lines, got " << num_thread_lines
+                  << " (" << num_dropped_before_overflow << " dropped)" << std::endl;
+        succeeded = false;
+    }
+
+    if (static_cast<uint64_t>(num_overflow_lines) + num_dropped != static_cast<uint64_t>(num_overflow_messages)) {
+        std::cout << "FAIL: " << num_overflow_lines << " overflow lines written and " << num_dropped << " dropped, for "
+                  << num_overflow_messages << " messages" << std::endl;
+        succeeded = false;
+    }
+
+    if ((num_dropped > 0) != (num_dropped_lines > 0)) {
+        std::cout << "FAIL: Dropped messages not reported" << std::endl;
+        succeeded = false;
+    }
+
+    if (succeeded) {
+        std::cout << "SUCCESS" << std::endl;
+    }
+
+    return succeeded;
+}
+
+#endif // NN_ASYNC_LOGGER_TEST_H
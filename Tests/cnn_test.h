@@ -8,7 +8,10 @@
 #include "BasicPitchCNN.h"
 #include "test_utils.h"
 #include "BasicPitchConstants.h"
+#include <chrono>
 #include <fstream>
+#include <memory>
+#include <thread>
 
 bool cnn_test()
 {
@@ -106,4 +109,102 @@ bool cnn_test()
     return (num_err_contours + num_err_notes + num_err_onsets) == 0;
 }
 
+bool cnn_parallel_branches_test()
+{
+    std::ifstream features_python_stream(std::string(TEST_DATA_DIR) + "/features_onnx.csv");
+    auto features_python = test_utils::loadCSVDataFile<float>(features_python_stream);
+
+    size_t num_frames = features_python.size() / (NUM_HARMONICS * NUM_FREQ_IN);
+
+    BasicPitchCNN sequential_cnn;
+    BasicPitchCNN parallel_cnn;
+    parallel_cnn.setParallelBranches(true);
+
+    std::vector<float> contours(NUM_FREQ_IN), notes(NUM_FREQ_OUT), onsets(NUM_FREQ_OUT);
+    std::vector<float> parallel_contours(NUM_FREQ_IN), parallel_notes(NUM_FREQ_OUT), parallel_onsets(NUM_FREQ_OUT);
+
+    // Twice, with a reset and a pause long enough for the worker to sleep in between
+    for (int run = 0; run < 2; run++) {
+        sequential_cnn.reset();
+        parallel_cnn.reset();
+
+        for (size_t i = 0; i < num_frames; i++) {
+            const float* frame = features_python.data() + i * NUM_HARMONICS * NUM_FREQ_IN;
+            sequential_cnn.frameInference(frame, contours, notes, onsets);
+            parallel_cnn.frameInference(frame, parallel_contours, parallel_notes, parallel_onsets);
+
+            if (contours != parallel_contours || notes != parallel_notes || onsets != parallel_onsets) {
+                std::cout << "FAIL: Run " << run << ": outputs differ at frame " << i << std::endl;
+                return false;
+            }
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+
+    parallel_cnn.setParallelBranches(false);
+
+    if (parallel_cnn.getParallelBranches()) {
+        std::cout << "FAIL: Worker thread still running" << std::endl;
+        return false;
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+
+    return true;
+}
+
+bool cnn_state_test()
+{
+    std::ifstream features_python_stream(std::string(TEST_DATA_DIR) + "/features_onnx.csv");
+    auto features_python = test_utils::loadCSVDataFile<float>(features_python_stream);
+
+    size_t num_frames = features_python.size() / (NUM_HARMONICS * NUM_FREQ_IN);
+
+    auto get_frame = [&](size_t inFrameIdx) {
+        return features_python.data() + inFrameIdx * NUM_HARMONICS * NUM_FREQ_IN;
+    };
+
+    std::vector<float> contours(NUM_FREQ_IN), notes(NUM_FREQ_OUT), onsets(NUM_FREQ_OUT);
+    std::vector<float> restored_contours(NUM_FREQ_IN), restored_notes(NUM_FREQ_OUT), restored_onsets(NUM_FREQ_OUT);
+
+    // Early checkpoints have seen fewer frames than the history of the models
+    // Checkpoint 10 is past the contours kept for the output alignment but within the history of the note model
+    for (size_t checkpoint: {size_t(0), size_t(3), size_t(10), num_frames / 2}) {
+        BasicPitchCNN cnn;
+        cnn.reset();
+
+        for (size_t i = 0; i < checkpoint; i++) {
+            cnn.frameInference(get_frame(i), contours, notes, onsets);
+        }
+
+        auto state = std::make_unique<BasicPitchCNN::State>();
+        cnn.saveState(*state);
+
+        // Restore in an instance that has already run on other frames, with the parallel branches on
+        BasicPitchCNN restored_cnn;
+        restored_cnn.setParallelBranches(true);
+
+        for (size_t i = num_frames - 20; i < num_frames; i++) {
+            restored_cnn.frameInference(get_frame(i), restored_contours, restored_notes, restored_onsets);
+        }
+
+        restored_cnn.restoreState(*state);
+
+        for (size_t i = checkpoint; i < std::min(num_frames, checkpoint + 100); i++) {
+            cnn.frameInference(get_frame(i), contours, notes, onsets);
+            restored_cnn.frameInference(get_frame(i), restored_contours, restored_notes, restored_onsets);
+
+            if (contours != restored_contours || notes != restored_notes || onsets != restored_onsets) {
+                std::cout << "FAIL: Checkpoint " << checkpoint << ": outputs differ at frame " << i << std::endl;
+                return false;
+            }
+        }
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+
+    return true;
+}
+
 #endif //NN_CNN_TEST_H
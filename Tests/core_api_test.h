@@ -0,0 +1,102 @@
+#ifndef NN_CORE_API_TEST_H
+#define NN_CORE_API_TEST_H
+
+#include <fstream>
+#include <iostream>
+
+#include "NeuralNoteCore.h"
+#include "test_utils.h"
+
+namespace
+{
+bool core_api_notes_match(const nn_engine* inEngine, const std::vector<Notes::Event>& inExpected)
+{
+    const nn_note* notes = nullptr;
+    const size_t num_notes = nn_engine_get_notes(inEngine, &notes);
+
+    if (num_notes != inExpected.size()) {
+        std::cout << "FAIL: Got " << num_notes << " notes, expected " << inExpected.size() << std::endl;
+        return false;
+    }
+
+    for (size_t i = 0; i < num_notes; i++) {
+        if (notes[i].pitch != inExpected[i].pitch || notes[i].start_time != inExpected[i].startTime
+            || notes[i].end_time != inExpected[i].endTime || notes[i].amplitude != inExpected[i].amplitude) {
+            std::cout << "FAIL: Note " << i << " differs" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+} // namespace
+
+/**
+ * Create notes from the reference posteriorgrams through the C API, then convert them again with other parameters,
+ * and compare with Notes::convert.
+ */
+bool core_api_test()
+{
+    std::ifstream f_notes_pg(std::string(TEST_DATA_DIR) + "/notes.csv");
+    std::ifstream f_onsets_pg(std::string(TEST_DATA_DIR) + "/onsets.csv");
+    std::ifstream f_contours_pg(std::string(TEST_DATA_DIR) + "/contours.csv");
+    auto notes_pg_1d = test_utils::loadCSVDataFile<float>(f_notes_pg);
+    auto onsets_pg_1d = test_utils::loadCSVDataFile<float>(f_onsets_pg);
+    auto contours_pg_1d = test_utils::loadCSVDataFile<float>(f_contours_pg);
+
+    const size_t num_frames = notes_pg_1d.size() / NN_NUM_NOTE_BINS;
+
+    auto* engine = nn_engine_create();
+
+    if (engine == nullptr) {
+        std::cout << "FAIL: Could not create the engine" << std::endl;
+        return false;
+    }
+
+    Notes notes_creator;
+    auto notes_pg = test_utils::convert_1d_to_2d<float>(notes_pg_1d, -1, NUM_FREQ_OUT);
+    auto onsets_pg = test_utils::convert_1d_to_2d<float>(onsets_pg_1d, -1, NUM_FREQ_OUT);
+    auto contours_pg = test_utils::convert_1d_to_2d<float>(contours_pg_1d, -1, NUM_FREQ_IN);
+
+    bool succeeded = true;
+    auto params = nn_default_params();
+
+    if (nn_engine_set_posteriorgrams(
+            engine, contours_pg_1d.data(), notes_pg_1d.data(), onsets_pg_1d.data(), num_frames, &params)
+        != 0) {
+        std::cout << "FAIL: " << nn_engine_get_error(engine) << std::endl;
+        succeeded = false;
+    }
+
+    auto convert_params =
+        BasicPitch::createConvertParams(params.note_sensitivity, params.split_sensitivity, params.min_note_duration_ms);
+
+    succeeded = succeeded
+                && core_api_notes_match(
+                    engine, notes_creator.convert(notes_pg, onsets_pg, contours_pg, convert_params, true));
+
+    params.note_sensitivity = 0.9f;
+    params.min_note_duration_ms = 50.0f;
+
+    if (succeeded && nn_engine_convert(engine, &params) != 0) {
+        std::cout << "FAIL: " << nn_engine_get_error(engine) << std::endl;
+        succeeded = false;
+    }
+
+    convert_params =
+        BasicPitch::createConvertParams(params.note_sensitivity, params.split_sensitivity, params.min_note_duration_ms);
+
+    succeeded = succeeded
+                && core_api_notes_match(
+                    engine, notes_creator.convert(notes_pg, onsets_pg, contours_pg, convert_params, false));
+
+    nn_engine_destroy(engine);
+
+    if (succeeded) {
+        std::cout << "SUCCESS" << std::endl;
+    }
+
+    return succeeded;
+}
+
+#endif // NN_CORE_API_TEST_H
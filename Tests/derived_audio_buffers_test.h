@@ -0,0 +1,103 @@
+#ifndef NN_DERIVED_AUDIO_BUFFERS_TEST_H
+#define NN_DERIVED_AUDIO_BUFFERS_TEST_H
+
+#include <iostream>
+
+#include "DerivedAudioBuffers.h"
+
+/**
+ * Check that derived buffers are computed once on request, shared while held, and that trim only evicts the unused
+ * ones, least recently acquired first, until they fit in the memory budget.
+ */
+bool derived_audio_buffers_test()
+{
+    using Type = DerivedAudioBuffers::Type;
+
+    bool succeeded = true;
+
+    constexpr int num_samples = 1000;
+    const auto buffer_bytes = static_cast<uint64_t>(num_samples * sizeof(float));
+
+    // Room for one unused buffer only
+    DerivedAudioBuffers buffers(buffer_bytes);
+
+    int num_computed = 0;
+    auto compute = [&]() {
+        num_computed++;
+        auto buffer = std::make_shared<AudioBuffer<float>>(1, num_samples);
+        buffer->clear();
+        return buffer;
+    };
+
+    if (buffers.acquire(Type::Transcription) != nullptr) {
+        std::cout << "FAIL: Buffer acquired without compute function" << std::endl;
+        succeeded = false;
+    }
+
+    buffers.setComputeFunction(Type::Transcription, compute);
+    buffers.setComputeFunction(Type::Whisper, compute);
+
+    if (num_computed != 0 || buffers.isResident(Type::Transcription) || buffers.getResidentBytes() != 0) {
+        std::cout << "FAIL: Buffer computed before any request" << std::endl;
+        succeeded = false;
+    }
+
+    auto transcription = buffers.acquire(Type::Transcription);
+    auto transcription_again = buffers.acquire(Type::Transcription);
+
+    if (num_computed != 1 || transcription != transcription_again || transcription->getNumSamples() != num_samples) {
+        std::cout << "FAIL: Buffer not shared between consumers, computed " << num_computed << " times" << std::endl;
+        succeeded = false;
+    }
+
+    auto whisper = buffers.acquire(Type::Whisper);
+
+    if (num_computed != 2 || buffers.getResidentBytes() != 2 * buffer_bytes) {
+        std::cout << "FAIL: Wrong resident size " << buffers.getResidentBytes() << std::endl;
+        succeeded = false;
+    }
+
+    // Buffers held by a consumer are never evicted
+    buffers.trim();
+
+    if (!buffers.isResident(Type::Transcription) || !buffers.isResident(Type::Whisper)) {
+        std::cout << "FAIL: Held buffer evicted" << std::endl;
+        succeeded = false;
+    }
+
+    // Both unused: the least recently acquired one is evicted to fit in the budget
+    transcription.reset();
+    transcription_again.reset();
+    whisper.reset();
+    buffers.trim();
+
+    if (buffers.isResident(Type::Transcription) || !buffers.isResident(Type::Whisper)
+        || buffers.getResidentBytes() != buffer_bytes) {
+        std::cout << "FAIL: Wrong buffer evicted" << std::endl;
+        succeeded = false;
+    }
+
+    // Evicted buffers are computed again on request, provided ones are used as is
+    auto provided = std::make_shared<AudioBuffer<float>>(2, num_samples);
+    provided->clear();
+    buffers.setBuffer(Type::Whisper, std::move(provided));
+    transcription = buffers.acquire(Type::Transcription);
+    whisper = buffers.acquire(Type::Whisper);
+
+    if (num_computed != 3 || transcription == nullptr || whisper->getNumChannels() != 2) {
+        std::cout << "FAIL: Buffer not computed again after eviction" << std::endl;
+        succeeded = false;
+    }
+
+    // Consumers keep their buffer after clear
+    buffers.clear();
+
+    if (buffers.getResidentBytes() != 0 || transcription->getNumSamples() != num_samples) {
+        std::cout << "FAIL: Wrong state after clear" << std::endl;
+        succeeded = false;
+    }
+
+    return succeeded;
+}
+
+#endif // NN_DERIVED_AUDIO_BUFFERS_TEST_H
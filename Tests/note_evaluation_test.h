@@ -0,0 +1,68 @@
+#ifndef NN_NOTE_EVALUATION_TEST_H
+#define NN_NOTE_EVALUATION_TEST_H
+
+#include <cmath>
+#include <iostream>
+
+#include "NoteEvaluation.h"
+
+bool note_evaluation_test()
+{
+    using NoteEvaluation::Note;
+
+    const std::vector<Note> reference = {
+        {0.00, 1.00, 60}, {0.50, 1.00, 64}, {1.00, 2.00, 67}, {2.00, 2.10, 72}, {3.00, 4.00, 60}};
+
+    const std::vector<Note> estimated = {
+        {0.03, 1.10, 60}, // Match (onset and offset within tolerance)
+        {0.52, 1.40, 64}, // Onset match only: offset error 0.4 > max(0.2 * 0.5, 0.05)
+        {1.00, 2.00, 68}, // Wrong pitch
+        {2.04, 2.14, 72}, // Match: offset tolerance is the 0.05 minimum
+        {3.02, 4.00, 60}, // Match
+        {3.04, 4.00, 60}}; // Duplicate: only one estimated note can match a reference note
+
+    NoteEvaluation::MatchingParams onset_offset_params;
+    auto onset_offset = NoteEvaluation::computeScores(reference, estimated, onset_offset_params);
+
+    NoteEvaluation::MatchingParams onset_params;
+    onset_params.matchOffsets = false;
+    auto onset_only = NoteEvaluation::computeScores(reference, estimated, onset_params);
+
+    auto is_close = [](double a, double b) { return std::abs(a - b) < 1e-9; };
+
+    if (onset_offset.numMatched != 3 || !is_close(onset_offset.precision, 3.0 / 6.0)
+        || !is_close(onset_offset.recall, 3.0 / 5.0) || !is_close(onset_offset.f1, 6.0 / 11.0)) {
+        std::cout << "Onset + offset scores are wrong: " << onset_offset.numMatched << " matched, F1 "
+                  << onset_offset.f1 << std::endl;
+        return false;
+    }
+
+    if (onset_only.numMatched != 4 || !is_close(onset_only.f1, 8.0 / 11.0)) {
+        std::cout << "Onset only scores are wrong: " << onset_only.numMatched << " matched, F1 " << onset_only.f1
+                  << std::endl;
+        return false;
+    }
+
+    // A greedy matching would pair the first estimated note with the first reference note and leave the second
+    // reference note unmatched (its only candidate is the first estimated note). The maximum matching finds both pairs.
+    const std::vector<Note> reference_close = {{0.03, 1.00, 60}, {0.00, 1.00, 60}};
+    const std::vector<Note> estimated_close = {{0.02, 1.00, 60}, {0.07, 1.00, 60}};
+
+    if (NoteEvaluation::matchNotes(reference_close, estimated_close, onset_params).size() != 2) {
+        std::cout << "Matching is not maximal" << std::endl;
+        return false;
+    }
+
+    auto total = NoteEvaluation::accumulateScores({onset_offset, onset_only});
+
+    if (total.numMatched != 7 || total.numReference != 10 || total.numEstimated != 12) {
+        std::cout << "Accumulated scores are wrong" << std::endl;
+        return false;
+    }
+
+    std::cout << "Success" << std::endl;
+
+    return true;
+}
+
+#endif //NN_NOTE_EVALUATION_TEST_H
@@ -5,7 +5,10 @@
 #ifndef NN_NOTES_TEST_H
 #define NN_NOTES_TEST_H
 
+#include <algorithm>
 #include <fstream>
+#include <random>
+#include <tuple>
 #include <json.hpp>
 
 #include "Notes.h"
@@ -98,4 +101,298 @@ bool notes_test()
     return succeeded;
 }
 
+/*
+ * Applying the diff between the expected outputs of consecutive cases to the first one should give the second one.
+ */
+bool notes_diff_test()
+{
+    std::ifstream f_expected(std::string(TEST_DATA_DIR) + "/note_events.output.json");
+    auto all_expected = json::parse(f_expected).get<std::vector<std::vector<Notes::Event>>>();
+
+    auto event_less = [](const Notes::Event& a, const Notes::Event& b) {
+        return std::tie(a.startFrame, a.pitch, a.endFrame, a.startTime, a.endTime, a.amplitude)
+               < std::tie(b.startFrame, b.pitch, b.endFrame, b.startTime, b.endTime, b.amplitude);
+    };
+
+    bool succeeded = true;
+
+    for (size_t i = 0; i + 1 < all_expected.size() && succeeded; i++) {
+        const auto& previous = all_expected[i];
+        auto expected = all_expected[i + 1];
+
+        auto diff = Notes::computeEventsDiff(previous, expected);
+        std::cout << "  Case " << i << " -> " << i + 1 << ": " << diff.added.size() << " added, "
+                  << diff.removed.size() << " removed, " << diff.modified.size() << " modified" << std::endl;
+
+        auto patched = previous;
+
+        auto remove_event = [&patched](const Notes::Event& inEvent) {
+            auto iter = std::find(patched.begin(), patched.end(), inEvent);
+            if (iter == patched.end())
+                return false;
+            patched.erase(iter);
+            return true;
+        };
+
+        for (const auto& event: diff.removed)
+            succeeded &= remove_event(event);
+
+        for (const auto& [prev_event, new_event]: diff.modified) {
+            succeeded &= remove_event(prev_event);
+            patched.push_back(new_event);
+        }
+
+        patched.insert(patched.end(), diff.added.begin(), diff.added.end());
+
+        std::sort(patched.begin(), patched.end(), event_less);
+        std::sort(expected.begin(), expected.end(), event_less);
+
+        if (!succeeded || patched != expected) {
+            std::cout << "FAIL: Patched events differ from expected events" << std::endl;
+            succeeded = false;
+        }
+
+        if (!Notes::computeEventsDiff(expected, expected).isEmpty()) {
+            std::cout << "FAIL: Diff of identical events is not empty" << std::endl;
+            succeeded = false;
+        }
+    }
+
+    if (succeeded) {
+        std::cout << "Success" << std::endl;
+    }
+
+    return succeeded;
+}
+
+/*
+ * Preparing the frames incrementally, as done while the CNN runs, must give the same events as converting at once.
+ */
+bool notes_pipeline_test()
+{
+    std::ifstream f_notes_pg(std::string(TEST_DATA_DIR) + "/notes.csv");
+    std::ifstream f_onsets_pg(std::string(TEST_DATA_DIR) + "/onsets.csv");
+    std::ifstream f_contours_pg(std::string(TEST_DATA_DIR) + "/contours.csv");
+    auto notes_pg = test_utils::convert_1d_to_2d<float>(test_utils::loadCSVDataFile<float>(f_notes_pg), -1, NUM_FREQ_OUT);
+    auto onsets_pg =
+        test_utils::convert_1d_to_2d<float>(test_utils::loadCSVDataFile<float>(f_onsets_pg), -1, NUM_FREQ_OUT);
+    auto contours_pg =
+        test_utils::convert_1d_to_2d<float>(test_utils::loadCSVDataFile<float>(f_contours_pg), -1, NUM_FREQ_IN);
+
+    std::ifstream f_input(std::string(TEST_DATA_DIR) + "/note_events.input.json");
+    auto all_cases = json::parse(f_input).get<std::vector<Notes::ConvertParams>>();
+
+    const size_t num_frames = notes_pg.size();
+    bool succeeded = true;
+
+    for (size_t i = 0; i < all_cases.size() && succeeded; i++) {
+        Notes at_once;
+        auto expected = at_once.convert(notes_pg, onsets_pg, contours_pg, all_cases[i], true);
+
+        // Irregular blocks, including empty ones
+        Notes incremental;
+        incremental.prepareNewAudio(num_frames);
+
+        for (size_t begin = 0, block_size = 0; begin < num_frames; block_size = (block_size * 7 + 3) % 100) {
+            const auto end = std::min(num_frames, begin + block_size);
+            incremental.prepareFrames(notes_pg, onsets_pg, begin, end);
+            begin = end;
+        }
+
+        auto note_events = incremental.convert(notes_pg, onsets_pg, contours_pg, all_cases[i], false);
+
+        if (note_events != expected) {
+            std::cout << "FAIL: Case " << i << ": got " << note_events.size() << " events, expected "
+                      << expected.size() << std::endl;
+            succeeded = false;
+        }
+    }
+
+    if (succeeded) {
+        std::cout << "Success" << std::endl;
+    }
+
+    return succeeded;
+}
+
+bool notes_pitch_bends_cache_test()
+{
+    std::ifstream f_notes_pg(std::string(TEST_DATA_DIR) + "/notes.csv");
+    std::ifstream f_onsets_pg(std::string(TEST_DATA_DIR) + "/onsets.csv");
+    std::ifstream f_contours_pg(std::string(TEST_DATA_DIR) + "/contours.csv");
+    auto notes_pg = test_utils::convert_1d_to_2d<float>(test_utils::loadCSVDataFile<float>(f_notes_pg), -1, NUM_FREQ_OUT);
+    auto onsets_pg =
+        test_utils::convert_1d_to_2d<float>(test_utils::loadCSVDataFile<float>(f_onsets_pg), -1, NUM_FREQ_OUT);
+    auto contours_pg =
+        test_utils::convert_1d_to_2d<float>(test_utils::loadCSVDataFile<float>(f_contours_pg), -1, NUM_FREQ_IN);
+
+    std::ifstream f_input(std::string(TEST_DATA_DIR) + "/note_events.input.json");
+    auto all_cases = json::parse(f_input).get<std::vector<Notes::ConvertParams>>();
+
+    // Same instance updated through all the cases, with the bends turned off and on in between
+    Notes updated;
+    bool is_new_audio = true;
+
+    for (size_t i = 0; i < all_cases.size(); i++) {
+        for (auto pitch_bend: {NoPitchBend, MultiPitchBend, SinglePitchBend, MultiPitchBend}) {
+            auto params = all_cases[i];
+            params.pitchBend = pitch_bend;
+
+            Notes at_once;
+            auto expected = at_once.convert(notes_pg, onsets_pg, contours_pg, params, true);
+            auto note_events = updated.convert(notes_pg, onsets_pg, contours_pg, params, is_new_audio);
+            is_new_audio = false;
+
+            if (note_events != expected) {
+                std::cout << "FAIL: Case " << i << ", pitch bend mode " << pitch_bend << ": events differ" << std::endl;
+                return false;
+            }
+        }
+    }
+
+    std::cout << "Success" << std::endl;
+
+    return true;
+}
+
+bool notes_range_test()
+{
+    std::ifstream f_notes_pg(std::string(TEST_DATA_DIR) + "/notes.csv");
+    std::ifstream f_onsets_pg(std::string(TEST_DATA_DIR) + "/onsets.csv");
+    std::ifstream f_contours_pg(std::string(TEST_DATA_DIR) + "/contours.csv");
+    auto notes_pg = test_utils::convert_1d_to_2d<float>(test_utils::loadCSVDataFile<float>(f_notes_pg), -1, NUM_FREQ_OUT);
+    auto onsets_pg =
+        test_utils::convert_1d_to_2d<float>(test_utils::loadCSVDataFile<float>(f_onsets_pg), -1, NUM_FREQ_OUT);
+    auto contours_pg =
+        test_utils::convert_1d_to_2d<float>(test_utils::loadCSVDataFile<float>(f_contours_pg), -1, NUM_FREQ_IN);
+
+    std::ifstream f_input(std::string(TEST_DATA_DIR) + "/note_events.input.json");
+    auto all_cases = json::parse(f_input).get<std::vector<Notes::ConvertParams>>();
+
+    for (size_t i = 0; i < all_cases.size(); i++) {
+        auto params = all_cases[i];
+        params.minFrequency = -1;
+        params.maxFrequency = -1;
+
+        Notes notes;
+        auto all_events = notes.convert(notes_pg, onsets_pg, contours_pg, params, true);
+
+        // The full range given explicitly gives the same events
+        params.minFrequency = NoteUtils::midiToHz(MIDI_OFFSET);
+        params.maxFrequency = NoteUtils::midiToHz(MIDI_OFFSET + MAX_NOTE_IDX);
+
+        if (notes.convert(notes_pg, onsets_pg, contours_pg, params, false) != all_events) {
+            std::cout << "FAIL: Case " << i << ": full range gives different events" << std::endl;
+            return false;
+        }
+
+        // Only notes of the range, on the same instance and updated back and forth
+        for (auto [min_note, max_note]: {std::pair(40, 60), std::pair(60, 61), std::pair(21, 50), std::pair(70, 108)}) {
+            params.minFrequency = NoteUtils::midiToHz(static_cast<float>(min_note));
+            params.maxFrequency = NoteUtils::midiToHz(static_cast<float>(max_note));
+
+            auto events = notes.convert(notes_pg, onsets_pg, contours_pg, params, false);
+
+            for (const auto& event: events) {
+                if (event.pitch < min_note || event.pitch > max_note) {
+                    std::cout << "FAIL: Case " << i << ": pitch " << event.pitch << " out of range [" << min_note
+                              << ", " << max_note << "]" << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+
+    std::cout << "Success" << std::endl;
+
+    return true;
+}
+
+bool notes_parallel_test()
+{
+    std::ifstream f_notes_pg(std::string(TEST_DATA_DIR) + "/notes.csv");
+    std::ifstream f_onsets_pg(std::string(TEST_DATA_DIR) + "/onsets.csv");
+    std::ifstream f_contours_pg(std::string(TEST_DATA_DIR) + "/contours.csv");
+    auto notes_pg = test_utils::convert_1d_to_2d<float>(test_utils::loadCSVDataFile<float>(f_notes_pg), -1, NUM_FREQ_OUT);
+    auto onsets_pg =
+        test_utils::convert_1d_to_2d<float>(test_utils::loadCSVDataFile<float>(f_onsets_pg), -1, NUM_FREQ_OUT);
+    auto contours_pg =
+        test_utils::convert_1d_to_2d<float>(test_utils::loadCSVDataFile<float>(f_contours_pg), -1, NUM_FREQ_IN);
+
+    std::ifstream f_input(std::string(TEST_DATA_DIR) + "/note_events.input.json");
+    auto all_cases = json::parse(f_input).get<std::vector<Notes::ConvertParams>>();
+
+    // Synthetic posteriorgrams: sustained notes of random pitches, interrupted by silences of 0 to 45 frames every
+    // 150 frames or so, after which some notes go on without a new onset.
+    const size_t num_frames = 20000;
+    std::vector<std::vector<float>> synth_notes_pg(num_frames, std::vector<float>(NUM_FREQ_OUT));
+    std::vector<std::vector<float>> synth_onsets_pg(num_frames, std::vector<float>(NUM_FREQ_OUT));
+    std::vector<std::vector<float>> synth_contours_pg(num_frames, std::vector<float>(NUM_FREQ_IN));
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+
+    for (int segment = 0; segment < 600; segment++) {
+        const auto pitch = static_cast<size_t>(uniform(generator) * NUM_FREQ_OUT);
+        const auto start = static_cast<size_t>(uniform(generator) * num_frames);
+        const auto end = std::min(num_frames, start + 20 + static_cast<size_t>(uniform(generator) * 280));
+        const float level = 0.5f + 0.4f * uniform(generator);
+
+        synth_onsets_pg[start][pitch] = 0.9f;
+
+        for (size_t f = start; f < end; f++) {
+            synth_notes_pg[f][pitch] = std::max(synth_notes_pg[f][pitch], level + 0.1f * uniform(generator));
+        }
+    }
+
+    for (size_t silence_start = 100; silence_start < num_frames; silence_start += 100 + uniform(generator) * 100) {
+        const auto silence_end = std::min(num_frames, silence_start + static_cast<size_t>(uniform(generator) * 46));
+
+        for (size_t f = silence_start; f < silence_end; f++) {
+            std::fill(synth_notes_pg[f].begin(), synth_notes_pg[f].end(), 0.0f);
+        }
+
+        if (silence_end < num_frames) {
+            for (auto& onset: synth_onsets_pg[silence_end]) {
+                onset = uniform(generator) < 0.5f ? 0.7f : onset;
+            }
+        }
+    }
+
+    for (size_t f = 0; f < num_frames; f++) {
+        for (size_t n = 0; n < NUM_FREQ_OUT; n++) {
+            synth_notes_pg[f][n] += 0.1f * uniform(generator);
+            synth_onsets_pg[f][n] += 0.1f * uniform(generator);
+        }
+
+        for (auto& contour: synth_contours_pg[f]) {
+            contour = uniform(generator);
+        }
+    }
+
+    for (size_t i = 0; i < all_cases.size(); i++) {
+        for (int data = 0; data < 2; data++) {
+            const auto& notes = data == 0 ? notes_pg : synth_notes_pg;
+            const auto& onsets = data == 0 ? onsets_pg : synth_onsets_pg;
+            const auto& contours = data == 0 ? contours_pg : synth_contours_pg;
+
+            Notes serial;
+            auto expected = serial.convert(notes, onsets, contours, all_cases[i], true);
+
+            Notes parallel;
+            parallel.setNumThreads(4, 30);
+            auto note_events = parallel.convert(notes, onsets, contours, all_cases[i], true);
+
+            if (note_events != expected) {
+                std::cout << "FAIL: Case " << i << (data == 0 ? " (test data)" : " (synthetic data)") << ": got "
+                          << note_events.size() << " events, expected " << expected.size() << std::endl;
+                return false;
+            }
+        }
+    }
+
+    std::cout << "Success" << std::endl;
+
+    return true;
+}
+
 #endif //NN_NOTES_TEST_H
@@ -0,0 +1,92 @@
+#ifndef NN_POSTERIORGRAM_IO_TEST_H
+#define NN_POSTERIORGRAM_IO_TEST_H
+
+#include <fstream>
+#include <iostream>
+
+#include "NpyIO.h"
+#include "PosteriorgramIO.h"
+#include "test_utils.h"
+
+/**
+ * Write the reference posteriorgrams to .npy files, read them back and check that they are identical and that
+ * malformed files are rejected.
+ */
+bool posteriorgram_io_test()
+{
+    std::ifstream f_notes_pg(std::string(TEST_DATA_DIR) + "/notes.csv");
+    std::ifstream f_onsets_pg(std::string(TEST_DATA_DIR) + "/onsets.csv");
+    std::ifstream f_contours_pg(std::string(TEST_DATA_DIR) + "/contours.csv");
+
+    BasicPitch::Posteriorgrams posteriorgrams;
+    posteriorgrams.notes =
+        test_utils::convert_1d_to_2d<float>(test_utils::loadCSVDataFile<float>(f_notes_pg), -1, NUM_FREQ_OUT);
+    posteriorgrams.onsets =
+        test_utils::convert_1d_to_2d<float>(test_utils::loadCSVDataFile<float>(f_onsets_pg), -1, NUM_FREQ_OUT);
+    posteriorgrams.contours =
+        test_utils::convert_1d_to_2d<float>(test_utils::loadCSVDataFile<float>(f_contours_pg), -1, NUM_FREQ_IN);
+
+    auto directory = File::getSpecialLocation(File::tempDirectory).getNonexistentChildFile("posteriorgrams", "");
+    directory.createDirectory();
+    const auto directory_path = directory.getFullPathName().toStdString();
+
+    std::string error;
+    bool succeeded = true;
+
+    if (!PosteriorgramIO::save(posteriorgrams, directory_path, error)) {
+        std::cout << "FAIL: Could not save posteriorgrams: " << error << std::endl;
+        succeeded = false;
+    }
+
+    BasicPitch::Posteriorgrams loaded;
+
+    if (succeeded && !PosteriorgramIO::load(directory_path, loaded, error)) {
+        std::cout << "FAIL: Could not load posteriorgrams: " << error << std::endl;
+        succeeded = false;
+    }
+
+    if (succeeded
+        && (loaded.notes != posteriorgrams.notes || loaded.onsets != posteriorgrams.onsets
+            || loaded.contours != posteriorgrams.contours)) {
+        std::cout << "FAIL: Loaded posteriorgrams differ from the saved ones" << std::endl;
+        succeeded = false;
+    }
+
+    // Notes posteriorgram saved in place of the contours: wrong number of columns
+    const auto contours_path = directory.getChildFile(PosteriorgramIO::CONTOURS_FILE_NAME).getFullPathName();
+
+    if (succeeded
+        && (!NpyIO::writeMatrix(contours_path.toStdString(), posteriorgrams.notes, NUM_FREQ_OUT, error)
+            || PosteriorgramIO::load(directory_path, loaded, error))) {
+        std::cout << "FAIL: Posteriorgrams with wrong shapes were loaded" << std::endl;
+        succeeded = false;
+    }
+
+    // Truncated data
+    const std::vector<std::vector<float>> small_matrix = {{0.0f, 0.5f, 1.0f}, {1.5f, 2.0f, 2.5f}};
+    auto truncated_file = directory.getChildFile("truncated.npy");
+
+    if (succeeded && NpyIO::writeMatrix(truncated_file.getFullPathName().toStdString(), small_matrix, 3, error)) {
+        MemoryBlock data;
+        truncated_file.loadFileAsData(data);
+        truncated_file.replaceWithData(data.getData(), data.getSize() - 4);
+
+        std::vector<std::vector<float>> matrix;
+        size_t num_columns;
+
+        if (NpyIO::readMatrix(truncated_file.getFullPathName().toStdString(), matrix, num_columns, error)) {
+            std::cout << "FAIL: Truncated file was read" << std::endl;
+            succeeded = false;
+        }
+    }
+
+    directory.deleteRecursively();
+
+    if (succeeded) {
+        std::cout << "SUCCESS" << std::endl;
+    }
+
+    return succeeded;
+}
+
+#endif // NN_POSTERIORGRAM_IO_TEST_H
@@ -0,0 +1,94 @@
+#ifndef NN_RESOURCE_STATS_TEST_H
+#define NN_RESOURCE_STATS_TEST_H
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "ResourceStats.h"
+
+/**
+ * Check that the registry aggregates the statistics of the live instances only, and that they are exported to JSON.
+ */
+bool resource_stats_test()
+{
+    using namespace ResourceStats;
+
+    bool succeeded = true;
+    const auto num_instances_before = Registry::getInstance().getSnapshots().size();
+
+    InstanceStats first;
+    first.setBytes(Memory::SourceAudio, 1000);
+    first.setBytes(Memory::Posteriorgrams, 200);
+    first.addJob(Job::Transcription, 10.0);
+    first.addJob(Job::Transcription, 30.0);
+
+    {
+        InstanceStats second;
+        second.setBytes(Memory::SourceAudio, 500);
+        second.setBytes(Memory::Whisper, 4000);
+        second.addJob(Job::Transcription, 50.0);
+
+        {
+            InstanceStats::ScopedJob job(second, Job::TextTranscription);
+        }
+
+        const auto snapshots = Registry::getInstance().getSnapshots();
+        const auto total = Registry::getTotal(snapshots);
+
+        if (snapshots.size() != num_instances_before + 2 || total.getTotalBytes() != 5700
+            || total.bytes[static_cast<size_t>(Memory::SourceAudio)] != 1500) {
+            std::cout << "FAIL: Wrong total memory " << total.getTotalBytes() << " for " << snapshots.size()
+                      << " instances" << std::endl;
+            succeeded = false;
+        }
+
+        const auto& transcription = total.jobs[static_cast<size_t>(Job::Transcription)];
+        const auto& text_transcription = total.jobs[static_cast<size_t>(Job::TextTranscription)];
+
+        if (transcription.count != 3 || transcription.totalMs != 90.0 || transcription.maxMs != 50.0
+            || text_transcription.count != 1) {
+            std::cout << "FAIL: Wrong job totals" << std::endl;
+            succeeded = false;
+        }
+
+        if (first.getSnapshot().jobs[static_cast<size_t>(Job::Transcription)].lastMs != 30.0) {
+            std::cout << "FAIL: Wrong last job duration" << std::endl;
+            succeeded = false;
+        }
+
+        const auto path = (std::filesystem::temp_directory_path() / "neuralnote_stats_test.json").string();
+        std::string error;
+
+        if (!Registry::getInstance().writeJsonFile(path, error)) {
+            std::cout << "FAIL: Could not write the statistics: " << error << std::endl;
+            succeeded = false;
+        } else {
+            std::ifstream stream(path);
+            std::stringstream json;
+            json << stream.rdbuf();
+
+            if (json.str().find("\"name\": \"" + second.getName() + "\"") == std::string::npos
+                || json.str().find("\"whisper\": 4000") == std::string::npos) {
+                std::cout << "FAIL: Missing instance in the exported statistics:" << std::endl << json.str();
+                succeeded = false;
+            }
+
+            std::filesystem::remove(path);
+        }
+    }
+
+    if (Registry::getInstance().getSnapshots().size() != num_instances_before + 1) {
+        std::cout << "FAIL: Destroyed instance still registered" << std::endl;
+        succeeded = false;
+    }
+
+    if (succeeded) {
+        std::cout << "SUCCESS" << std::endl;
+    }
+
+    return succeeded;
+}
+
+#endif // NN_RESOURCE_STATS_TEST_H
@@ -0,0 +1,110 @@
+#ifndef NN_SOURCE_AUDIO_CACHE_TEST_H
+#define NN_SOURCE_AUDIO_CACHE_TEST_H
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "SourceAudioCache.h"
+
+/**
+ * Check that entries are shared between the callers while held, computed once when requested concurrently, and
+ * computed again once released or when the file changed on disk.
+ */
+bool source_audio_cache_test()
+{
+    using Representation = SourceAudioCache::Representation;
+    using Buffer = std::shared_ptr<std::vector<float>>;
+
+    bool succeeded = true;
+    auto& cache = SourceAudioCache::getInstance();
+
+    const auto path = std::filesystem::temp_directory_path() / "neuralnote_source_audio_cache_test.wav";
+    std::ofstream(path, std::ios::binary) << "first version";
+
+    const auto key = SourceAudioCache::FileKey::fromPath(path);
+
+    std::atomic<int> num_computed = 0;
+    std::function<Buffer()> compute = [&]() {
+        num_computed++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        return std::make_shared<std::vector<float>>(100, 0.5f);
+    };
+
+    if (!key.isValid() || SourceAudioCache::FileKey::fromPath(path.string() + ".missing").isValid()) {
+        std::cout << "FAIL: Wrong file key validity" << std::endl;
+        succeeded = false;
+    }
+
+    // Instances loading the same file at the same time
+    std::vector<Buffer> buffers(4);
+    std::vector<std::thread> threads;
+
+    for (auto& buffer: buffers) {
+        threads.emplace_back([&]() { buffer = cache.getOrCompute(key, Representation::Playback, 48000.0, compute); });
+    }
+
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    if (num_computed != 1 || buffers[0] == nullptr || buffers[0] != buffers[3]) {
+        std::cout << "FAIL: Entry computed " << num_computed << " times for concurrent requests" << std::endl;
+        succeeded = false;
+    }
+
+    // Other representations and sample rates are separate entries
+    auto other_rate = cache.getOrCompute(key, Representation::Playback, 44100.0, compute);
+    auto transcription = cache.getOrCompute(key, Representation::Transcription, 22050.0, compute);
+
+    if (num_computed != 3 || other_rate == buffers[0] || cache.getNumEntries() != 3) {
+        std::cout << "FAIL: Wrong entries for other representations, " << cache.getNumEntries() << " entries"
+                  << std::endl;
+        succeeded = false;
+    }
+
+    // Released entries are computed again
+    buffers.clear();
+    other_rate.reset();
+
+    if (cache.getNumEntries() != 1) {
+        std::cout << "FAIL: Released entries still cached" << std::endl;
+        succeeded = false;
+    }
+
+    cache.getOrCompute(key, Representation::Playback, 48000.0, compute);
+
+    if (num_computed != 4) {
+        std::cout << "FAIL: Released entry not computed again" << std::endl;
+        succeeded = false;
+    }
+
+    // A file changed on disk gets another key
+    std::ofstream(path, std::ios::binary) << "second, longer version";
+    const auto new_key = SourceAudioCache::FileKey::fromPath(path);
+    auto new_transcription = cache.getOrCompute(new_key, Representation::Transcription, 22050.0, compute);
+
+    if (new_key == key || num_computed != 5 || new_transcription == transcription) {
+        std::cout << "FAIL: Entry shared with a file changed on disk" << std::endl;
+        succeeded = false;
+    }
+
+    // Failed computations are not cached
+    std::function<Buffer()> compute_fail = []() { return nullptr; };
+
+    if (cache.getOrCompute(new_key, Representation::Whisper, 16000.0, compute_fail) != nullptr
+        || cache.getOrCompute(new_key, Representation::Whisper, 16000.0, compute) == nullptr) {
+        std::cout << "FAIL: Failed computation cached" << std::endl;
+        succeeded = false;
+    }
+
+    std::filesystem::remove(path);
+
+    return succeeded;
+}
+
+#endif // NN_SOURCE_AUDIO_CACHE_TEST_H
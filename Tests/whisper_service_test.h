@@ -0,0 +1,247 @@
+//
+// Load test and transport benchmark for the Whisper HTTP service and WhisperHTTPClient, and lazy initialization of
+// WhisperTranscriber.
+//
+
+#ifndef NN_WHISPER_SERVICE_TEST_H
+#define NN_WHISPER_SERVICE_TEST_H
+
+#include "WhisperHTTPClient.h"
+#include "WhisperTranscriber.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace whisper_service_test
+{
+inline juce::String getServiceUrl()
+{
+    const char* env_url = std::getenv("NEURALNOTE_WHISPER_SERVICE_URL");
+    return env_url != nullptr ? juce::String(env_url) : juce::String("http://127.0.0.1:8765");
+}
+
+inline juce::String getSocketUrl()
+{
+    const char* env_path = std::getenv("NEURALNOTE_WHISPER_SERVICE_SOCKET");
+    return juce::String("unix://")
+           + (env_path != nullptr ? juce::String(env_path) : WhisperHTTPClient::getDefaultSocketPath());
+}
+
+inline int getEnvInt(const char* inName, int inDefault)
+{
+    const char* value = std::getenv(inName);
+    return value != nullptr ? std::max(1, std::atoi(value)) : inDefault;
+}
+
+inline std::vector<float> makeTestAudio(double inDurationSeconds)
+{
+    const auto num_samples = static_cast<size_t>(inDurationSeconds * WhisperConstants::WHISPER_SAMPLE_RATE);
+    std::vector<float> audio(num_samples);
+
+    for (size_t i = 0; i < num_samples; i++) {
+        audio[i] = 0.1f * std::sin(2.0f * juce::MathConstants<float>::pi * 220.0f * static_cast<float>(i)
+                                    / static_cast<float>(WhisperConstants::WHISPER_SAMPLE_RATE));
+    }
+
+    return audio;
+}
+
+inline double percentile(std::vector<double> inValues, double inPercentile)
+{
+    if (inValues.empty())
+        return 0.0;
+
+    std::sort(inValues.begin(), inValues.end());
+    auto idx = static_cast<size_t>(std::round(inPercentile * static_cast<double>(inValues.size() - 1)));
+    return inValues[idx];
+}
+
+/**
+ * Mean latency in milliseconds of inNumIterations calls to inRequest, or a negative value if a request failed.
+ */
+template <typename Request>
+double measureLatencyMs(int inNumIterations, Request&& inRequest)
+{
+    double total = 0.0;
+
+    for (int i = 0; i < inNumIterations; i++) {
+        auto start = std::chrono::steady_clock::now();
+        if (!inRequest())
+            return -1.0;
+        total += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    return total / inNumIterations;
+}
+} // namespace whisper_service_test
+
+/**
+ * Sends concurrent transcription requests to a running Whisper service and reports latency and throughput.
+ * Skipped (and considered successful) if no service is reachable.
+ * Start a stand-in service without a model with: python3 Scripts/whisper_service.py --stub
+ * The number of concurrent clients and requests per client can be set with NEURALNOTE_LOAD_TEST_CLIENTS and
+ * NEURALNOTE_LOAD_TEST_REQUESTS.
+ * @return False if any request failed.
+ */
+bool whisper_service_load_test()
+{
+    using namespace whisper_service_test;
+
+    const auto service_url = getServiceUrl();
+
+    {
+        WhisperHTTPClient probe(service_url);
+        if (!probe.isServiceAvailable()) {
+            std::cout << "No Whisper service at " << service_url << ", skipping." << std::endl;
+            return true;
+        }
+    }
+
+    const int num_clients = getEnvInt("NEURALNOTE_LOAD_TEST_CLIENTS", 8);
+    const int num_requests_per_client = getEnvInt("NEURALNOTE_LOAD_TEST_REQUESTS", 4);
+    const auto audio = makeTestAudio(5.0);
+
+    std::vector<std::vector<double>> latencies(static_cast<size_t>(num_clients));
+    std::atomic<int> num_failed {0};
+
+    auto start_time = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> clients;
+    for (int c = 0; c < num_clients; c++) {
+        clients.emplace_back([&, c]() {
+            WhisperHTTPClient client(service_url);
+            std::vector<TimedWord> words;
+
+            for (int r = 0; r < num_requests_per_client; r++) {
+                auto request_start = std::chrono::steady_clock::now();
+                bool success = client.transcribe(audio.data(), static_cast<int>(audio.size()), "en", words);
+                std::chrono::duration<double> latency = std::chrono::steady_clock::now() - request_start;
+
+                if (success) {
+                    latencies[static_cast<size_t>(c)].push_back(latency.count());
+                } else {
+                    num_failed++;
+                    std::cout << "Request failed: " << client.getLastError() << std::endl;
+                }
+            }
+        });
+    }
+
+    for (auto& client: clients)
+        client.join();
+
+    std::chrono::duration<double> total_duration = std::chrono::steady_clock::now() - start_time;
+
+    std::vector<double> all_latencies;
+    for (const auto& client_latencies: latencies)
+        all_latencies.insert(all_latencies.end(), client_latencies.begin(), client_latencies.end());
+
+    std::cout << num_clients << " clients x " << num_requests_per_client << " requests against " << service_url
+              << std::endl;
+    std::cout << "Total time: " << total_duration.count() << " seconds ("
+              << static_cast<double>(all_latencies.size()) / total_duration.count() << " requests/s)" << std::endl;
+    std::cout << "Latency p50: " << percentile(all_latencies, 0.5) << " s, p95: " << percentile(all_latencies, 0.95)
+              << " s, max: " << percentile(all_latencies, 1.0) << " s" << std::endl;
+
+    if (num_failed > 0) {
+        std::cout << num_failed << " requests failed" << std::endl;
+        return false;
+    }
+
+    std::cout << "Success" << std::endl;
+    return true;
+}
+
+/**
+ * Compares the request latency over TCP and over the Unix domain socket of a running Whisper service, for a small
+ * request (health check, short audio) and a large one (30 s of audio). Start the service with --unix-socket (and --stub
+ * to measure the transport rather than the model). Skipped if the service is not reachable over both transports.
+ * @return False if a request failed.
+ */
+bool whisper_transport_benchmark()
+{
+    using namespace whisper_service_test;
+
+    auto tcp_url = getServiceUrl();
+    if (tcp_url.startsWith("unix://"))
+        tcp_url = "http://127.0.0.1:8765";
+
+    WhisperHTTPClient tcp_client(tcp_url);
+    WhisperHTTPClient socket_client(getSocketUrl());
+
+    if (!tcp_client.isServiceAvailable() || !socket_client.isServiceAvailable()) {
+        std::cout << "Whisper service not reachable over both TCP and Unix socket, skipping." << std::endl;
+        return true;
+    }
+
+    const auto small_audio = makeTestAudio(0.5);
+    const auto large_audio = makeTestAudio(30.0);
+
+    bool success = true;
+
+    for (auto* client: {&tcp_client, &socket_client}) {
+        std::vector<TimedWord> words;
+
+        auto health_ms = measureLatencyMs(50, [&]() { return client->isServiceAvailable(); });
+        auto small_ms = measureLatencyMs(10, [&]() {
+            return client->transcribe(small_audio.data(), static_cast<int>(small_audio.size()), "en", words);
+        });
+        auto large_ms = measureLatencyMs(5, [&]() {
+            return client->transcribe(large_audio.data(), static_cast<int>(large_audio.size()), "en", words);
+        });
+
+        std::cout << (client->usesUnixSocket() ? "Unix socket" : "TCP") << ": health " << health_ms
+                  << " ms, 0.5 s audio " << small_ms << " ms, 30 s audio " << large_ms << " ms" << std::endl;
+
+        if (health_ms < 0.0 || small_ms < 0.0 || large_ms < 0.0) {
+            std::cout << "Request failed: " << client->getLastError() << std::endl;
+            success = false;
+        }
+    }
+
+    if (success)
+        std::cout << "Success" << std::endl;
+
+    return success;
+}
+
+/**
+ * WhisperTranscriber must not load or probe anything until initialize is called, as it is constructed with the plugin.
+ */
+bool whisper_lazy_init_test()
+{
+    // Nothing listens on port 1: the health check done by initialize fails right away
+    WhisperTranscriber transcriber(WhisperTranscriber::Backend::HTTPService, "http://127.0.0.1:1");
+
+    if (transcriber.isInitialized() || !transcriber.getBackendDescription().empty()
+        || transcriber.getErrorMessage().empty()) {
+        std::cout << "FAIL: backend available before initialize" << std::endl;
+        return false;
+    }
+
+    std::vector<float> audio(static_cast<size_t>(WhisperConstants::WHISPER_SAMPLE_RATE), 0.0f);
+
+    if (!transcriber.transcribeToText(audio.data(), static_cast<int>(audio.size())).empty()) {
+        std::cout << "FAIL: transcription before initialize returned words" << std::endl;
+        return false;
+    }
+
+    transcriber.initialize();
+
+    if (transcriber.isInitialized() || transcriber.getActiveBackend() != WhisperTranscriber::Backend::HTTPService
+        || transcriber.getBackendDescription() != "Whisper service") {
+        std::cout << "FAIL: unexpected backend state after initialize" << std::endl;
+        return false;
+    }
+
+    std::cout << "SUCCESS" << std::endl;
+    return true;
+}
+
+#endif //NN_WHISPER_SERVICE_TEST_H
@@ -0,0 +1,96 @@
+#ifndef NN_WORKER_POOL_TEST_H
+#define NN_WORKER_POOL_TEST_H
+
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "WorkerPool.h"
+
+/**
+ * Check that every task runs exactly once, with calls from several threads at the same time and with more threads
+ * requested than workers, that a single thread runs everything on the calling thread, and that the pool is destroyed
+ * with its last holder.
+ */
+bool worker_pool_test()
+{
+    bool succeeded = true;
+    auto pool = WorkerPool::getInstance();
+
+    constexpr size_t num_tasks = 100;
+
+    auto run = [&](size_t inMaxNumThreads) {
+        std::vector<std::atomic<int>> num_runs(num_tasks);
+        pool->runInParallel(num_tasks, inMaxNumThreads, [&](size_t inTask) { num_runs[inTask]++; });
+
+        for (const auto& num_run: num_runs) {
+            if (num_run != 1) {
+                return false;
+            }
+        }
+
+        return true;
+    };
+
+    if (!run(4) || !run(pool->getNumWorkers() + 10)) {
+        std::cout << "FAIL: Tasks not run exactly once" << std::endl;
+        succeeded = false;
+    }
+
+    // Concurrent callers, e.g. several instances converting notes at the same time
+    std::atomic<int> num_failed_callers = 0;
+    std::vector<std::thread> callers;
+
+    for (int i = 0; i < 8; i++) {
+        callers.emplace_back([&]() {
+            for (int j = 0; j < 20; j++) {
+                if (!run(4)) {
+                    num_failed_callers++;
+                }
+            }
+        });
+    }
+
+    for (auto& caller: callers) {
+        caller.join();
+    }
+
+    if (num_failed_callers != 0) {
+        std::cout << "FAIL: Tasks not run exactly once with concurrent callers" << std::endl;
+        succeeded = false;
+    }
+
+    const auto calling_thread = std::this_thread::get_id();
+    std::atomic<bool> ran_elsewhere = false;
+
+    pool->runInParallel(num_tasks, 1, [&](size_t) {
+        if (std::this_thread::get_id() != calling_thread) {
+            ran_elsewhere = true;
+        }
+    });
+
+    if (ran_elsewhere) {
+        std::cout << "FAIL: Task run on a worker with a single thread" << std::endl;
+        succeeded = false;
+    }
+
+    // Shared while held, stopped with the last holder
+    if (WorkerPool::getInstance() != pool) {
+        std::cout << "FAIL: Pool not shared between holders" << std::endl;
+        succeeded = false;
+    }
+
+    std::weak_ptr<WorkerPool> released_pool = pool;
+    pool.reset();
+
+    if (!released_pool.expired()) {
+        std::cout << "FAIL: Pool not destroyed with the last holder" << std::endl;
+        succeeded = false;
+    }
+
+    return succeeded;
+}
+
+#endif // NN_WORKER_POOL_TEST_H